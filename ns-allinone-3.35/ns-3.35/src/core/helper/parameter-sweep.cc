@@ -0,0 +1,496 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "parameter-sweep.h"
+#include "csv-reader.h"
+
+#include "ns3/checkpoint.h"
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+#include "ns3/system-path.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParameterSweep implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ParameterSweep");
+
+namespace {
+
+/**
+ * Split a string.
+ * \param [in] s The string.
+ * \param [in] separator The separator.
+ * \returns The fields, without the empty ones.
+ */
+std::vector<std::string>
+SplitString (const std::string &s, char separator)
+{
+  std::vector<std::string> fields;
+  std::istringstream iss (s);
+  std::string field;
+  while (std::getline (iss, field, separator))
+    {
+      if (!field.empty ())
+        {
+          fields.push_back (field);
+        }
+    }
+  return fields;
+}
+
+/**
+ * Parse a list of values, or an inclusive range with a step.
+ * \param [in] s The values, e.g. \c "5,10,20", \c "10:100:10" or \c "1:10".
+ * \param [out] values The values.
+ * \returns \c true if the values are valid.
+ */
+bool
+ParseValues (const std::string &s, std::vector<std::string> &values)
+{
+  values.clear ();
+  if (s.find (':') == std::string::npos)
+    {
+      values = SplitString (s, ',');
+      return !values.empty ();
+    }
+
+  std::vector<std::string> bounds = SplitString (s, ':');
+  if (bounds.size () != 2 && bounds.size () != 3)
+    {
+      return false;
+    }
+  double first, last, step = 1;
+  std::istringstream (bounds[0]) >> first;
+  std::istringstream (bounds[1]) >> last;
+  if (bounds.size () == 3)
+    {
+      std::istringstream (bounds[2]) >> step;
+    }
+  if (!std::isfinite (first) || !std::isfinite (last) || !(step > 0) || last < first)
+    {
+      return false;
+    }
+  // Computed from the first value, rather than accumulated, so that
+  // 0.1 steps do not drift.
+  uint64_t count = static_cast<uint64_t> (std::floor ((last - first) / step + 1e-9)) + 1;
+  for (uint64_t i = 0; i < count; ++i)
+    {
+      std::ostringstream oss;
+      oss << std::setprecision (std::numeric_limits<double>::digits10)
+          << first + i * step;
+      values.push_back (oss.str ());
+    }
+  return true;
+}
+
+} // unnamed namespace
+
+ParameterSweep::ParameterSweep ()
+  : m_output ("sweep.csv"),
+    m_jobs (0),
+    m_failures (0),
+    m_inConfiguration (false),
+    m_index (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ParameterSweep::~ParameterSweep ()
+{
+  NS_LOG_FUNCTION (this);
+  Finish ();
+}
+
+void
+ParameterSweep::AddCommandLineOptions (CommandLine &cmd)
+{
+  NS_LOG_FUNCTION (this);
+  cmd.AddValue ("sweep",
+                "Parameters to sweep, e.g. nNodes=5,10,20;distance=10:100:10",
+                MakeCallback (&ParameterSweep::ParseParameters, this));
+  cmd.AddValue ("sweepRuns", "Range of RngRun values to sweep, e.g. 1:10",
+                MakeCallback (&ParameterSweep::ParseRuns, this));
+  cmd.AddValue ("sweepOutput", "File of the results of the sweep", m_output);
+  cmd.AddValue ("sweepJobs",
+                "Maximum number of configurations run at the same time (0 for the number of cores)",
+                m_jobs);
+}
+
+bool
+ParameterSweep::AddParameter (const std::string &name, const std::string &values)
+{
+  NS_LOG_FUNCTION (this << name << values);
+  std::vector<std::string> parsed;
+  if (name.empty () || !ParseValues (values, parsed))
+    {
+      return false;
+    }
+  m_parameters.push_back (std::make_pair (name, parsed));
+  return true;
+}
+
+bool
+ParameterSweep::AddParameters (const std::string &parameters)
+{
+  NS_LOG_FUNCTION (this << parameters);
+  std::vector<std::string> fields = SplitString (parameters, ';');
+  for (std::vector<std::string>::const_iterator i = fields.begin (); i != fields.end (); ++i)
+    {
+      std::string::size_type equal = i->find ('=');
+      if (equal == std::string::npos
+          || !AddParameter (i->substr (0, equal), i->substr (equal + 1)))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+ParameterSweep::SetRuns (const std::string &runs)
+{
+  NS_LOG_FUNCTION (this << runs);
+  return ParseValues (runs, m_runs);
+}
+
+void
+ParameterSweep::SetOutput (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_output = filename;
+}
+
+void
+ParameterSweep::SetMaxConcurrent (uint32_t jobs)
+{
+  NS_LOG_FUNCTION (this << jobs);
+  m_jobs = jobs;
+}
+
+bool
+ParameterSweep::ParseParameters (const std::string parameters)
+{
+  return AddParameters (parameters);
+}
+
+bool
+ParameterSweep::ParseRuns (const std::string runs)
+{
+  return SetRuns (runs);
+}
+
+std::vector<ParameterSweep::Configuration>
+ParameterSweep::GetConfigurations (void) const
+{
+  std::vector<std::pair<std::string, std::vector<std::string> > > parameters = m_parameters;
+  if (!m_runs.empty ())
+    {
+      parameters.push_back (std::make_pair (std::string ("RngRun"), m_runs));
+    }
+
+  // The cartesian product, the last parameter varying fastest.
+  std::vector<Configuration> configurations (1);
+  for (uint32_t p = 0; p < parameters.size (); ++p)
+    {
+      std::vector<Configuration> product;
+      for (uint32_t c = 0; c < configurations.size (); ++c)
+        {
+          for (uint32_t v = 0; v < parameters[p].second.size (); ++v)
+            {
+              Configuration configuration = configurations[c];
+              configuration.push_back (std::make_pair (parameters[p].first,
+                                                       parameters[p].second[v]));
+              product.push_back (configuration);
+            }
+        }
+      configurations.swap (product);
+    }
+  return configurations;
+}
+
+uint32_t
+ParameterSweep::GetConfigurationCount (void) const
+{
+  if (m_parameters.empty () && m_runs.empty ())
+    {
+      return 0;
+    }
+  uint32_t count = m_runs.empty () ? 1 : m_runs.size ();
+  for (uint32_t p = 0; p < m_parameters.size (); ++p)
+    {
+      count *= m_parameters[p].second.size ();
+    }
+  return count;
+}
+
+uint32_t
+ParameterSweep::GetFailureCount (void) const
+{
+  return m_failures;
+}
+
+std::string
+ParameterSweep::GetPartFilename (uint32_t index) const
+{
+  std::ostringstream oss;
+  oss << index << ".csv";
+  return SystemPath::Append (m_output + ".parts", oss.str ());
+}
+
+bool
+ParameterSweep::ReadPart (uint32_t index, const Configuration &configuration,
+                          std::vector<std::pair<std::string, std::string> > &results) const
+{
+  results.clear ();
+  std::string filename = GetPartFilename (index);
+  if (!SystemPath::Exists (filename))
+    {
+      return false;
+    }
+  // The parameters first, then the results, one "name,value" row each.
+  CsvReader csv (filename);
+  uint32_t row = 0;
+  while (csv.FetchNextRow ())
+    {
+      std::string name, value;
+      if (csv.IsBlankRow ())
+        {
+          continue;
+        }
+      if (csv.ColumnCount () != 2 || !csv.GetValue (0, name) || !csv.GetValue (1, value))
+        {
+          return false;
+        }
+      if (row < configuration.size ())
+        {
+          if (configuration[row].first != name || configuration[row].second != value)
+            {
+              // Left by a sweep of other parameters.
+              NS_LOG_WARN ("ignoring results of another sweep in " << filename);
+              return false;
+            }
+        }
+      else
+        {
+          results.push_back (std::make_pair (name, value));
+        }
+      ++row;
+    }
+  return row >= configuration.size ();
+}
+
+bool
+ParameterSweep::Run (CommandLine &cmd)
+{
+  NS_LOG_FUNCTION (this);
+  m_failures = 0;
+  if (m_parameters.empty () && m_runs.empty ())
+    {
+      return true;
+    }
+
+  std::vector<Configuration> configurations = GetConfigurations ();
+  SystemPath::MakeDirectories (m_output + ".parts");
+  std::vector<uint32_t> pending;
+  for (uint32_t i = 0; i < configurations.size (); ++i)
+    {
+      std::vector<std::pair<std::string, std::string> > results;
+      if (!ReadPart (i, configurations[i], results))
+        {
+          pending.push_back (i);
+        }
+    }
+  NS_LOG_INFO ("running " << pending.size () << " of "
+                          << configurations.size () << " configurations");
+
+  uint32_t branch;
+  if (!pending.empty ()
+      && Checkpoint::Fork (pending.size (), branch, m_jobs, false))
+    {
+      m_inConfiguration = true;
+      m_index = pending[branch];
+      m_configuration = configurations[m_index];
+      std::vector<std::string> args;
+      args.push_back (cmd.GetName ());
+      for (Configuration::const_iterator i = m_configuration.begin ();
+           i != m_configuration.end (); ++i)
+        {
+          args.push_back ("--" + i->first + "=" + i->second);
+        }
+      cmd.Parse (args);
+      return true;
+    }
+
+  const std::vector<int> &status = Checkpoint::GetExitStatus ();
+  for (uint32_t i = 0; i < pending.size (); ++i)
+    {
+      if (pending.size () == status.size () && status[i] != 0)
+        {
+          std::cerr << "ParameterSweep: configuration " << pending[i]
+                    << " exited with status " << status[i] << std::endl;
+        }
+    }
+  WriteTable (configurations);
+  return false;
+}
+
+void
+ParameterSweep::WriteTable (const std::vector<Configuration> &configurations)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<std::vector<std::pair<std::string, std::string> > > results (configurations.size ());
+  std::vector<bool> finished (configurations.size ());
+  std::vector<std::string> columns;
+  std::map<std::string, uint32_t> columnIndex;
+  for (uint32_t i = 0; i < configurations.size (); ++i)
+    {
+      finished[i] = ReadPart (i, configurations[i], results[i]);
+      if (!finished[i])
+        {
+          ++m_failures;
+          continue;
+        }
+      for (uint32_t r = 0; r < results[i].size (); ++r)
+        {
+          if (columnIndex.insert (std::make_pair (results[i][r].first, columns.size ())).second)
+            {
+              columns.push_back (results[i][r].first);
+            }
+        }
+    }
+
+  std::ofstream os (m_output.c_str ());
+  if (!os.is_open ())
+    {
+      NS_FATAL_ERROR ("ParameterSweep: cannot open " << m_output);
+    }
+  const Configuration &names = configurations.front ();
+  for (uint32_t p = 0; p < names.size (); ++p)
+    {
+      os << (p > 0 ? "," : "") << names[p].first;
+    }
+  for (uint32_t c = 0; c < columns.size (); ++c)
+    {
+      os << "," << columns[c];
+    }
+  os << std::endl;
+  for (uint32_t i = 0; i < configurations.size (); ++i)
+    {
+      if (!finished[i])
+        {
+          continue;
+        }
+      for (uint32_t p = 0; p < configurations[i].size (); ++p)
+        {
+          os << (p > 0 ? "," : "") << configurations[i][p].second;
+        }
+      std::vector<std::string> row (columns.size ());
+      for (uint32_t r = 0; r < results[i].size (); ++r)
+        {
+          row[columnIndex[results[i][r].first]] = results[i][r].second;
+        }
+      for (uint32_t c = 0; c < row.size (); ++c)
+        {
+          os << "," << row[c];
+        }
+      os << std::endl;
+    }
+  if (m_failures > 0)
+    {
+      std::cerr << "ParameterSweep: " << m_failures << " of " << configurations.size ()
+                << " configurations did not finish; run the sweep again to retry them"
+                << std::endl;
+    }
+}
+
+void
+ParameterSweep::Record (const std::string &name, double value)
+{
+  NS_LOG_FUNCTION (this << name << value);
+  for (std::vector<std::pair<std::string, double> >::iterator i = m_results.begin ();
+       i != m_results.end (); ++i)
+    {
+      if (i->first == name)
+        {
+          i->second = value;
+          return;
+        }
+    }
+  m_results.push_back (std::make_pair (name, value));
+}
+
+void
+ParameterSweep::Record (const std::map<std::string, double> &results)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<std::string, double>::const_iterator i = results.begin (); i != results.end (); ++i)
+    {
+      Record (i->first, i->second);
+    }
+}
+
+void
+ParameterSweep::Finish (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_inConfiguration)
+    {
+      return;
+    }
+  m_inConfiguration = false;
+
+  // Written aside and renamed, so that an interrupted configuration
+  // leaves no results, and is run again by the next sweep.
+  std::string filename = GetPartFilename (m_index);
+  std::string temporary = filename + ".tmp";
+  {
+    std::ofstream os (temporary.c_str ());
+    os << std::setprecision (std::numeric_limits<double>::digits10);
+    for (Configuration::const_iterator i = m_configuration.begin ();
+         i != m_configuration.end (); ++i)
+      {
+        os << i->first << "," << i->second << std::endl;
+      }
+    for (std::vector<std::pair<std::string, double> >::const_iterator i = m_results.begin ();
+         i != m_results.end (); ++i)
+      {
+        os << i->first << "," << i->second << std::endl;
+      }
+    if (!os)
+      {
+        NS_FATAL_ERROR ("ParameterSweep: cannot write " << temporary);
+      }
+  }
+  if (std::rename (temporary.c_str (), filename.c_str ()) != 0)
+    {
+      NS_FATAL_ERROR ("ParameterSweep: cannot rename " << temporary);
+    }
+}
+
+} // namespace ns3
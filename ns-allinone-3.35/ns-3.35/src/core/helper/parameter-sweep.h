@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParameterSweep declaration.
+ */
+
+namespace ns3 {
+
+class CommandLine;
+
+/**
+ * \ingroup core
+ * \brief Run a program for every combination of a set of parameter
+ * values, in parallel, and collect the results in one table.
+ *
+ * The parameters are the command line arguments of the program: its
+ * own CommandLine values, global values and attribute defaults.  Each
+ * configuration is run in a child process, forked after the static
+ * initialization and the parsing of the command line, with at most
+ * one configuration per core at a time.  Each configuration records
+ * its results with Record(), and the table of the results, one row
+ * per configuration and one column per parameter and result, is
+ * written as CSV when all the configurations are finished.
+ *
+ * \code
+ *   int main (int argc, char *argv[])
+ *   {
+ *     uint32_t nNodes = 10;
+ *     double distance = 50;
+ *     CommandLine cmd;
+ *     cmd.AddValue ("nNodes", "Number of nodes", nNodes);
+ *     cmd.AddValue ("distance", "Distance between the nodes", distance);
+ *     ParameterSweep sweep;
+ *     sweep.AddCommandLineOptions (cmd);
+ *     cmd.Parse (argc, argv);
+ *     if (!sweep.Run (cmd))
+ *       {
+ *         return sweep.GetFailureCount () > 0;
+ *       }
+ *
+ *     // Simulate the configuration of nNodes and distance.
+ *
+ *     sweep.Record ("throughput", throughput);
+ *     return 0;
+ *   }
+ * \endcode
+ * \verbatim
+   $ ./waf --run "program --sweep=nNodes=5,10,20;distance=10:100:10 --sweepRuns=1:5" \endverbatim
+ *
+ * The results of each configuration are kept in the directory
+ * <em>output</em>\c .parts when it is finished: if the sweep is
+ * interrupted, running it again only runs the configurations which
+ * were not finished.  The results are written when the ParameterSweep
+ * is destroyed, so the program must return from \c main rather than
+ * call \c exit.
+ *
+ * The configurations are forked with Checkpoint::Fork(), so the sweep
+ * is only available on POSIX systems.
+ */
+class ParameterSweep
+{
+public:
+  ParameterSweep ();
+  /** Write the results, in the process of a configuration. */
+  ~ParameterSweep ();
+
+  /**
+   * Add the options of the sweep to a command line:
+   * \c \--sweep, \c \--sweepRuns, \c \--sweepOutput and \c \--sweepJobs.
+   *
+   * \param [in,out] cmd The command line.
+   */
+  void AddCommandLineOptions (CommandLine &cmd);
+  /**
+   * Add a parameter to sweep.
+   *
+   * \param [in] name The name of a command line argument.
+   * \param [in] values The values, as a list (\c "5,10,20") or as an
+   *             inclusive range with a step (\c "10:100:10").
+   * \returns \c true if the values are valid.
+   */
+  bool AddParameter (const std::string &name, const std::string &values);
+  /**
+   * Add parameters to sweep.
+   *
+   * \param [in] parameters The parameters, separated by semicolons,
+   *             e.g. \c "nNodes=5,10,20;distance=10:100:10".
+   * \returns \c true if the parameters are valid.
+   */
+  bool AddParameters (const std::string &parameters);
+  /**
+   * Run each configuration for a range of RngRun values.
+   *
+   * \param [in] runs The range, e.g. \c "1:10".
+   * \returns \c true if the range is valid.
+   */
+  bool SetRuns (const std::string &runs);
+  /**
+   * Set the file of the results, \c sweep.csv by default.
+   *
+   * \param [in] filename The file name.
+   */
+  void SetOutput (const std::string &filename);
+  /**
+   * Set the maximum number of configurations run at the same time.
+   *
+   * \param [in] jobs The number of configurations, or 0 (the default)
+   *             for the number of cores.
+   */
+  void SetMaxConcurrent (uint32_t jobs);
+
+  /**
+   * Run the configurations which are not finished yet.
+   *
+   * Without parameters nor runs to sweep, this does nothing and
+   * returns \c true.  Otherwise, in the process of each configuration,
+   * this applies its parameters to \p cmd and returns \c true.  In the
+   * calling process, this returns \c false when all the configurations
+   * are finished, after writing the table of the results.
+   *
+   * \param [in,out] cmd The command line parsing the parameters.
+   * \returns \c true in the process of a configuration.
+   */
+  bool Run (CommandLine &cmd);
+  /**
+   * Record a result of the current configuration.
+   *
+   * \param [in] name The name of the result.
+   * \param [in] value The value.
+   */
+  void Record (const std::string &name, double value);
+  /**
+   * Record results of the current configuration.
+   *
+   * \param [in] results The results, by name.
+   */
+  void Record (const std::map<std::string, double> &results);
+  /**
+   * Write the results of the current configuration.  Called by the
+   * destructor.
+   */
+  void Finish (void);
+
+  /**
+   * Get the number of configurations of the sweep.
+   *
+   * \returns The number of configurations.
+   */
+  uint32_t GetConfigurationCount (void) const;
+  /**
+   * Get the number of configurations which failed in the last Run().
+   *
+   * \returns The number of failed configurations.
+   */
+  uint32_t GetFailureCount (void) const;
+
+private:
+  /** A configuration: the value of each parameter. */
+  typedef std::vector<std::pair<std::string, std::string> > Configuration;
+
+  /**
+   * Callback for \c \--sweep.
+   * \param [in] parameters The parameters.
+   * \returns \c true if the parameters are valid.
+   */
+  bool ParseParameters (const std::string parameters);
+  /**
+   * Callback for \c \--sweepRuns.
+   * \param [in] runs The range of runs.
+   * \returns \c true if the range is valid.
+   */
+  bool ParseRuns (const std::string runs);
+  /**
+   * Build the list of the configurations.
+   * \returns The configurations.
+   */
+  std::vector<Configuration> GetConfigurations (void) const;
+  /**
+   * Get the file of the results of a configuration.
+   * \param [in] index The configuration index.
+   * \returns The file name.
+   */
+  std::string GetPartFilename (uint32_t index) const;
+  /**
+   * Read the results of a configuration, if it is finished.
+   * \param [in] index The configuration index.
+   * \param [in] configuration The configuration.
+   * \param [out] results The results.
+   * \returns \c true if the configuration is finished.
+   */
+  bool ReadPart (uint32_t index, const Configuration &configuration,
+                 std::vector<std::pair<std::string, std::string> > &results) const;
+  /**
+   * Write the table of the results.
+   * \param [in] configurations The configurations.
+   */
+  void WriteTable (const std::vector<Configuration> &configurations);
+
+  /** The parameters to sweep, and their values. */
+  std::vector<std::pair<std::string, std::vector<std::string> > > m_parameters;
+  /** The runs to sweep, if any. */
+  std::vector<std::string> m_runs;
+  /** The file of the results. */
+  std::string m_output;
+  /** The maximum number of configurations run at the same time. */
+  uint32_t m_jobs;
+  /** The number of configurations which failed. */
+  uint32_t m_failures;
+  /** Whether this is the process of a configuration. */
+  bool m_inConfiguration;
+  /** The index of the configuration of this process. */
+  uint32_t m_index;
+  /** The configuration of this process. */
+  Configuration m_configuration;
+  /** The results of the configuration of this process. */
+  std::vector<std::pair<std::string, double> > m_results;
+};
+
+} // namespace ns3
+
+#endif /* PARAMETER_SWEEP_H */
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "adaptive-scheduler.h"
+#include "object-factory.h"
+#include "type-id.h"
+#include "boolean.h"
+#include "string.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::AdaptiveScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AdaptiveScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (AdaptiveScheduler);
+
+TypeId
+AdaptiveScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AdaptiveScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<AdaptiveScheduler> ()
+    .AddAttribute ("InitialScheduler",
+                   "The Scheduler holding the events until the selection",
+                   TypeId::ATTR_CONSTRUCT,
+                   StringValue ("ns3::MapScheduler"),
+                   MakeStringAccessor (&AdaptiveScheduler::SetInitialScheduler),
+                   MakeStringChecker ())
+    .AddAttribute ("Candidates",
+                   "The Schedulers to select from, separated by commas",
+                   StringValue ("ns3::MapScheduler,ns3::HeapScheduler,"
+                                "ns3::CalendarScheduler,ns3::LadderScheduler,"
+                                "ns3::PriorityQueueScheduler,ns3::ListScheduler"),
+                   MakeStringAccessor (&AdaptiveScheduler::m_candidates),
+                   MakeStringChecker ())
+    .AddAttribute ("SampleSize",
+                   "Number of events run before the selection",
+                   UintegerValue (10000),
+                   MakeUintegerAccessor (&AdaptiveScheduler::m_sampleSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TrialSize",
+                   "Number of operations timed for each candidate",
+                   UintegerValue (20000),
+                   MakeUintegerAccessor (&AdaptiveScheduler::m_trialSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Report",
+                   "Write the selected Scheduler, and the cost per event "
+                   "of each candidate, to std::clog",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&AdaptiveScheduler::m_report),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+AdaptiveScheduler::AdaptiveScheduler ()
+  : m_sampleSize (10000),
+    m_trialSize (20000),
+    m_report (false),
+    m_selected (false),
+    m_removed (0),
+    m_now (0),
+    m_size (0),
+    m_sizeSum (0)
+{
+  NS_LOG_FUNCTION (this);
+  SetInitialScheduler ("ns3::MapScheduler");
+}
+AdaptiveScheduler::~AdaptiveScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AdaptiveScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_scheduler = 0;
+  Scheduler::DoDispose ();
+}
+
+void
+AdaptiveScheduler::SetInitialScheduler (std::string type)
+{
+  NS_LOG_FUNCTION (this << type);
+  NS_ASSERT_MSG (m_size == 0 && !m_selected,
+                 "InitialScheduler can only be set at construction");
+  ObjectFactory factory (type);
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+void
+AdaptiveScheduler::Insert (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (!m_selected && m_delays.size () < m_sampleSize)
+    {
+      m_delays.push_back (ev.key.m_ts - m_now);
+    }
+  ++m_size;
+  m_scheduler->Insert (ev);
+}
+
+bool
+AdaptiveScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+AdaptiveScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+AdaptiveScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  Scheduler::Event ev = m_scheduler->RemoveNext ();
+  --m_size;
+  m_now = ev.key.m_ts;
+  if (!m_selected)
+    {
+      m_sizeSum += m_size;
+      if (++m_removed >= m_sampleSize)
+        {
+          Select ();
+        }
+    }
+  return ev;
+}
+
+void
+AdaptiveScheduler::Remove (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  --m_size;
+  m_scheduler->Remove (ev);
+}
+
+TypeId
+AdaptiveScheduler::GetSelectedType (void) const
+{
+  return m_scheduler->GetInstanceTypeId ();
+}
+
+bool
+AdaptiveScheduler::IsSelected (void) const
+{
+  return m_selected;
+}
+
+std::map<std::string, double>
+AdaptiveScheduler::GetCosts (void) const
+{
+  return m_costs;
+}
+
+double
+AdaptiveScheduler::Trial (const std::string &type, const std::vector<Scheduler::Event> &events,
+                          double budget, double &elapsed) const
+{
+  NS_LOG_FUNCTION (this << type << events.size () << budget);
+  typedef std::chrono::steady_clock Clock;
+  ObjectFactory factory (type);
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+
+  Clock::time_point start = Clock::now ();
+  for (uint32_t i = 0; i < events.size (); ++i)
+    {
+      scheduler->Insert (events[i]);
+      // Some candidates are very slow with some workloads,
+      // e.g. the ListScheduler with many pending events.
+      if (budget > 0 && i % 256 == 255
+          && std::chrono::duration<double, std::nano> (Clock::now () - start).count () > budget)
+        {
+          elapsed = budget;
+          return std::numeric_limits<double>::infinity ();
+        }
+    }
+
+  // The events are never run: their time stamps can be changed.
+  Clock::time_point holdStart = Clock::now ();
+  uint64_t now = m_now;
+  for (uint32_t i = 0; i < m_trialSize; ++i)
+    {
+      Scheduler::Event ev;
+      if (scheduler->IsEmpty ())
+        {
+          ev.impl = 0;
+          ev.key.m_uid = i;
+          ev.key.m_context = 0;
+        }
+      else
+        {
+          ev = scheduler->RemoveNext ();
+          now = ev.key.m_ts;
+        }
+      ev.key.m_ts = now + m_delays[i % m_delays.size ()];
+      scheduler->Insert (ev);
+      if (budget > 0 && i % 256 == 255
+          && std::chrono::duration<double, std::nano> (Clock::now () - start).count () > budget)
+        {
+          elapsed = budget;
+          return std::numeric_limits<double>::infinity ();
+        }
+    }
+  Clock::time_point end = Clock::now ();
+
+  elapsed = std::chrono::duration<double, std::nano> (end - start).count ();
+  return std::chrono::duration<double, std::nano> (end - holdStart).count () / m_trialSize;
+}
+
+void
+AdaptiveScheduler::Select (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_selected = true;
+  if (m_delays.empty ())
+    {
+      return;
+    }
+
+  std::vector<Scheduler::Event> events;
+  events.reserve (m_size);
+  while (!m_scheduler->IsEmpty ())
+    {
+      events.push_back (m_scheduler->RemoveNext ());
+    }
+
+  // The InitialScheduler first, as the reference for the others.
+  std::string initial = m_scheduler->GetInstanceTypeId ().GetName ();
+  std::vector<std::string> types (1, initial);
+  std::istringstream candidates (m_candidates);
+  std::string type;
+  while (std::getline (candidates, type, ','))
+    {
+      if (!type.empty () && type != initial)
+        {
+          types.push_back (type);
+        }
+    }
+
+  std::string best = initial;
+  double bestCost = std::numeric_limits<double>::infinity ();
+  double budget = 0;
+  for (std::vector<std::string>::const_iterator i = types.begin (); i != types.end (); ++i)
+    {
+      double elapsed;
+      double cost = Trial (*i, events, budget, elapsed);
+      m_costs[*i] = cost;
+      NS_LOG_INFO (*i << ": " << cost << " ns per event");
+      if (cost < bestCost)
+        {
+          best = *i;
+          bestCost = cost;
+          budget = 10 * elapsed;
+        }
+    }
+
+  if (best != initial)
+    {
+      ObjectFactory factory (best);
+      m_scheduler = factory.Create<Scheduler> ();
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      m_scheduler->Insert (*i);
+    }
+
+  NS_LOG_INFO ("selected " << best << " after " << m_removed << " events, with "
+                           << double (m_sizeSum) / m_removed << " pending events on average");
+  if (m_report)
+    {
+      std::clog << "AdaptiveScheduler: selected " << best << " after " << m_removed
+                << " events, with " << double (m_sizeSum) / m_removed
+                << " pending events on average" << std::endl;
+      for (std::vector<std::string>::const_iterator i = types.begin (); i != types.end (); ++i)
+        {
+          std::clog << "  " << *i << ": " << m_costs[*i] << " ns per event" << std::endl;
+        }
+    }
+
+  std::vector<uint64_t> ().swap (m_delays);
+}
+
+} // namespace ns3
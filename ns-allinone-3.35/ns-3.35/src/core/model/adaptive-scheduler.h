@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADAPTIVE_SCHEDULER_H
+#define ADAPTIVE_SCHEDULER_H
+
+#include "scheduler.h"
+#include "ptr.h"
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::AdaptiveScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief an event scheduler choosing the best of the other schedulers
+ * for the event distribution of the simulation
+ *
+ * Which Scheduler is the fastest depends on the number of pending
+ * events and on how far in the future the events are scheduled.
+ * This scheduler selects it automatically, early in the run:
+ *
+ * - While the first \c SampleSize events are run, the events are
+ *   kept in an \c InitialScheduler, and the delay of each inserted
+ *   event, from the time of the last removed event, is recorded.
+ * - The pending events are then replayed into each of the
+ *   \c Candidates in turn, the \c InitialScheduler first, and
+ *   \c TrialSize "hold" operations (remove the next event, insert it
+ *   again one recorded delay later) are timed on the wall clock.  The same delays are replayed for
+ *   every candidate, so they all see the same workload.  A candidate
+ *   taking more than ten times as long as the best one so far is
+ *   abandoned.
+ * - The pending events are moved to the fastest candidate, which
+ *   holds them for the rest of the run.
+ *
+ * The choice and the cost per event of each candidate are logged with
+ * NS_LOG_INFO, and written to \c std::clog if the \c Report attribute
+ * is set:
+ * \verbatim
+   $ ./waf --run "my-program --SchedulerType=ns3::AdaptiveScheduler \
+       --ns3::AdaptiveScheduler::Report=true" \endverbatim
+ *
+ * After the selection, each operation costs one more virtual call
+ * than with the selected Scheduler used directly.
+ *
+ * \par Time Complexity
+ *
+ * The complexity of the selected Scheduler, and, once, the replay of
+ * the pending events into each candidate.
+ *
+ * \par Memory Complexity
+ *
+ * The memory of the selected Scheduler, and the recorded delays
+ * (8 bytes per sampled event) until the selection.
+ */
+class AdaptiveScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  AdaptiveScheduler ();
+  /** Destructor. */
+  virtual ~AdaptiveScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+  /**
+   * Get the Scheduler holding the events: the \c InitialScheduler
+   * until the selection, then the selected one.
+   *
+   * \returns The TypeId of the Scheduler.
+   */
+  TypeId GetSelectedType (void) const;
+  /**
+   * Check whether the Scheduler was selected.
+   *
+   * \returns \c true after the selection.
+   */
+  bool IsSelected (void) const;
+  /**
+   * Get the measured cost of the candidates.
+   *
+   * \returns The wall clock time per event of each candidate, in
+   *          nanoseconds, by TypeId name; infinite for the candidates
+   *          which were abandoned.  Empty until the selection.
+   */
+  std::map<std::string, double> GetCosts (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Create the InitialScheduler.
+   *
+   * This can only be used at construction, as invoked by the
+   * Attribute InitialScheduler.
+   *
+   * \param [in] type The TypeId name of the Scheduler.
+   */
+  void SetInitialScheduler (std::string type);
+  /** Time the candidates and move the events to the fastest. */
+  void Select (void);
+  /**
+   * Time the hold operations on a candidate.
+   *
+   * \param [in] type The TypeId name of the candidate.
+   * \param [in] events The pending events, in order.
+   * \param [in] budget The time after which the candidate is
+   *             abandoned, in nanoseconds, or 0 for no limit.
+   * \param [out] elapsed The time spent with the candidate, events
+   *              included, in nanoseconds.
+   * \returns The time per hold operation, in nanoseconds, or infinity
+   *          if the candidate was abandoned.
+   */
+  double Trial (const std::string &type, const std::vector<Scheduler::Event> &events,
+                double budget, double &elapsed) const;
+
+  /** The Scheduler holding the events. */
+  Ptr<Scheduler> m_scheduler;
+  /** The TypeId names of the candidates, separated by commas. */
+  std::string m_candidates;
+  /** Number of events removed before the selection. */
+  uint32_t m_sampleSize;
+  /** Number of hold operations timed per candidate. */
+  uint32_t m_trialSize;
+  /** Whether the choice is written to \c std::clog. */
+  bool m_report;
+  /** Whether the Scheduler was selected. */
+  bool m_selected;
+  /** Number of events removed since the start. */
+  uint32_t m_removed;
+  /** Time stamp of the last removed event. */
+  uint64_t m_now;
+  /** Delays of the inserted events, until the selection. */
+  std::vector<uint64_t> m_delays;
+  /** Number of events in the queue. */
+  uint32_t m_size;
+  /** Sum of the queue sizes after each removal, until the selection. */
+  uint64_t m_sizeSum;
+  /** Time per event of each candidate, in nanoseconds. */
+  std::map<std::string, double> m_costs;
+};
+
+} // namespace ns3
+
+#endif /* ADAPTIVE_SCHEDULER_H */
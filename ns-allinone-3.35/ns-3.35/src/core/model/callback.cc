@@ -73,6 +73,65 @@ CallbackValue::DeserializeFromString (std::string value, Ptr<const AttributeChec
 
 ATTRIBUTE_CHECKER_IMPLEMENT (Callback);
 
+/** The granularity of the sizes of the recycled CallbackImpl. */
+static const std::size_t CALLBACK_IMPL_GRANULARITY = 16;
+/** The number of sizes of recycled CallbackImpl. */
+static const std::size_t CALLBACK_IMPL_SIZES = 8;
+/** The number of CallbackImpl allocated at once from the heap. */
+static const std::size_t CALLBACK_IMPL_CHUNK = 32;
+
+/** The memory of a free CallbackImpl. */
+struct FreeCallbackImpl
+{
+  FreeCallbackImpl *next; //!< The next free CallbackImpl of the same size
+};
+
+/**
+ * The free CallbackImpl of this thread, by size.  These are plain
+ * pointers, so they can still be used while static objects are
+ * destroyed.
+ */
+static thread_local FreeCallbackImpl *g_freeCallbackImpl[CALLBACK_IMPL_SIZES];
+
+void *
+CallbackImplBase::operator new (std::size_t size)
+{
+  std::size_t index = (size - 1) / CALLBACK_IMPL_GRANULARITY;
+  if (index >= CALLBACK_IMPL_SIZES)
+    {
+      return ::operator new (size);
+    }
+  FreeCallbackImpl *impl = g_freeCallbackImpl[index];
+  if (impl != 0)
+    {
+      g_freeCallbackImpl[index] = impl->next;
+      return impl;
+    }
+  std::size_t blockSize = (index + 1) * CALLBACK_IMPL_GRANULARITY;
+  char *chunk = static_cast<char *> (::operator new (blockSize * CALLBACK_IMPL_CHUNK));
+  for (std::size_t i = CALLBACK_IMPL_CHUNK - 1; i > 0; i--)
+    {
+      FreeCallbackImpl *block = reinterpret_cast<FreeCallbackImpl *> (chunk + i * blockSize);
+      block->next = g_freeCallbackImpl[index];
+      g_freeCallbackImpl[index] = block;
+    }
+  return chunk;
+}
+
+void
+CallbackImplBase::operator delete (void *p, std::size_t size)
+{
+  std::size_t index = (size - 1) / CALLBACK_IMPL_GRANULARITY;
+  if (index >= CALLBACK_IMPL_SIZES)
+    {
+      ::operator delete (p);
+      return;
+    }
+  FreeCallbackImpl *impl = static_cast<FreeCallbackImpl *> (p);
+  impl->next = g_freeCallbackImpl[index];
+  g_freeCallbackImpl[index] = impl;
+}
+
 } // namespace ns3
 
 #if (__GNUC__ >= 3)
@@ -29,6 +29,9 @@
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
 #include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
 
 /**
  * \file
@@ -103,6 +106,11 @@ struct CallbackTraits<T *>
  * \ingroup callbackimpl
  * Abstract base class for CallbackImpl
  * Provides reference counting and equality test.
+ *
+ * A CallbackImpl is allocated for each Callback made, often on the
+ * path of each packet, so the small ones, which hold a functor or a
+ * member function pointer and a few bound arguments, are recycled
+ * through per-thread free lists, rather than going to the heap.
  */
 class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
 {
@@ -110,6 +118,21 @@ public:
   /** Virtual destructor */
   virtual ~CallbackImplBase ()
   {}
+  /**
+   * Allocate a CallbackImpl, from a free list if it is small.
+   *
+   * \param [in] size The size of the CallbackImpl.
+   * 
+eturn The memory of the CallbackImpl.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release a CallbackImpl, to a free list if it is small.
+   *
+   * \param [in] p The memory of the CallbackImpl.
+   * \param [in] size The size of the CallbackImpl.
+   */
+  static void operator delete (void *p, std::size_t size);
   /**
    * Equality test
    *
@@ -460,7 +483,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (a1);
+    return m_functor (std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -469,7 +492,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (a1,a2);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -479,7 +502,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (a1,a2,a3);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -490,7 +513,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (a1,a2,a3,a4);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -502,7 +525,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (a1,a2,a3,a4,a5);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -515,7 +538,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -529,7 +552,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -544,7 +567,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7,a8);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7),std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -560,7 +583,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8,T9 a9)
   {
-    return m_functor (a1,a2,a3,a4,a5,a6,a7,a8,a9);
+    return m_functor (std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7),std::forward<T8> (a8),std::forward<T9> (a9));
   }
   /**@}*/
   /**
@@ -577,7 +600,7 @@ public:
       {
         return false;
       }
-    else if (otherDerived->m_functor != m_functor)
+    else if (otherDerived != this && !IsEqualFunctor (otherDerived->m_functor, m_functor, 0))
       {
         return false;
       }
@@ -585,6 +608,35 @@ public:
   }
 
 private:
+  /**
+   * Compare two functors which can be compared.
+   *
+   * \tparam U \deduced The type of the functors.
+   * \param [in] a The first functor.
+   * \param [in] b The second functor.
+   * 
+eturn \c true if the functors are equal.
+   */
+  template <typename U>
+  static auto IsEqualFunctor (U const &a, U const &b, int) -> decltype (static_cast<bool> (a != b))
+  {
+    return !(a != b);
+  }
+  /**
+   * Compare two functors which cannot be compared, as lambdas with
+   * captures: they are only equal to themselves.
+   *
+   * \tparam U \deduced The type of the functors.
+   * \param [in] a The first functor.
+   * \param [in] b The second functor.
+   * \return \c true if the functors are the same object.
+   */
+  template <typename U>
+  static bool IsEqualFunctor (U const &a, U const &b, long)
+  {
+    return &a == &b;
+  }
+
   T m_functor;                          //!< the functor
 };
 
@@ -624,7 +676,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -633,7 +685,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -643,7 +695,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -654,7 +706,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -666,7 +718,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -679,7 +731,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -693,7 +745,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6), std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -708,7 +760,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7, a8);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6), std::forward<T7> (a7), std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -724,7 +776,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8, T9 a9)
   {
-    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(a1, a2, a3, a4, a5, a6, a7, a8, a9);
+    return ((CallbackTraits<OBJ_PTR>::GetReference (m_objPtr)).*m_memPtr)(std::forward<T1> (a1), std::forward<T2> (a2), std::forward<T3> (a3), std::forward<T4> (a4), std::forward<T5> (a5), std::forward<T6> (a6), std::forward<T7> (a7), std::forward<T8> (a8), std::forward<T9> (a9));
   }
   /**@}*/
   /**
@@ -794,7 +846,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a,a1);
+    return m_functor (m_a,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -803,7 +855,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a,a1,a2);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -813,7 +865,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a,a1,a2,a3);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -824,7 +876,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a,a1,a2,a3,a4);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -836,7 +888,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -849,7 +901,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -863,7 +915,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -878,7 +930,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8)
   {
-    return m_functor (m_a,a1,a2,a3,a4,a5,a6,a7,a8);
+    return m_functor (m_a,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7),std::forward<T8> (a8));
   }
   /**@}*/
   /**
@@ -952,7 +1004,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a1,m_a2,a1);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -961,7 +1013,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a1,m_a2,a1,a2);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -971,7 +1023,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -982,7 +1034,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -994,7 +1046,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1007,7 +1059,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -1021,7 +1073,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7)
   {
-    return m_functor (m_a1,m_a2,a1,a2,a3,a4,a5,a6,a7);
+    return m_functor (m_a1,m_a2,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7));
   }
   /**@}*/
   /**
@@ -1100,7 +1152,7 @@ public:
    */
   R operator() (T1 a1)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -1109,7 +1161,7 @@ public:
    */
   R operator() (T1 a1,T2 a2)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -1119,7 +1171,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -1130,7 +1182,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -1142,7 +1194,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4,a5);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1155,7 +1207,7 @@ public:
    */
   R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6)
   {
-    return m_functor (m_a1,m_a2,m_a3,a1,a2,a3,a4,a5,a6);
+    return m_functor (m_a1,m_a2,m_a3,std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6));
   }
   /**@}*/
   /**
@@ -1213,6 +1265,55 @@ protected:
   Ptr<CallbackImplBase> m_impl;         //!< the pimpl
 };
 
+/**
+ * \ingroup callbackimpl
+ * Check whether a functor can be called with the arguments of a
+ * Callback, which are the template arguments up to the first \c empty.
+ *
+ * \tparam FUNCTOR \explicit The type of the functor.
+ * \tparam ARGS \explicit The arguments found so far, as a CallbackArguments.
+ * \tparam Ts \explicit The remaining template arguments of the Callback.
+ */
+template <typename FUNCTOR, typename ARGS, typename... Ts>
+struct IsCallbackFunctor;
+
+/**
+ * \ingroup callbackimpl
+ * A list of the types of the arguments of a Callback.
+ * \tparam Ts \explicit The types of the arguments.
+ */
+template <typename... Ts>
+struct CallbackArguments
+{};
+
+/**
+ * \ingroup callbackimpl
+ * All the template arguments are arguments.
+ * \copydoc IsCallbackFunctor
+ */
+template <typename FUNCTOR, typename... As>
+struct IsCallbackFunctor<FUNCTOR, CallbackArguments<As...> >
+  : std::is_invocable<FUNCTOR &, As...>
+{};
+/**
+ * \ingroup callbackimpl
+ * The arguments end at the first \c empty.
+ * \copydoc IsCallbackFunctor
+ */
+template <typename FUNCTOR, typename... As, typename... Ts>
+struct IsCallbackFunctor<FUNCTOR, CallbackArguments<As...>, empty, Ts...>
+  : std::is_invocable<FUNCTOR &, As...>
+{};
+/**
+ * \ingroup callbackimpl
+ * Add the next template argument to the arguments.
+ * \copydoc IsCallbackFunctor
+ */
+template <typename FUNCTOR, typename... As, typename T, typename... Ts>
+struct IsCallbackFunctor<FUNCTOR, CallbackArguments<As...>, T, Ts...>
+  : IsCallbackFunctor<FUNCTOR, CallbackArguments<As..., T>, Ts...>
+{};
+
 /**
  * \ingroup callback
  * \brief Callback template class
@@ -1296,6 +1397,29 @@ public:
     : CallbackBase (Create<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor))
   {}
 
+  /**
+   * Construct from any functor which can be called with the arguments
+   * of this Callback, as a lambda:
+   * \code
+   *   Callback<void, Ptr<Socket> > cb = [this] (Ptr<Socket> socket) { Receive (socket); };
+   * \endcode
+   *
+   * A functor without an equality operator, as a lambda which
+   * captures, is only equal to the copies of this Callback.
+   *
+   * \tparam FUNCTOR \deduced The type of the functor.
+   * \param [in] functor The functor to run on this callback
+   */
+  template <typename FUNCTOR,
+            typename std::enable_if<!std::is_base_of<CallbackBase, typename std::decay<FUNCTOR>::type>::value
+                                    && IsCallbackFunctor<typename std::decay<FUNCTOR>::type,
+                                                         CallbackArguments<>,
+                                                         T1,T2,T3,T4,T5,T6,T7,T8,T9>::value,
+                                    int>::type = 0>
+  Callback (FUNCTOR const &functor)
+    : CallbackBase (Create<FunctorCallbackImpl<typename std::decay<FUNCTOR>::type,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor))
+  {}
+
   /**
    * Construct a member function pointer call back.
    *
@@ -1408,7 +1532,7 @@ public:
    */
   R operator() (T1 a1) const
   {
-    return (*(DoPeekImpl ()))(a1);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1));
   }
   /**
    * \param [in] a1 First argument
@@ -1417,7 +1541,7 @@ public:
    */
   R operator() (T1 a1, T2 a2) const
   {
-    return (*(DoPeekImpl ()))(a1,a2);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2));
   }
   /**
    * \param [in] a1 First argument
@@ -1427,7 +1551,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3));
   }
   /**
    * \param [in] a1 First argument
@@ -1438,7 +1562,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4));
   }
   /**
    * \param [in] a1 First argument
@@ -1450,7 +1574,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5));
   }
   /**
    * \param [in] a1 First argument
@@ -1463,7 +1587,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6));
   }
   /**
    * \param [in] a1 First argument
@@ -1477,7 +1601,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7));
   }
   /**
    * \param [in] a1 First argument
@@ -1492,7 +1616,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7),std::forward<T8> (a8));
   }
   /**
    * \param [in] a1 First argument
@@ -1508,7 +1632,7 @@ public:
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8, T9 a9) const
   {
-    return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8,a9);
+    return (*(DoPeekImpl ()))(std::forward<T1> (a1),std::forward<T2> (a2),std::forward<T3> (a3),std::forward<T4> (a4),std::forward<T5> (a5),std::forward<T6> (a6),std::forward<T7> (a7),std::forward<T8> (a8),std::forward<T9> (a9));
   }
   /**@}*/
 
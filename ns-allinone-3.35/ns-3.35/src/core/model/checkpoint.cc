@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+std::vector<int> Checkpoint::m_exitStatus;
+
+namespace {
+
+/**
+ * Wait for a branch to finish.
+ * \param [in,out] running The running branches, by process id.
+ * \param [out] exitStatus The exit status of each branch.
+ */
+void
+WaitBranch (std::map<pid_t, uint32_t> &running, std::vector<int> &exitStatus)
+{
+  int status;
+  pid_t pid = waitpid (-1, &status, 0);
+  if (pid < 0)
+    {
+      NS_FATAL_ERROR ("Checkpoint: waitpid failed: " << std::strerror (errno));
+    }
+  std::map<pid_t, uint32_t>::iterator branch = running.find (pid);
+  if (branch == running.end ())
+    {
+      // Not one of ours.
+      return;
+    }
+  if (WIFEXITED (status))
+    {
+      exitStatus[branch->second] = WEXITSTATUS (status);
+    }
+  else if (WIFSIGNALED (status))
+    {
+      exitStatus[branch->second] = 128 + WTERMSIG (status);
+    }
+  NS_LOG_INFO ("branch " << branch->second << " finished with status " << exitStatus[branch->second]);
+  running.erase (branch);
+}
+
+} // unnamed namespace
+
+bool
+Checkpoint::Fork (uint32_t nBranches, uint32_t &branch, uint32_t maxConcurrent, bool reseed)
+{
+  NS_LOG_FUNCTION (nBranches << maxConcurrent << reseed);
+  if (maxConcurrent == 0)
+    {
+      maxConcurrent = std::max (1U, std::thread::hardware_concurrency ());
+    }
+
+  // Buffered output would be written by every branch.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (NULL);
+
+  m_exitStatus.assign (nBranches, -1);
+  std::map<pid_t, uint32_t> running;
+  for (uint32_t i = 0; i < nBranches; ++i)
+    {
+      while (running.size () >= maxConcurrent)
+        {
+          WaitBranch (running, m_exitStatus);
+        }
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Checkpoint: fork failed: " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          m_exitStatus.clear ();
+          branch = i;
+          if (reseed && i > 0)
+            {
+              RandomVariableStream::AdvanceAllStreams (i);
+              RngSeedManager::SetRun (RngSeedManager::GetRun () + i);
+            }
+          NS_LOG_INFO ("branch " << i << " started");
+          return true;
+        }
+      NS_LOG_INFO ("branch " << i << " is process " << pid);
+      running[pid] = i;
+    }
+  while (!running.empty ())
+    {
+      WaitBranch (running, m_exitStatus);
+    }
+  return false;
+}
+
+const std::vector<int> &
+Checkpoint::GetExitStatus (void)
+{
+  return m_exitStatus;
+}
+
+} // namespace ns3
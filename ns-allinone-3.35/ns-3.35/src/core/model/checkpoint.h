@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Continue a simulation from its current state in several
+ * processes.
+ *
+ * Studies which sweep a parameter often spend the beginning of each
+ * run in the same warm-up phase (association, connection set-up, TCP
+ * slow start...), before the measurement starts.  A checkpoint runs
+ * the warm-up once, and then forks the process into one branch per
+ * parameter value: each branch resumes from the warm state, with the
+ * complete event list, objects and attributes, packet queues and
+ * random streams, and applies its own parameter before continuing.
+ *
+ * \code
+ *   BuildScenario ();
+ *   Simulator::Stop (Seconds (warmup));
+ *   Simulator::Run ();
+ *
+ *   uint32_t branch;
+ *   if (Checkpoint::Fork (distances.size (), branch))
+ *     {
+ *       // In branch number 'branch'.
+ *       SetDistance (distances[branch]);
+ *       Simulator::Stop (Seconds (measurement));
+ *       Simulator::Run ();
+ *       WriteResults ("results-" + std::to_string (branch));
+ *     }
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * The state of a simulation is made of arbitrary C++ objects, and
+ * events bound to arbitrary functions, which cannot be serialized in
+ * general: the checkpoint is the memory image of the process, copied
+ * by the operating system, so it is only available on POSIX systems.
+ * Files opened before the fork are shared by the branches, so traces
+ * should be flushed before the fork, and opened by each branch with
+ * its own name afterwards.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * Fork the simulation into branches, and wait until the branches
+   * are finished.
+   *
+   * Each branch is a child process, which returns from this function
+   * with \c true, and exits when it is finished.  The random streams
+   * of branch \c i are moved \c i sub-streams ahead if \p reseed is
+   * \c true, so that the branches draw independent random values, as
+   * with RngRun values \c i apart; branch 0 keeps the random values
+   * the simulation would have used without the fork.
+   *
+   * The calling process returns with \c false when all the branches
+   * are finished; see GetExitStatus().
+   *
+   * \param [in] nBranches The number of branches.
+   * \param [out] branch The branch number, in the branches.
+   * \param [in] maxConcurrent The maximum number of branches running
+   *             at the same time, or 0 for the number of cores.
+   * \param [in] reseed Whether to make the random values of the
+   *             branches independent.
+   * \returns \c true in the branches, \c false in the calling process.
+   */
+  static bool Fork (uint32_t nBranches, uint32_t &branch,
+                    uint32_t maxConcurrent = 0, bool reseed = true);
+  /**
+   * Get the exit status of the branches of the last Fork().
+   *
+   * \returns The exit status of each branch: the value returned by
+   *          \c main or given to \c exit, or 128 plus the signal
+   *          number if the branch was killed.
+   */
+  static const std::vector<int> & GetExitStatus (void);
+
+private:
+  /** The exit status of the branches. */
+  static std::vector<int> m_exitStatus;
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
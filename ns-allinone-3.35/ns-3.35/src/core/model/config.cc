@@ -27,6 +27,8 @@
 #include "log.h"
 
 #include <sstream>
+#include <map>
+#include <algorithm>
 
 /**
  * \file
@@ -182,10 +184,16 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into ranges of indices, so that
+ * matching the entries of a large array does not parse it again for
+ * each entry.
  */
 class ArrayMatcher
 {
 public:
+  /** Default constructor: matches nothing. */
+  ArrayMatcher ();
   /**
    * Construct from a Config path specification.
    *
@@ -199,8 +207,26 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Get the few indices which can match, so that the entries of an
+   * array can be found by index rather than by looking at all of them.
+   *
+   * \param [out] indices The indices, sorted.
+   * \returns \c false if the specification can match more than
+   *          MAX_INDICES indices, e.g. if it is \c "*".
+   */
+  bool GetIndices (std::vector<std::size_t> *indices) const;
+
+  /** The most indices returned by GetIndices(). */
+  static const uint32_t MAX_INDICES = 64;
 
 private:
+  /**
+   * Parse a Config path specification, or a part of it.
+   *
+   * \param [in] element The specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,77 +237,117 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether the element matches all the indices. */
+  bool m_all;
+  /** The ranges of matching indices, bounds included. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 
 };  // class ArrayMatcher
 
 
+ArrayMatcher::ArrayMatcher ()
+  : m_all (false)
+{
+  NS_LOG_FUNCTION (this);
+}
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      std::string left = element.substr (0, tmp - 0);
+      std::string right = element.substr (tmp + 1, element.size () - (tmp + 1));
+      Parse (left);
+      Parse (right);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min)
           && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
+          && min <= max)
+        {
+          m_ranges.push_back (std::make_pair (min, max));
+        }
+      return;
+    }
+  uint32_t value;
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
+    {
+      NS_LOG_DEBUG ("Array " << i << " matches *");
+      return true;
+    }
+  for (std::size_t j = 0; j < m_ranges.size (); j++)
+    {
+      if (i >= m_ranges[j].first && i <= m_ranges[j].second)
         {
           NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
           return true;
         }
-      else
+    }
+  NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
+  return false;
+}
+bool
+ArrayMatcher::GetIndices (std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << indices);
+  if (m_all)
+    {
+      return false;
+    }
+  uint64_t n = 0;
+  for (std::size_t j = 0; j < m_ranges.size (); j++)
+    {
+      n += static_cast<uint64_t> (m_ranges[j].second) - m_ranges[j].first + 1;
+      if (n > MAX_INDICES)
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
           return false;
         }
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  indices->clear ();
+  for (std::size_t j = 0; j < m_ranges.size (); j++)
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-      return true;
+      for (uint64_t i = m_ranges[j].first; i <= m_ranges[j].second; i++)
+        {
+          indices->push_back (i);
+        }
     }
-  NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-  return false;
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return true;
 }
 
 bool
@@ -294,9 +360,115 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * An attribute which a Config path element can go through: an object
+ * pointer, or a container of object pointers.
+ */
+struct PathAttribute
+{
+  /** The name of the attribute. */
+  std::string name;
+  /** The accessor of the attribute. */
+  Ptr<const AttributeAccessor> accessor;
+  /** Whether the attribute is a container, rather than a pointer. */
+  bool container;
+  /** The accessor of a container, if it can find objects by index, or 0. */
+  const ObjectPtrContainerAccessor *containerAccessor;
+  /** Whether the accessor can get the attribute. */
+  bool getter;
+};
+
+/**
+ * \ingroup config-impl
+ * Get the pointer and container attributes of a type which match a
+ * Config path element.
+ *
+ * The attributes of the type and of its parents are looked up
+ * (comparing their names, and casting their checkers) only the first
+ * time, for each type and element.
+ *
+ * \param [in] tid The type of the object.
+ * \param [in] item The Config path element: an attribute name or \c "*".
+ * \returns The matching attributes, from the type to its parents.
+ */
+static const std::vector<PathAttribute> &
+LookupPathAttributes (TypeId tid, std::string const &item)
+{
+  NS_LOG_FUNCTION (tid << item);
+  typedef std::map<std::pair<uint16_t, std::string>, std::vector<PathAttribute> > Cache;
+  static Cache cache;
+  std::pair<Cache::iterator, bool> inserted =
+    cache.insert (std::make_pair (std::make_pair (tid.GetUid (), item), std::vector<PathAttribute> ()));
+  std::vector<PathAttribute> &attributes = inserted.first->second;
+  if (!inserted.second)
+    {
+      return attributes;
+    }
+
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.containerAccessor = 0;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = false;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = true;
+            }
+          else
+            {
+              // this could be anything else and we don't know what to do with it.
+              // So, we just ignore it.
+              continue;
+            }
+          // ObjectBase::GetAttribute gets the attribute of this name
+          // which is the closest to the type of the object.
+          attribute.accessor = info.accessor;
+          attribute.getter = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ();
+          for (std::size_t j = 0; j < attributes.size (); j++)
+            {
+              if (attributes[j].name == info.name)
+                {
+                  attribute.accessor = attributes[j].accessor;
+                  attribute.getter = attributes[j].getter;
+                  break;
+                }
+            }
+          if (attribute.container)
+            {
+              attribute.containerAccessor =
+                dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+            }
+          attributes.push_back (attribute);
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  return attributes;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The path is compiled once into its elements, each parsed for what
+ * it can match: an object name, a \c $TypeId, an attribute name, or
+ * array indices.  Resolving the path from many objects then only
+ * walks these elements.
  */
 class Resolver
 {
@@ -320,23 +492,37 @@ public:
   void Resolve (Ptr<Object> root);
 
 private:
+  /** A Config path element, parsed. */
+  struct Element
+  {
+    std::string item;      //!< The text of the element
+    bool names;            //!< Whether the remaining path starts with "/Names"
+    bool getObject;        //!< Whether the element is a \c $TypeId
+    bool validTid;         //!< Whether the TypeId of a \c $TypeId element exists
+    TypeId tid;            //!< The TypeId of a \c $TypeId element
+    ArrayMatcher matcher;  //!< The indices matched by the element
+  };
+
   /** Ensure the Config path starts and ends with a '/'. */
   void Canonicalize (void);
+  /** Split the Config path into its elements, and parse them. */
+  void Compile (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] element The index of the next element.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] element The index of the element holding the index.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t element, Ptr<Object> root, PathAttribute const &attribute);
   /**
    * Handle one object found on the path.
    *
@@ -361,6 +547,8 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<Element> m_elements;
 
 };  // class Resolver
 
@@ -369,6 +557,7 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  Compile ();
 }
 Resolver::~Resolver ()
 {
@@ -394,12 +583,34 @@ Resolver::Canonicalize (void)
     }
 }
 
+void
+Resolver::Compile (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string::size_type start = 0;
+  std::string::size_type next = m_path.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      Element element;
+      element.item = m_path.substr (start + 1, next - (start + 1));
+      element.names = m_path.compare (start, 6, "/Names") == 0;
+      element.getObject = element.item.find ("$") == 0;
+      element.validTid = element.getObject
+        && TypeId::LookupByNameFailSafe (element.item.substr (1), &element.tid);
+      element.matcher = ArrayMatcher (element.item);
+      m_elements.push_back (element);
+      start = next;
+      next = m_path.find ("/", start + 1);
+    }
+}
+
 void
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -425,13 +636,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t element, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << element << root);
 
-  if (next == std::string::npos)
+  if (element == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +656,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  Element const &current = m_elements[element];
+  std::string const &item = current.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +668,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (current.names)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (element + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +688,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (element + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -496,84 +704,61 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (current.getObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject=" << tidString << " on path=" << GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject=" << item.substr (1) << " on path=" << GetResolvedPath ());
+      // Let TypeId::LookupByName report an unknown type.
+      TypeId tid = current.validTid ? current.tid : TypeId::LookupByName (item.substr (1));
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject (" << tidString << ") failed on path=" << GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject (" << item.substr (1) << ") failed on path=" << GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (element + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-
-      do
+      const std::vector<PathAttribute> &attributes =
+        LookupPathAttributes (root->GetInstanceTypeId (), item);
+      for (std::size_t i = 0; i < attributes.size (); i++)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          PathAttribute const &attribute = attributes[i];
+          if (!attribute.container)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << attribute.name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              if (!attribute.getter || !attribute.accessor->Get (PeekPointer (root), pValue))
                 {
-                  continue;
+                  // Let ObjectBase::GetAttribute raise any errors
+                  root->GetAttribute (attribute.name, pValue);
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (attribute.name);
+              DoResolve (element + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << attribute.name << " on path=" << GetResolvedPath ());
+              m_workStack.push_back (attribute.name);
+              DoArrayResolve (element + 1, root, attribute);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
-      if (!foundMatch)
+      if (attributes.empty ())
         {
           NS_LOG_DEBUG ("Requested item=" << item << " does not exist on path=" << GetResolvedPath ());
           return;
@@ -582,20 +767,37 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t element, Ptr<Object> root, PathAttribute const &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << element << root << attribute.name);
+  if (element == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  ArrayMatcher const &matcher = m_elements[element].matcher;
+
+  // Find the few matching entries by index, rather than getting all
+  // the entries of the container.
+  std::vector<std::size_t> indices;
+  if (attribute.getter && attribute.containerAccessor != 0 && matcher.GetIndices (&indices))
+    {
+      for (std::size_t i = 0; i < indices.size (); i++)
+        {
+          Ptr<Object> object;
+          if (attribute.containerAccessor->Find (PeekPointer (root), indices[i], &object))
+            {
+              std::ostringstream oss;
+              oss << indices[i];
+              m_workStack.push_back (oss.str ());
+              DoResolve (element + 1, object);
+              m_workStack.pop_back ();
+            }
+        }
+      return;
+    }
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ObjectPtrContainerValue container;
+  root->GetAttribute (attribute.name, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -604,7 +806,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (element + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -20,6 +20,7 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -31,6 +32,161 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/**
+ * \ingroup events
+ * Per-thread free lists of event storage, one per size class.
+ *
+ * Storage is only ever obtained from, and returned to, the global
+ * heap one block at a time, so a block allocated in one thread may
+ * safely be recycled by another, as happens with
+ * Simulator::ScheduleWithContext in the realtime simulator.
+ */
+class EventPool
+{
+public:
+  /** Constructor. */
+  EventPool ();
+  /** Destructor: release all the cached blocks. */
+  ~EventPool ();
+  /**
+   * Get the pool of the calling thread.
+   * eturns The pool, or null if it has already been destroyed.
+   */
+  static EventPool * Get (void);
+  /**
+   * Get the storage for an event.
+   * \param [in] size The size of the event, in bytes.
+   * eturns The storage.
+   */
+  void * Allocate (std::size_t size);
+  /**
+   * Recycle the storage of an event.
+   * \param [in] p The storage.
+   * \param [in] size The size of the event, in bytes.
+   */
+  void Deallocate (void *p, std::size_t size);
+
+  /** Granularity of the size classes, in bytes. */
+  static const std::size_t ALIGNMENT = 16;
+  /** Number of size classes: events up to 256 bytes are pooled. */
+  static const std::size_t N_CLASSES = 16;
+  /** Maximum number of free blocks kept in each size class. */
+  static const uint32_t MAX_FREE = 4096;
+
+private:
+  /** A free block, linked to the next one. */
+  struct Block
+  {
+    Block *next;  /**< The next free block. */
+  };
+  /** The free lists. */
+  Block *m_free[N_CLASSES];
+  /** The length of each free list. */
+  uint32_t m_nFree[N_CLASSES];
+};
+
+/** Set once the pool of the calling thread has been destroyed. */
+thread_local bool g_eventPoolDestroyed = false;
+
+EventPool::EventPool ()
+{
+  for (std::size_t i = 0; i < N_CLASSES; ++i)
+    {
+      m_free[i] = 0;
+      m_nFree[i] = 0;
+    }
+}
+
+EventPool::~EventPool ()
+{
+  for (std::size_t i = 0; i < N_CLASSES; ++i)
+    {
+      while (m_free[i] != 0)
+        {
+          Block *block = m_free[i];
+          m_free[i] = block->next;
+          ::operator delete (block);
+        }
+    }
+  g_eventPoolDestroyed = true;
+}
+
+EventPool *
+EventPool::Get (void)
+{
+  static thread_local EventPool pool;
+  if (g_eventPoolDestroyed)
+    {
+      // Events released by static destructors, after thread exit
+      return 0;
+    }
+  return &pool;
+}
+
+void *
+EventPool::Allocate (std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / ALIGNMENT;
+  if (sizeClass >= N_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  Block *block = m_free[sizeClass];
+  if (block == 0)
+    {
+      return ::operator new ((sizeClass + 1) * ALIGNMENT);
+    }
+  m_free[sizeClass] = block->next;
+  m_nFree[sizeClass]--;
+  return block;
+}
+
+void
+EventPool::Deallocate (void *p, std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / ALIGNMENT;
+  if (sizeClass >= N_CLASSES || m_nFree[sizeClass] >= MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  Block *block = static_cast<Block *> (p);
+  block->next = m_free[sizeClass];
+  m_free[sizeClass] = block;
+  m_nFree[sizeClass]++;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  EventPool *pool = EventPool::Get ();
+  if (pool == 0)
+    {
+      return ::operator new (size);
+    }
+  return pool->Allocate (size);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  EventPool *pool = EventPool::Get ();
+  if (pool == 0)
+    {
+      ::operator delete (p);
+      return;
+    }
+  pool->Deallocate (p, size);
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,28 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate storage for an event.
+   *
+   * Events, together with their bound arguments, are allocated from
+   * per-thread free lists sorted in size classes, and are recycled
+   * there when their last reference is released.  Typical calls to
+   * Simulator::Schedule thus reuse the storage of an event which has
+   * already been invoked or cancelled instead of going through the
+   * heap.  Events too large for any size class use the global heap.
+   *
+   * \param [in] size The size of the event, in bytes.
+   * eturns The storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an event.
+   *
+   * \param [in] p The storage of the event.
+   * \param [in] size The size of the event, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,447 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+#include "event-profiler.h"
+#include "global-value.h"
+#include "string.h"
+#include "uinteger.h"
+#include "log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+/**
+ * \relates EventProfiler
+ * The file to write the event profile to.
+ *
+ * This is accessible as "--EventProfileFile" from CommandLine.
+ */
+static GlobalValue g_eventProfileFile ("EventProfileFile",
+                                       "The file to write the profile of the events to at "
+                                       "Simulator::Destroy, in JSON if its name ends with .json, "
+                                       "as collapsed stacks otherwise.  Empty to disable the profile.",
+                                       StringValue (""),
+                                       MakeStringChecker ());
+/**
+ * \relates EventProfiler
+ * The sampling period of the event profile.
+ *
+ * This is accessible as "--EventProfileSamplePeriod" from CommandLine.
+ */
+static GlobalValue g_eventProfileSamplePeriod ("EventProfileSamplePeriod",
+                                               "Time one event out of this number.",
+                                               UintegerValue (1),
+                                               MakeUintegerChecker<uint32_t> (1));
+
+bool EventProfiler::m_enabled = false;
+
+namespace {
+
+/**
+ * Write a string as a JSON string.
+ * \param [in,out] os The output stream.
+ * \param [in] s The string.
+ */
+void
+WriteJsonString (std::ostream &os, const std::string &s)
+{
+  os << '"';
+  for (std::string::const_iterator c = s.begin (); c != s.end (); ++c)
+    {
+      if (*c == '"' || *c == '\\')
+        {
+          os << '\\';
+        }
+      os << *c;
+    }
+  os << '"';
+}
+
+/**
+ * Write a profile entry as JSON members.
+ * \param [in,out] os The output stream.
+ * \param [in] entry The entry.
+ * \param [in] scale The number of events each sample stands for.
+ */
+void
+WriteJsonEntry (std::ostream &os, const EventProfiler::Entry &entry, double scale)
+{
+  os << "\"samples\" : " << entry.samples
+     << ", \"events\" : " << static_cast<uint64_t> (entry.samples * scale + 0.5)
+     << ", \"wall_ns\" : " << static_cast<uint64_t> (entry.nanoseconds * scale + 0.5)
+     << ", \"max_ns\" : " << entry.maxNanoseconds;
+}
+
+/**
+ * Add a sample to an entry.
+ * \param [in,out] entry The entry.
+ * \param [in] sample The entry to add.
+ */
+void
+Accumulate (EventProfiler::Entry &entry, const EventProfiler::Entry &sample)
+{
+  entry.samples += sample.samples;
+  entry.nanoseconds += sample.nanoseconds;
+  entry.maxNanoseconds = std::max (entry.maxNanoseconds, sample.maxNanoseconds);
+}
+
+/**
+ * Compare entries by decreasing time.
+ * \param [in] a The first entry.
+ * \param [in] b The second entry.
+ * \returns \c true if \p a took longer than \p b.
+ */
+template <typename K>
+bool
+LongerThan (const std::pair<K, EventProfiler::Entry> &a,
+            const std::pair<K, EventProfiler::Entry> &b)
+{
+  return a.second.nanoseconds > b.second.nanoseconds;
+}
+
+/**
+ * Get the name of a context.
+ * \param [in] context The context.
+ * \returns The name of the context.
+ */
+std::string
+ContextName (uint32_t context)
+{
+  if (context == 0xffffffff)
+    {
+      return "no context";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+} // unnamed namespace
+
+EventProfiler::EventProfiler ()
+  : m_period (1),
+    m_countdown (1),
+    m_random (1),
+    m_events (0),
+    m_samples (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::Enable (uint32_t period, std::string filename)
+{
+  NS_LOG_FUNCTION (this << period << filename);
+  NS_ASSERT_MSG (period > 0, "The sampling period must be positive");
+  m_period = period;
+  m_random = 0x2545f491;
+  m_countdown = NextInterval ();
+  m_filename = filename;
+  m_enabled = true;
+}
+
+void
+EventProfiler::Disable (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_enabled = false;
+}
+
+void
+EventProfiler::Configure (void)
+{
+  NS_LOG_FUNCTION (this);
+  StringValue filename;
+  g_eventProfileFile.GetValue (filename);
+  if (m_enabled || filename.Get ().empty ())
+    {
+      return;
+    }
+  UintegerValue period;
+  g_eventProfileSamplePeriod.GetValue (period);
+  Enable (static_cast<uint32_t> (period.Get ()), filename.Get ());
+}
+
+void
+EventProfiler::Sample (EventImpl *event, uint32_t context)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now ();
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ();
+
+  Entry &entry = m_entries[Key (&typeid (*event), context)];
+  entry.samples++;
+  entry.nanoseconds += ns;
+  entry.maxNanoseconds = std::max (entry.maxNanoseconds, ns);
+  m_samples++;
+  m_countdown = NextInterval ();
+}
+
+uint32_t
+EventProfiler::NextInterval (void)
+{
+  if (m_period == 1)
+    {
+      return 1;
+    }
+  // The simulation must not depend on the profile, so use a private
+  // xorshift generator rather than a RandomVariableStream.
+  m_random ^= m_random << 13;
+  m_random ^= m_random >> 17;
+  m_random ^= m_random << 5;
+  return 1 + m_random % (2 * m_period - 1);
+}
+
+double
+EventProfiler::GetScale (void) const
+{
+  return m_samples == 0 ? 0 : static_cast<double> (m_events) / m_samples;
+}
+
+uint32_t
+EventProfiler::GetSamplePeriod (void) const
+{
+  return m_period;
+}
+
+uint64_t
+EventProfiler::GetEventCount (void) const
+{
+  return m_events;
+}
+
+uint64_t
+EventProfiler::GetSampleCount (void) const
+{
+  return m_samples;
+}
+
+std::string
+EventProfiler::GetHandlerName (const std::type_info &type)
+{
+  std::string name = type.name ();
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+
+  // The events of MakeEvent are local classes of the function
+  // template, whose first parameter is the function they invoke:
+  // keep its type.
+  std::string::size_type start = name.find ("MakeEvent<");
+  if (start == std::string::npos)
+    {
+      return name;
+    }
+  // Skip the template arguments.
+  std::string::size_type i = start + 9;
+  int depth = 0;
+  do
+    {
+      if (name[i] == '<')
+        {
+          ++depth;
+        }
+      else if (name[i] == '>')
+        {
+          --depth;
+        }
+      ++i;
+    }
+  while (depth > 0 && i < name.size ());
+  if (i >= name.size () || name[i] != '(')
+    {
+      return name;
+    }
+  start = ++i;
+  for (; i < name.size (); ++i)
+    {
+      char c = name[i];
+      if (c == '<' || c == '(')
+        {
+          ++depth;
+        }
+      else if ((c == ',' || c == ')') && depth == 0)
+        {
+          return name.substr (start, i - start);
+        }
+      else if (c == '>' || c == ')')
+        {
+          --depth;
+        }
+    }
+  return name;
+}
+
+std::map<std::string, EventProfiler::Entry>
+EventProfiler::GetHandlers (void) const
+{
+  std::map<std::string, Entry> handlers;
+  std::unordered_map<const std::type_info *, std::string> names;
+  for (std::unordered_map<Key, Entry, KeyHash>::const_iterator i = m_entries.begin ();
+       i != m_entries.end (); ++i)
+    {
+      std::unordered_map<const std::type_info *, std::string>::iterator name = names.find (i->first.first);
+      if (name == names.end ())
+        {
+          name = names.insert (std::make_pair (i->first.first, GetHandlerName (*i->first.first))).first;
+        }
+      Accumulate (handlers[name->second], i->second);
+    }
+  return handlers;
+}
+
+std::map<uint32_t, EventProfiler::Entry>
+EventProfiler::GetContexts (void) const
+{
+  std::map<uint32_t, Entry> contexts;
+  for (std::unordered_map<Key, Entry, KeyHash>::const_iterator i = m_entries.begin ();
+       i != m_entries.end (); ++i)
+    {
+      Accumulate (contexts[i->first.second], i->second);
+    }
+  return contexts;
+}
+
+void
+EventProfiler::WriteJson (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  std::map<std::string, Entry> handlers = GetHandlers ();
+  std::vector<std::pair<std::string, Entry> > sorted (handlers.begin (), handlers.end ());
+  std::stable_sort (sorted.begin (), sorted.end (), &LongerThan<std::string>);
+
+  os << "{\n"
+     << " \"sample_period\" : " << m_period << ",\n"
+     << " \"events\" : " << m_events << ",\n"
+     << " \"samples\" : " << m_samples << ",\n"
+     << " \"handlers\" : [";
+  for (std::size_t i = 0; i < sorted.size (); ++i)
+    {
+      os << (i == 0 ? "\n" : ",\n") << "  { \"name\" : ";
+      WriteJsonString (os, sorted[i].first);
+      os << ", ";
+      WriteJsonEntry (os, sorted[i].second, GetScale ());
+      os << " }";
+    }
+  os << "\n ],\n"
+     << " \"contexts\" : [";
+  std::map<uint32_t, Entry> contexts = GetContexts ();
+  for (std::map<uint32_t, Entry>::const_iterator i = contexts.begin (); i != contexts.end (); ++i)
+    {
+      os << (i == contexts.begin () ? "\n" : ",\n") << "  { \"context\" : ";
+      if (i->first == 0xffffffff)
+        {
+          os << "null";
+        }
+      else
+        {
+          os << i->first;
+        }
+      os << ", ";
+      WriteJsonEntry (os, i->second, GetScale ());
+      os << " }";
+    }
+  os << "\n ]\n"
+     << "}" << std::endl;
+}
+
+void
+EventProfiler::WriteCollapsed (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  std::map<std::pair<std::string, std::string>, uint64_t> stacks;
+  double scale = GetScale ();
+  std::unordered_map<const std::type_info *, std::string> names;
+  for (std::unordered_map<Key, Entry, KeyHash>::const_iterator i = m_entries.begin ();
+       i != m_entries.end (); ++i)
+    {
+      std::unordered_map<const std::type_info *, std::string>::iterator name = names.find (i->first.first);
+      if (name == names.end ())
+        {
+          // Semicolons separate the frames of collapsed stacks.
+          std::string handler = GetHandlerName (*i->first.first);
+          std::replace (handler.begin (), handler.end (), ';', ':');
+          name = names.insert (std::make_pair (i->first.first, handler)).first;
+        }
+      stacks[std::make_pair (ContextName (i->first.second), name->second)] += static_cast<uint64_t> (i->second.nanoseconds * scale + 0.5);
+    }
+  for (std::map<std::pair<std::string, std::string>, uint64_t>::const_iterator i = stacks.begin ();
+       i != stacks.end (); ++i)
+    {
+      os << i->first.first << ";" << i->first.second << " " << i->second << "\n";
+    }
+  os.flush ();
+}
+
+void
+EventProfiler::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_filename.empty ())
+    {
+      std::ofstream os (m_filename.c_str ());
+      if (!os.is_open ())
+        {
+          NS_LOG_WARN ("Unable to open the event profile file " << m_filename);
+        }
+      else if (m_filename.size () >= 5 && m_filename.compare (m_filename.size () - 5, 5, ".json") == 0)
+        {
+          WriteJson (os);
+        }
+      else
+        {
+          WriteCollapsed (os);
+        }
+    }
+  Reset ();
+}
+
+void
+EventProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_countdown = NextInterval ();
+  m_events = 0;
+  m_samples = 0;
+  m_entries.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,258 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+/**
+ * @file
+ * @ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+#include "event-impl.h"
+#include "singleton.h"
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3 {
+
+/**
+ * @ingroup simulator
+ * @brief Wall-clock profile of the events executed by the simulator.
+ *
+ * Where DesMetrics records when each event is scheduled, the profiler
+ * measures the events when they are executed: for each event handler
+ * and each context (node), it counts the events and accumulates the
+ * wall-clock time spent in them.  This tells which handlers consume
+ * the run time of a simulation.
+ *
+ * Handlers are identified by the type of their event, i.e. for events
+ * made by Simulator::Schedule() and MakeEvent(), by the signature of
+ * the function or member function invoked: two member functions of a
+ * class with the same signature share an entry.
+ *
+ * To keep the overhead low, only one event out of \c period on
+ * average is timed, at random intervals so that the samples do not
+ * follow the periodic patterns of the simulation; the counts and
+ * times of the other events are estimated from these samples.  The
+ * events of the default, realtime and distributed simulator
+ * implementations are profiled.
+ *
+ * The profiler is enabled either from the program:
+ * \code
+ *   EventProfiler::Get ()->Enable (100, "profile.json");
+ * \endcode
+ * or, without changing the program, with the global values
+ * \c EventProfileFile and \c EventProfileSamplePeriod, e.g.
+ * \verbatim
+   $ ./waf --run "my-program --EventProfileFile=profile.txt" \endverbatim
+ * The profile is written to the file at Simulator::Destroy(): in JSON
+ * if the file name ends with \c .json, otherwise as collapsed stacks
+ * (one "context;handler nanoseconds" line per entry), which is the
+ * input format of flame graph tools such as \c flamegraph.pl.
+ */
+class EventProfiler : public Singleton<EventProfiler>
+{
+public:
+  /** Profile of a handler, or a context. */
+  struct Entry
+  {
+    uint64_t samples;         //!< Number of events timed.
+    uint64_t nanoseconds;     //!< Wall-clock time of the events timed.
+    uint64_t maxNanoseconds;  //!< Longest event timed.
+  };
+
+  EventProfiler ();
+
+  /**
+   * Start profiling.
+   *
+   * \param [in] period Time one event out of \p period on average.
+   * \param [in] filename The file to write the profile to at
+   *             Simulator::Destroy(), or empty for none.
+   */
+  void Enable (uint32_t period = 1, std::string filename = "");
+  /** Stop profiling; the profile is kept until Reset(). */
+  void Disable (void);
+  /**
+   * Check whether the events are profiled.
+   *
+   * \returns \c true if the profiler is enabled.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Enable the profiler if the EventProfileFile global value is set,
+   * and it is not already enabled.  Called by Simulator::Run().
+   */
+  void Configure (void);
+
+  /**
+   * Execute an event, and profile it if it is sampled.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+
+  /**
+   * Get the sampling period.
+   *
+   * \returns The sampling period.
+   */
+  uint32_t GetSamplePeriod (void) const;
+  /**
+   * Get the number of events executed while profiling.
+   *
+   * \returns The number of events.
+   */
+  uint64_t GetEventCount (void) const;
+  /**
+   * Get the number of events timed.
+   *
+   * \returns The number of samples.
+   */
+  uint64_t GetSampleCount (void) const;
+  /**
+   * Get the profile of each handler.
+   *
+   * \returns The profile, indexed by handler name.
+   */
+  std::map<std::string, Entry> GetHandlers (void) const;
+  /**
+   * Get the profile of each context.
+   *
+   * \returns The profile, indexed by context.
+   */
+  std::map<uint32_t, Entry> GetContexts (void) const;
+
+  /**
+   * Write the profile in JSON.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void WriteJson (std::ostream &os) const;
+  /**
+   * Write the profile as collapsed stacks, the estimated time of each
+   * handler in each context in nanoseconds.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void WriteCollapsed (std::ostream &os) const;
+  /**
+   * Write the profile to the file given to Enable(), if any, and
+   * reset it.  Called by Simulator::Destroy().
+   */
+  void Flush (void);
+  /** Discard the profile. */
+  void Reset (void);
+
+  /**
+   * Get the name of the handler of an event.
+   *
+   * \param [in] type The type of the event.
+   * \returns The handler name.
+   */
+  static std::string GetHandlerName (const std::type_info &type);
+
+private:
+  /**
+   * Time the execution of an event.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Sample (EventImpl *event, uint32_t context);
+  /**
+   * Get the number of events each sample stands for.
+   *
+   * \returns The number of events over the number of samples.
+   */
+  double GetScale (void) const;
+  /**
+   * Draw the number of events until the next sample.
+   *
+   * \returns A number between 1 and 2 * m_period - 1.
+   */
+  uint32_t NextInterval (void);
+
+  /** A handler in a context. */
+  typedef std::pair<const std::type_info *, uint32_t> Key;
+  /** Hash of a Key. */
+  struct KeyHash
+  {
+    /**
+     * Hash a key.
+     * \param [in] key The key.
+     * \returns The hash.
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      return std::hash<const void *> () (key.first) ^ (static_cast<std::size_t> (key.second) * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+
+  /** Whether the profiler is enabled. */
+  static bool m_enabled;
+  /** The sampling period. */
+  uint32_t m_period;
+  /** The number of events left until the next sample. */
+  uint32_t m_countdown;
+  /** State of the generator of the sampling intervals. */
+  uint32_t m_random;
+  /** The number of events executed. */
+  uint64_t m_events;
+  /** The number of events timed. */
+  uint64_t m_samples;
+  /** The file to write at Simulator::Destroy(). */
+  std::string m_filename;
+  /** The profile of each handler in each context. */
+  std::unordered_map<Key, Entry, KeyHash> m_entries;
+
+};  // class EventProfiler
+
+
+/****************************************************************
+ *  Implementation of the inline functions.
+ ****************************************************************/
+
+inline bool
+EventProfiler::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+inline void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  ++m_events;
+  if (--m_countdown != 0)
+    {
+      event->Invoke ();
+      return;
+    }
+  Sample (event, context);
+}
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
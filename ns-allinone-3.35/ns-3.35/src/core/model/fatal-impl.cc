@@ -149,6 +149,8 @@ void
 FlushStreams (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  /* Format the deferred log messages, which lead to the error. */
+  LogBufferFlush ();
   std::list<std::ostream*> **pl = PeekStreamList ();
   if (*pl == 0)
     {
@@ -78,7 +78,8 @@ void UnregisterStream (std::ostream* stream);
  *
  * \brief Flush all currently registered streams.
  *
- * This function iterates through each registered stream and
+ * This function formats the log messages deferred by the log buffer,
+ * if any, then iterates through each registered stream and
  * unregisters them. The default \c SIGSEGV handler is overridden
  * when this function is being executed, and will be restored
  * when this function returns.
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "type-id.h"
+#include "uinteger.h"
+#include <algorithm>
+#include <functional>
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("ThresholdSize",
+                   "Number of events in a bucket above which the bucket "
+                   "is spawned into a new rung instead of being sorted",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs in the ladder",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::SetMaxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_qSize (0),
+    m_threshold (50)
+{
+  NS_LOG_FUNCTION (this);
+  SetMaxRungs (8);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::SetMaxRungs (uint32_t maxRungs)
+{
+  NS_LOG_FUNCTION (this << maxRungs);
+  NS_ASSERT_MSG (m_nRungs == 0, "MaxRungs can only be set at construction");
+  // The rungs are never reallocated afterwards, so references
+  // to them stay valid while spawning new rungs.
+  m_rungs.resize (maxRungs);
+}
+
+uint64_t
+LadderScheduler::CurrentStart (const Rung &rung) const
+{
+  return rung.start + rung.current * rung.width;
+}
+
+void
+LadderScheduler::SpawnRung (uint64_t start, uint64_t limit, const Bucket &events)
+{
+  NS_LOG_FUNCTION (this << start << limit << events.size ());
+  NS_ASSERT (m_nRungs < m_rungs.size ());
+  NS_ASSERT (!events.empty () && start <= limit);
+
+  Rung &rung = m_rungs[m_nRungs];
+  ++m_nRungs;
+  rung.start = start;
+  rung.width = (limit - start) / events.size () + 1;
+  rung.nBuckets = static_cast<uint32_t> ((limit - start) / rung.width + 1);
+  rung.current = 0;
+  rung.count = static_cast<uint32_t> (events.size ());
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      NS_ASSERT (i->key.m_ts >= start && i->key.m_ts <= limit);
+      rung.buckets[(i->key.m_ts - start) / rung.width].push_back (*i);
+    }
+  NS_LOG_LOGIC ("rung " << m_nRungs - 1 << " start=" << rung.start <<
+                " width=" << rung.width << " buckets=" << rung.nBuckets);
+}
+
+void
+LadderScheduler::InsertBottom (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  Bucket::iterator pos = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev,
+                                           std::greater<Scheduler::Event> ());
+  m_bottom.insert (pos, ev);
+
+  // If Bottom grows too large, move it into a new rung, unless
+  // it only holds simultaneous events which no rung could split.
+  if (m_bottom.size () > m_threshold
+      && m_nRungs < m_rungs.size ()
+      && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+    {
+      uint64_t limit = m_nRungs > 0 ? CurrentStart (m_rungs[m_nRungs - 1]) : m_topStart;
+      SpawnRung (m_bottom.back ().key.m_ts, limit - 1, m_bottom);
+      m_bottom.clear ();
+    }
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty () && m_qSize > 0)
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          NS_LOG_LOGIC ("transfer " << m_top.size () << " events from top");
+          m_topStart = m_topMax + 1;
+          if (m_top.size () > m_threshold && m_topMin != m_topMax)
+            {
+              SpawnRung (m_topMin, m_topMax, m_top);
+            }
+          else
+            {
+              m_bottom.swap (m_top);
+              std::sort (m_bottom.begin (), m_bottom.end (),
+                         std::greater<Scheduler::Event> ());
+            }
+          m_top.clear ();
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.count == 0)
+        {
+          --m_nRungs;
+          continue;
+        }
+      while (rung.buckets[rung.current].empty ())
+        {
+          ++rung.current;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t bucketStart = CurrentStart (rung);
+      ++rung.current;
+      rung.count -= static_cast<uint32_t> (bucket.size ());
+      if (bucket.size () > m_threshold
+          && rung.width > 1
+          && m_nRungs < m_rungs.size ())
+        {
+          SpawnRung (bucketStart, bucketStart + rung.width - 1, bucket);
+        }
+      else
+        {
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (),
+                     std::greater<Scheduler::Event> ());
+        }
+      bucket.clear ();
+    }
+}
+
+void
+LadderScheduler::Insert (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  ++m_qSize;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+      FillBottom ();
+      return;
+    }
+  for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= CurrentStart (rung))
+        {
+          uint64_t index = (ts - rung.start) / rung.width;
+          NS_ASSERT (index < rung.nBuckets);
+          rung.buckets[index].push_back (ev);
+          ++rung.count;
+          return;
+        }
+    }
+  InsertBottom (ev);
+  FillBottom ();
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  --m_qSize;
+  FillBottom ();
+  NS_LOG_DEBUG ("remove ts=" << ev.key.m_ts <<
+                ", key=" << ev.key.m_uid <<
+                ", from bottom");
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Scheduler::Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  Bucket *bucket = 0;
+  if (ts >= m_topStart)
+    {
+      // m_topMin and m_topMax are left untouched: they remain valid bounds.
+      bucket = &m_top;
+    }
+  else
+    {
+      for (uint32_t i = 0; i < m_nRungs; ++i)
+        {
+          Rung &rung = m_rungs[i];
+          if (ts >= CurrentStart (rung))
+            {
+              bucket = &rung.buckets[(ts - rung.start) / rung.width];
+              --rung.count;
+              break;
+            }
+        }
+    }
+
+  if (bucket != 0)
+    {
+      Bucket::iterator i = std::find (bucket->begin (), bucket->end (), ev);
+      NS_ASSERT (i != bucket->end ());
+      *i = bucket->back ();
+      bucket->pop_back ();
+    }
+  else
+    {
+      Bucket::iterator i = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev,
+                                             std::greater<Scheduler::Event> ());
+      NS_ASSERT (i != m_bottom.end () && *i == ev);
+      m_bottom.erase (i);
+    }
+  --m_qSize;
+  FillBottom ();
+}
+
+} // namespace ns3
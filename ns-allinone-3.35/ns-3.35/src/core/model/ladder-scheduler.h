@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the Ladder Queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh
+ * and Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The event list is split in three tiers:
+ *
+ * - **Top**: an unsorted `std::vector` holding all the events
+ *   at or after \c m_topStart, i.e. the far future.
+ *   Insertion is a simple append.
+ * - **Ladder**: up to \c MaxRungs rungs of buckets.  Each rung
+ *   covers a contiguous time span with buckets of uniform width,
+ *   and each deeper rung refines a single bucket of the rung above it.
+ *   Buckets are unsorted `std::vector`s.
+ * - **Bottom**: a short `std::vector` sorted in decreasing order,
+ *   holding the earliest events.  RemoveNext() pops its last element.
+ *
+ * When Bottom empties the next non-empty bucket of the deepest rung
+ * is moved into it and sorted.  A bucket holding more than
+ * \c ThresholdSize events is instead spawned into a new, finer,
+ * rung.  When the Ladder empties the whole Top is moved into a
+ * new first rung.  Events are therefore sorted only once they
+ * are close to being executed, and only in small batches,
+ * which makes Insert() and RemoveNext() amortized constant time
+ * independently of the distribution of event time stamps.
+ *
+ * This queue is typically well suited to models scheduling bursts
+ * of events slightly in the future, such as per-slot or per-symbol
+ * PHY processing.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to a bucket; insertion in Bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Last element of Bottom
+ * Remove()     | Linear in tier  | Search within Top or a bucket
+ * RemoveNext() | ~Constant       | Bucket transfer and sort of Bottom
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x `sizeof (*)` per bucket      | `std::vector` per bucket
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Ladder bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder. */
+  struct Rung
+  {
+    uint64_t start;               /**< Time stamp of the first bucket. */
+    uint64_t width;               /**< Bucket width, in dimensionless time units. */
+    uint32_t nBuckets;            /**< Number of buckets in use. */
+    uint32_t current;             /**< Index of the next bucket to be dequeued. */
+    uint32_t count;               /**< Number of events stored in this rung. */
+    std::vector<Bucket> buckets;  /**< The buckets. */
+  };
+
+  /**
+   * Set the maximum number of rungs in the ladder.
+   *
+   * This can only be used at construction, as invoked by the
+   * Attribute MaxRungs.
+   *
+   * \param [in] maxRungs The maximum number of rungs.
+   */
+  void SetMaxRungs (uint32_t maxRungs);
+  /**
+   * Get the time stamp of the current bucket of a rung.
+   *
+   * Events at or after this time stamp and before the current bucket
+   * of the rung above belong to this rung.
+   *
+   * \param [in] rung The rung.
+   * \returns The start of the current bucket.
+   */
+  inline uint64_t CurrentStart (const Rung &rung) const;
+  /**
+   * Create a new deepest rung covering the span [\p start, \p limit]
+   * and distribute \p events into its buckets.
+   *
+   * \param [in] start The first time stamp covered by the new rung.
+   * \param [in] limit The last time stamp covered by the new rung.
+   * \param [in] events The events to distribute.
+   */
+  void SpawnRung (uint64_t start, uint64_t limit, const Bucket &events);
+  /**
+   * Insert an event into Bottom, keeping it sorted.
+   *
+   * \param [in] ev The new Event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /** Move the earliest events into Bottom, if it is empty. */
+  void FillBottom (void);
+
+  /** Unsorted far-future events. */
+  Bucket m_top;
+  /** Smallest time stamp in Top. */
+  uint64_t m_topMin;
+  /** Largest time stamp in Top. */
+  uint64_t m_topMax;
+  /** Events at or after this time stamp are stored in Top. */
+  uint64_t m_topStart;
+  /** The rungs; only the first \c m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted in decreasing order. */
+  Bucket m_bottom;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+  /**
+   * Bucket size above which a bucket is spawned into a new rung
+   * rather than sorted into Bottom.
+   */
+  uint32_t m_threshold;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -165,6 +165,23 @@
 #define NS_LOG_CONDITION
 #endif
 
+/**
+ * \ingroup logging
+ * Check if the log statements of a level are compiled in the log
+ * component of the file, as selected by the \c --log-allow
+ * configuration option.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ *
+ * \param [in] level The log level.
+ */
+#ifdef NS3_LOG_ALLOW
+#define NS_LOG_ALLOWED(level)                                   \
+  ((g_logAllowedLevels (0) & (level)) != 0)
+#else
+#define NS_LOG_ALLOWED(level)  true
+#endif
+
 /**
  * \ingroup logging
  *
@@ -179,6 +196,9 @@
  * NS_LOG (LOG_DEBUG, "a number="<<aNumber<<", anotherNumber="<<anotherNumber);
  * \endcode
  *
+ * The message is written to a LogStream, which defers its formatting
+ * when a log buffer is enabled (see LogBufferEnable()).
+ *
  * \param [in] level The log level
  * \param [in] msg The message to log
  * \internal
@@ -187,14 +207,18 @@
 #define NS_LOG(level, msg)                                      \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (level))                              \
+      if constexpr (NS_LOG_ALLOWED (level))                     \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          NS_LOG_APPEND_FUNC_PREFIX;                            \
-          NS_LOG_APPEND_LEVEL_PREFIX (level);                   \
-          std::clog << msg << std::endl;                        \
+          if (g_log.IsEnabled (level))                          \
+            {                                                   \
+              ns3::LogStream ns3LogStream (g_log);              \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              NS_LOG_APPEND_FUNC_PREFIX;                        \
+              NS_LOG_APPEND_LEVEL_PREFIX (level);               \
+              ns3LogStream << msg << std::endl;                 \
+            }                                                   \
         }                                                       \
     } while (false)
 
@@ -209,13 +233,17 @@
 #define NS_LOG_FUNCTION_NOARGS()                                \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if constexpr (NS_LOG_ALLOWED (ns3::LOG_FUNCTION))         \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "()" << std::endl;       \
+          if (g_log.IsEnabled (ns3::LOG_FUNCTION))              \
+            {                                                   \
+              ns3::LogStream ns3LogStream (g_log);              \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              ns3LogStream << g_log.Name () << ":"              \
+                           << __FUNCTION__ << "()" << std::endl; \
+            }                                                   \
         }                                                       \
     } while (false)
 
@@ -245,15 +273,19 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if constexpr (NS_LOG_ALLOWED (ns3::LOG_FUNCTION))         \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "(";                     \
-          ns3::ParameterLogger (std::clog) << parameters;       \
-          std::clog << ")" << std::endl;                        \
+          if (g_log.IsEnabled (ns3::LOG_FUNCTION))              \
+            {                                                   \
+              ns3::LogStream ns3LogStream (g_log);              \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              ns3LogStream << g_log.Name () << ":"              \
+                           << __FUNCTION__ << "(";              \
+              ns3::LogParameterStream (ns3LogStream) << parameters; \
+              ns3LogStream << ")" << std::endl;                 \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -27,8 +27,11 @@
 #include "ns3/core-config.h"
 #include "fatal-error.h"
 
-#include <cstdlib>    // getenv
-#include <cstring>    // strlen
+#include <algorithm>
+#include <iomanip>
+#include <string_view>
+#include <cstdlib>    // getenv, atexit
+#include <cstring>    // strlen, memcpy
 
 /**
  * \file
@@ -51,10 +54,227 @@ static TimePrinter g_logTimePrinter = 0;
  */
 static NodePrinter g_logNodePrinter = 0;
 
+/**
+ * \ingroup logging
+ * The bytes and log statements written by a log component.
+ * This is private to the logging implementation.
+ */
+struct LogCounters
+{
+  std::string name;     //!< The log component name.
+  uint64_t bytes;       //!< The bytes written.
+  uint64_t statements;  //!< The log statements written.
+};
+
+/**
+ * \ingroup logging
+ * Get the counters of the log components, by LogComponent index.
+ * This is private to the logging implementation.
+ *
+ * The first counters are those of the bytes written outside of the
+ * log statements.  The counters are never deleted, since the log
+ * buffer can be flushed at exit, after the log components.
+ *
+ * \returns The counters.
+ */
+static std::vector<LogCounters> *
+GetLogCounters (void)
+{
+  static std::vector<LogCounters> *counters =
+    new std::vector<LogCounters> (1, LogCounters {"(none)", 0, 0});
+  return counters;
+}
+
+namespace {
+
+/**
+ * \ingroup logging
+ * A stream buffer counting the bytes written by each log component.
+ * This is private to the logging implementation.
+ */
+class LogCounter : public std::streambuf
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] output The stream buffer to write to.
+   */
+  LogCounter (std::streambuf *output);
+  /**
+   * Start a log statement.
+   *
+   * \param [in] component The index of the LogComponent of the statement.
+   * \returns The index of the LogComponent of the enclosing statement.
+   */
+  uint32_t Begin (uint32_t component);
+  /**
+   * End a log statement.
+   *
+   * \param [in] previous The index of the LogComponent of the enclosing statement.
+   */
+  void End (uint32_t previous);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  virtual int sync (void);
+
+private:
+  std::streambuf *m_output;  //!< The stream buffer to write to.
+  uint32_t m_component;      //!< The LogComponent writing.
+};
+
+/**
+ * \ingroup logging
+ * A stream buffer recording the log statements in binary form, to
+ * format them later.
+ * This is private to the logging implementation.
+ *
+ * The text written to \c std::clog, such as the prefixes of the log
+ * statements, is recorded as is.  The values of the fundamental types
+ * and the strings written to a LogStream are recorded with a one byte
+ * tag of their type, along with the format state of \c std::clog
+ * whenever it changes, so that their replay gives the text they would
+ * have had.
+ */
+class LogBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] capacity The number of bytes which triggers a flush.
+   */
+  LogBuffer (std::size_t capacity);
+  /**
+   * Set the number of bytes which triggers a flush.
+   *
+   * \param [in] capacity The number of bytes.
+   */
+  void SetCapacity (std::size_t capacity);
+  /**
+   * Set where the log statements are formatted.
+   *
+   * \param [in] output The stream buffer to format to.
+   * \param [in] counter The counter of \c output, if any.
+   */
+  void SetOutput (std::streambuf *output, LogCounter *counter);
+  /**
+   * Start a log statement.
+   *
+   * \param [in] component The index of the LogComponent of the statement.
+   * \returns The index of the LogComponent of the enclosing statement.
+   */
+  uint32_t Begin (uint32_t component);
+  /**
+   * End a log statement, and flush the buffer if it is full.
+   *
+   * \param [in] previous The index of the LogComponent of the enclosing statement.
+   */
+  void End (uint32_t previous);
+  /**
+   * Record a value.
+   *
+   * \param [in] tag The type of the value.
+   * \param [in] value The bytes of the value.
+   * \param [in] size The number of bytes.
+   */
+  void Record (char tag, const void *value, std::size_t size);
+  /**
+   * Record a string value.
+   *
+   * \param [in] value The characters of the string.
+   * \param [in] size The number of characters.
+   */
+  void RecordString (const char *value, std::size_t size);
+  /**
+   * Record text, such as the new line of std::endl.
+   *
+   * \param [in] text The characters of the text.
+   * \param [in] size The number of characters.
+   */
+  void RecordText (const char *text, std::size_t size);
+  /** Format the recorded log statements. */
+  void Flush (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  virtual int sync (void);
+
+private:
+  /**
+   * Append bytes to the records.
+   *
+   * \param [in] bytes The bytes.
+   * \param [in] size The number of bytes.
+   */
+  void Append (const void *bytes, std::size_t size);
+  /**
+   * Start a record, after the format state of \c std::clog,
+   * if it changed.
+   *
+   * \param [in] tag The type of the record.
+   */
+  void Start (char tag);
+  /**
+   * Read a value of the records.
+   *
+   * \tparam T \explicit The type of the value.
+   * \param [in,out] offset The offset of the value, moved past it.
+   * \returns The value.
+   */
+  template <typename T>
+  T Read (std::size_t &offset) const;
+
+  std::vector<char> m_records;  //!< The records.
+  std::size_t m_capacity;       //!< The number of bytes which triggers a flush.
+  std::size_t m_text;           //!< Offset of the size of the last record, if it is text, else 0.
+  uint32_t m_component;         //!< The LogComponent recording.
+  uint32_t m_depth;             //!< The number of log statements recording.
+  bool m_flushing;              //!< Whether the buffer is being flushed.
+  std::ios_base::fmtflags m_flags;  //!< The format flags of the records.
+  std::streamsize m_precision;  //!< The precision of the records.
+  std::streamsize m_width;      //!< The field width of the records.
+  char m_fill;                  //!< The fill character of the records.
+  LogCounter *m_counter;        //!< The counter of the output, if any.
+  std::ostream m_replay;        //!< The stream formatting the records.
+};
+
+} // unnamed namespace
+
+/**
+ * \ingroup logging
+ * The stream buffer of \c std::clog before the log buffer or the
+ * log counter replaced it.
+ * This is private to the logging implementation.
+ */
+static std::streambuf *g_logOutput = 0;
+/**
+ * \ingroup logging
+ * The log counter, if the report is enabled.
+ * This is private to the logging implementation.
+ */
+static LogCounter *g_logCounter = 0;
+/**
+ * \ingroup logging
+ * The log buffer, if enabled.
+ * This is private to the logging implementation.
+ */
+static LogBuffer *g_logBuffer = 0;
+/**
+ * \ingroup logging
+ * Whether to print the log report at exit.
+ * This is private to the logging implementation.
+ */
+static bool g_logReportAtExit = false;
+
 /**
  * \ingroup logging
  * Handler for \c print-list token in NS_LOG
- * to print the list of log components.
+ * to print the list of log components, and for the \c buffer and
+ * \c report tokens to enable the log buffer and the log report.
  * This is private to the logging implementation.
  */
 class PrintList
@@ -99,6 +319,15 @@ PrintList::PrintList ()
           exit (0);
           break;
         }
+      else if (tmp == "buffer")
+        {
+          LogBufferEnable ();
+        }
+      else if (tmp == "report")
+        {
+          LogReportEnable ();
+          g_logReportAtExit = true;
+        }
       cur = next + 1;
     }
 }
@@ -107,7 +336,8 @@ PrintList::PrintList ()
 LogComponent::LogComponent (const std::string & name,
                             const std::string & file,
                             const enum LogLevel mask /* = 0 */)
-  : m_levels (0), m_mask (mask), m_name (name), m_file (file)
+  : m_levels (0), m_mask (mask), m_name (name), m_file (file),
+    m_index (GetLogCounters ()->size ())
 {
   EnvVarCheck ();
 
@@ -122,6 +352,7 @@ LogComponent::LogComponent (const std::string & name,
         }
     }
   components->insert (std::make_pair (name, this));
+  GetLogCounters ()->push_back (LogCounters {name, 0, 0});
 }
 
 LogComponent &
@@ -551,6 +782,10 @@ static void CheckEnvironmentVariables (void)
             {
               return;
             }
+          else if (component == "buffer" || component == "report")
+            {
+              // handled by PrintList
+            }
           else
             {
               LogComponentPrintList ();
@@ -702,4 +937,659 @@ ParameterLogger::operator<< <uint8_t> (const uint8_t param)
   return *this;
 }
 
+namespace {
+
+LogCounter::LogCounter (std::streambuf *output)
+  : m_output (output),
+    m_component (0)
+{}
+
+uint32_t
+LogCounter::Begin (uint32_t component)
+{
+  uint32_t previous = m_component;
+  m_component = component;
+  (*GetLogCounters ())[component].statements++;
+  return previous;
+}
+
+void
+LogCounter::End (uint32_t previous)
+{
+  m_component = previous;
+}
+
+LogCounter::int_type
+LogCounter::overflow (int_type c)
+{
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  (*GetLogCounters ())[m_component].bytes++;
+  return m_output->sputc (traits_type::to_char_type (c));
+}
+
+std::streamsize
+LogCounter::xsputn (const char *s, std::streamsize n)
+{
+  std::streamsize written = m_output->sputn (s, n);
+  (*GetLogCounters ())[m_component].bytes += written;
+  return written;
+}
+
+int
+LogCounter::sync (void)
+{
+  return m_output->pubsync ();
+}
+
+
+LogBuffer::LogBuffer (std::size_t capacity)
+  : m_capacity (capacity),
+    m_text (0),
+    m_component (0),
+    m_depth (0),
+    m_flushing (false),
+    m_flags (std::clog.flags ()),
+    m_precision (std::clog.precision ()),
+    m_width (std::clog.width ()),
+    m_fill (std::clog.fill ()),
+    m_counter (0),
+    m_replay (0)
+{
+  m_replay.copyfmt (std::clog);
+  m_records.reserve (capacity);
+}
+
+void
+LogBuffer::SetCapacity (std::size_t capacity)
+{
+  m_capacity = capacity;
+  m_records.reserve (capacity);
+}
+
+void
+LogBuffer::SetOutput (std::streambuf *output, LogCounter *counter)
+{
+  m_replay.rdbuf (output);
+  m_counter = counter;
+}
+
+uint32_t
+LogBuffer::Begin (uint32_t component)
+{
+  uint32_t previous = m_component;
+  m_component = component;
+  m_depth++;
+  m_text = 0;
+  m_records.push_back ('B');
+  Append (&component, sizeof (component));
+  return previous;
+}
+
+void
+LogBuffer::End (uint32_t previous)
+{
+  m_component = previous;
+  m_depth--;
+  m_text = 0;
+  m_records.push_back ('E');
+  Append (&previous, sizeof (previous));
+  if (m_depth == 0 && m_records.size () >= m_capacity)
+    {
+      Flush ();
+    }
+}
+
+void
+LogBuffer::Append (const void *bytes, std::size_t size)
+{
+  const char *begin = static_cast<const char *> (bytes);
+  m_records.insert (m_records.end (), begin, begin + size);
+}
+
+void
+LogBuffer::Start (char tag)
+{
+  if (std::clog.flags () != m_flags
+      || std::clog.precision () != m_precision
+      || std::clog.width () != m_width
+      || std::clog.fill () != m_fill)
+    {
+      m_flags = std::clog.flags ();
+      m_precision = std::clog.precision ();
+      m_width = std::clog.width ();
+      m_fill = std::clog.fill ();
+      m_records.push_back ('F');
+      Append (&m_flags, sizeof (m_flags));
+      Append (&m_precision, sizeof (m_precision));
+      Append (&m_width, sizeof (m_width));
+      Append (&m_fill, sizeof (m_fill));
+    }
+  m_text = 0;
+  m_records.push_back (tag);
+}
+
+void
+LogBuffer::Record (char tag, const void *value, std::size_t size)
+{
+  Start (tag);
+  Append (value, size);
+  if (tag != 'm')
+    {
+      // The value uses the field width, as it will when formatted.
+      std::clog.width (0);
+      m_width = 0;
+    }
+}
+
+void
+LogBuffer::RecordString (const char *value, std::size_t size)
+{
+  Start ('x');
+  uint32_t length = size;
+  Append (&length, sizeof (length));
+  Append (value, size);
+  std::clog.width (0);
+  m_width = 0;
+}
+
+void
+LogBuffer::RecordText (const char *text, std::size_t size)
+{
+  if (m_text == 0)
+    {
+      m_records.push_back ('T');
+      m_text = m_records.size ();
+      uint32_t length = 0;
+      Append (&length, sizeof (length));
+    }
+  uint32_t length;
+  std::memcpy (&length, &m_records[m_text], sizeof (length));
+  length += size;
+  std::memcpy (&m_records[m_text], &length, sizeof (length));
+  Append (text, size);
+}
+
+LogBuffer::int_type
+LogBuffer::overflow (int_type c)
+{
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  char text = traits_type::to_char_type (c);
+  RecordText (&text, 1);
+  if (m_depth == 0 && m_records.size () >= m_capacity)
+    {
+      Flush ();
+    }
+  return c;
+}
+
+std::streamsize
+LogBuffer::xsputn (const char *s, std::streamsize n)
+{
+  RecordText (s, n);
+  if (m_depth == 0 && m_records.size () >= m_capacity)
+    {
+      Flush ();
+    }
+  return n;
+}
+
+int
+LogBuffer::sync (void)
+{
+  // std::endl and std::flush are deferred to the next Flush ().
+  return 0;
+}
+
+template <typename T>
+T
+LogBuffer::Read (std::size_t &offset) const
+{
+  T value;
+  std::memcpy (&value, &m_records[offset], sizeof (value));
+  offset += sizeof (value);
+  return value;
+}
+
+void
+LogBuffer::Flush (void)
+{
+  if (m_flushing || m_records.empty ())
+    {
+      return;
+    }
+  m_flushing = true;
+  std::size_t i = 0;
+  while (i < m_records.size ())
+    {
+      char tag = m_records[i++];
+      switch (tag)
+        {
+        case 'T':
+          {
+            uint32_t length = Read<uint32_t> (i);
+            m_replay.write (&m_records[i], length);
+            i += length;
+            break;
+          }
+        case 'x':
+          {
+            uint32_t length = Read<uint32_t> (i);
+            m_replay << std::string_view (&m_records[i], length);
+            i += length;
+            break;
+          }
+        case 'B':
+          {
+            uint32_t component = Read<uint32_t> (i);
+            if (m_counter != 0)
+              {
+                m_counter->Begin (component);
+              }
+            break;
+          }
+        case 'E':
+          {
+            uint32_t previous = Read<uint32_t> (i);
+            if (m_counter != 0)
+              {
+                m_counter->End (previous);
+              }
+            break;
+          }
+        case 'F':
+          m_replay.flags (Read<std::ios_base::fmtflags> (i));
+          m_replay.precision (Read<std::streamsize> (i));
+          m_replay.width (Read<std::streamsize> (i));
+          m_replay.fill (Read<char> (i));
+          break;
+        case 'm':
+          Read<std::ostream & (*)(std::ostream &)> (i) (m_replay);
+          break;
+        case 'b':
+          m_replay << Read<bool> (i);
+          break;
+        case 'c':
+          m_replay << Read<char> (i);
+          break;
+        case 'a':
+          m_replay << Read<signed char> (i);
+          break;
+        case 'A':
+          m_replay << Read<unsigned char> (i);
+          break;
+        case 's':
+          m_replay << Read<short> (i);
+          break;
+        case 'S':
+          m_replay << Read<unsigned short> (i);
+          break;
+        case 'i':
+          m_replay << Read<int> (i);
+          break;
+        case 'I':
+          m_replay << Read<unsigned int> (i);
+          break;
+        case 'l':
+          m_replay << Read<long> (i);
+          break;
+        case 'L':
+          m_replay << Read<unsigned long> (i);
+          break;
+        case 'q':
+          m_replay << Read<long long> (i);
+          break;
+        case 'Q':
+          m_replay << Read<unsigned long long> (i);
+          break;
+        case 'f':
+          m_replay << Read<float> (i);
+          break;
+        case 'd':
+          m_replay << Read<double> (i);
+          break;
+        case 'e':
+          m_replay << Read<long double> (i);
+          break;
+        case 'p':
+          m_replay << Read<const void *> (i);
+          break;
+        default:
+          // Not reached: the records are only written by this class.
+          i = m_records.size ();
+          break;
+        }
+    }
+  m_records.clear ();
+  m_text = 0;
+  m_replay.flush ();
+  m_flushing = false;
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup logging
+ * Route \c std::clog through the log buffer and the log counter,
+ * if they are enabled.
+ * This is private to the logging implementation.
+ */
+static void
+LogSetOutputs (void)
+{
+  if (g_logOutput == 0)
+    {
+      g_logOutput = std::clog.rdbuf ();
+    }
+  std::streambuf *output = g_logOutput;
+  if (g_logCounter != 0)
+    {
+      output = g_logCounter;
+    }
+  if (g_logBuffer != 0)
+    {
+      g_logBuffer->SetOutput (output, g_logCounter);
+      output = g_logBuffer;
+    }
+  std::clog.rdbuf (output);
+  if (g_logCounter == 0 && g_logBuffer == 0)
+    {
+      g_logOutput = 0;
+    }
+}
+
+/**
+ * \ingroup logging
+ * Flush the log buffer, and print the log report if requested, at exit.
+ * This is private to the logging implementation.
+ */
+static void
+LogAtExit (void)
+{
+  LogBufferDisable ();
+  if (g_logReportAtExit)
+    {
+      LogComponentPrintReport (std::cerr);
+    }
+  LogReportDisable ();
+}
+
+/**
+ * \ingroup logging
+ * Register LogAtExit(), once.
+ * This is private to the logging implementation.
+ */
+static void
+LogRegisterAtExit (void)
+{
+  static bool registered = false;
+  if (!registered)
+    {
+      std::atexit (&LogAtExit);
+      registered = true;
+    }
+}
+
+void
+LogBufferEnable (std::size_t size)
+{
+  if (g_logBuffer != 0)
+    {
+      g_logBuffer->Flush ();
+      g_logBuffer->SetCapacity (size);
+      return;
+    }
+  g_logBuffer = new LogBuffer (size);
+  LogSetOutputs ();
+  LogRegisterAtExit ();
+}
+
+void
+LogBufferDisable (void)
+{
+  if (g_logBuffer == 0)
+    {
+      return;
+    }
+  g_logBuffer->Flush ();
+  LogBuffer *buffer = g_logBuffer;
+  g_logBuffer = 0;
+  LogSetOutputs ();
+  delete buffer;
+}
+
+void
+LogBufferFlush (void)
+{
+  if (g_logBuffer != 0)
+    {
+      g_logBuffer->Flush ();
+    }
+}
+
+void
+LogReportEnable (void)
+{
+  if (g_logCounter != 0)
+    {
+      return;
+    }
+  if (g_logBuffer != 0)
+    {
+      // Count the statements recorded so far with their output.
+      g_logBuffer->Flush ();
+    }
+  if (g_logOutput == 0)
+    {
+      g_logOutput = std::clog.rdbuf ();
+    }
+  g_logCounter = new LogCounter (g_logOutput);
+  LogSetOutputs ();
+  LogRegisterAtExit ();
+}
+
+void
+LogReportDisable (void)
+{
+  if (g_logCounter == 0)
+    {
+      return;
+    }
+  LogBufferFlush ();
+  LogCounter *counter = g_logCounter;
+  g_logCounter = 0;
+  LogSetOutputs ();
+  delete counter;
+}
+
+void
+LogComponentPrintReport (std::ostream &os)
+{
+  LogBufferFlush ();
+  std::vector<LogCounters> counters (*GetLogCounters ());
+  std::stable_sort (counters.begin (), counters.end (),
+                    [] (const LogCounters &a, const LogCounters &b)
+                    {
+                      return a.bytes > b.bytes;
+                    });
+  uint64_t bytes = 0;
+  uint64_t statements = 0;
+  for (const LogCounters &c : counters)
+    {
+      bytes += c.bytes;
+      statements += c.statements;
+    }
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "Log report: " << bytes << " bytes in " << statements << " statements" << std::endl;
+  os << std::setw (14) << "bytes" << std::setw (8) << "%"
+     << std::setw (12) << "statements" << "  component" << std::endl;
+  for (const LogCounters &c : counters)
+    {
+      if (c.bytes == 0 && c.statements == 0)
+        {
+          continue;
+        }
+      os << std::setw (14) << c.bytes
+         << std::setw (8) << std::fixed << std::setprecision (1)
+         << (bytes == 0 ? 0.0 : 100.0 * c.bytes / bytes)
+         << std::setw (12) << c.statements
+         << "  " << c.name << std::endl;
+    }
+  os.flags (flags);
+}
+
+
+LogStream::LogStream (const LogComponent &component)
+  : m_buffered (g_logBuffer != 0),
+    m_previous (0)
+{
+  if (m_buffered)
+    {
+      m_previous = g_logBuffer->Begin (component.m_index);
+    }
+  else if (g_logCounter != 0)
+    {
+      m_previous = g_logCounter->Begin (component.m_index);
+    }
+}
+
+LogStream::~LogStream ()
+{
+  if (m_buffered)
+    {
+      if (g_logBuffer != 0)
+        {
+          g_logBuffer->End (m_previous);
+        }
+    }
+  else if (g_logCounter != 0)
+    {
+      g_logCounter->End (m_previous);
+    }
+}
+
+void
+LogStream::Record (char tag, const void *value, std::size_t size)
+{
+  if (g_logBuffer != 0)
+    {
+      g_logBuffer->Record (tag, value, size);
+    }
+}
+
+LogStream &
+LogStream::operator<< (const char *value)
+{
+  if (m_buffered && g_logBuffer != 0 && value != 0)
+    {
+      g_logBuffer->RecordString (value, std::strlen (value));
+    }
+  else
+    {
+      std::clog << value;
+    }
+  return *this;
+}
+
+LogStream &
+LogStream::operator<< (const std::string &value)
+{
+  if (m_buffered && g_logBuffer != 0)
+    {
+      g_logBuffer->RecordString (value.data (), value.size ());
+    }
+  else
+    {
+      std::clog << value;
+    }
+  return *this;
+}
+
+LogStream &
+LogStream::operator<< (std::ostream & (*manipulator)(std::ostream &))
+{
+  typedef std::ostream & (*Manipulator)(std::ostream &);
+  if (!m_buffered || g_logBuffer == 0)
+    {
+      manipulator (std::clog);
+    }
+  else if (manipulator == static_cast<Manipulator> (std::endl))
+    {
+      // The buffer is flushed as a whole.
+      g_logBuffer->RecordText ("\n", 1);
+    }
+  else if (manipulator == static_cast<Manipulator> (std::ends))
+    {
+      g_logBuffer->RecordText ("", 1);
+    }
+  else if (manipulator != static_cast<Manipulator> (std::flush))
+    {
+      g_logBuffer->Record ('m', &manipulator, sizeof (manipulator));
+    }
+  return *this;
+}
+
+LogStream &
+LogStream::operator<< (std::ios_base & (*manipulator)(std::ios_base &))
+{
+  // The format state of std::clog is recorded with the next value.
+  manipulator (std::clog);
+  return *this;
+}
+
+
+LogParameterStream::LogParameterStream (LogStream &stream)
+  : m_first (true),
+    m_stream (stream)
+{}
+
+void
+LogParameterStream::Separate (void)
+{
+  if (m_first)
+    {
+      m_first = false;
+    }
+  else
+    {
+      m_stream << ", ";
+    }
+}
+
+LogParameterStream &
+LogParameterStream::operator<< (const std::string &param)
+{
+  Separate ();
+  m_stream << "\"" << param << "\"";
+  return *this;
+}
+
+LogParameterStream &
+LogParameterStream::operator<< (const char *param)
+{
+  (*this) << std::string (param);
+  return *this;
+}
+
+LogParameterStream &
+LogParameterStream::operator<< (int8_t param)
+{
+  Separate ();
+  m_stream << static_cast<int16_t> (param);
+  return *this;
+}
+
+LogParameterStream &
+LogParameterStream::operator<< (uint8_t param)
+{
+  Separate ();
+  m_stream << static_cast<uint16_t> (param);
+  return *this;
+}
+
 } // namespace ns3
@@ -26,7 +26,10 @@
 #include <stdint.h>
 #include <map>
 #include <vector>
+#include <type_traits>
+#include <utility>
 
+#include "ns3/core-config.h"
 #include "node-printer.h"
 #include "time-printer.h"
 #include "log-macros-enabled.h"
@@ -165,9 +168,233 @@ void LogComponentDisable (char const *name, enum LogLevel level);
  */
 void LogComponentDisableAll (enum LogLevel level);
 
+/**
+ * Defer the formatting of the log messages to a buffer.
+ *
+ * From then on, the NS_LOG macros record the values of their messages
+ * in binary form, and the messages are only formatted when the buffer
+ * holds \c size bytes, on LogBufferFlush() or LogBufferDisable(), on a
+ * fatal error, and at exit.  Only the values of the fundamental types,
+ * the strings and the stream manipulators are deferred; the values of
+ * other types, and the prefixes, are formatted at once in the buffer.
+ *
+ * The buffer writes to the stream buffer of \c std::clog at the time
+ * it is enabled, so a redirection of \c std::clog must be made before.
+ *
+ * Same as running your program with the \c buffer token in the NS_LOG
+ * environment variable, e.g. NS_LOG='OnOffApplication=info:buffer'.
+ *
+ * \param [in] size The size of the buffer, in bytes.
+ */
+void LogBufferEnable (std::size_t size = 1048576);
+
+/**
+ * Format the log messages in the buffer, and write them to
+ * \c std::clog as they come from now on.
+ */
+void LogBufferDisable (void);
+
+/**
+ * Format the log messages in the buffer, if any.
+ */
+void LogBufferFlush (void);
+
+/**
+ * Count the bytes written to \c std::clog by each log component,
+ * for LogComponentPrintReport().
+ *
+ * Same as running your program with the \c report token in the NS_LOG
+ * environment variable, which also prints the report to \c std::cerr
+ * at exit.
+ */
+void LogReportEnable (void);
+
+/**
+ * Stop counting the bytes written by each log component.
+ */
+void LogReportDisable (void);
+
+/**
+ * Print the bytes and the statements written by each log component
+ * since LogReportEnable(), the most verbose component first.
+ *
+ * \param [in,out] os The output stream.
+ */
+void LogComponentPrintReport (std::ostream &os);
+
+/**
+ * \internal
+ * Check if the characters in [begin, end) are those of a string.
+ *
+ * \param [in] begin The first character.
+ * \param [in] end Past the last character.
+ * \param [in] token The string.
+ * \returns \c true if the characters are those of \c token.
+ */
+constexpr bool
+LogAllowMatch (const char *begin, const char *end, const char *token)
+{
+  while (begin != end && *token != 0 && *begin == *token)
+    {
+      begin++;
+      token++;
+    }
+  return begin == end && *token == 0;
+}
+
+/**
+ * \internal
+ * Get the LogLevels of a level option of the NS_LOG syntax.
+ *
+ * The prefix options select no LogLevel.
+ *
+ * \param [in] begin The first character of the option.
+ * \param [in] end Past the last character of the option.
+ * \param [in] first Whether the option is the first of its component.
+ * \returns The LogLevels selected by the option.
+ */
+constexpr int32_t
+LogAllowLevels (const char *begin, const char *end, bool first)
+{
+  if (LogAllowMatch (begin, end, "error"))
+    {
+      return LOG_ERROR;
+    }
+  if (LogAllowMatch (begin, end, "warn"))
+    {
+      return LOG_WARN;
+    }
+  if (LogAllowMatch (begin, end, "debug"))
+    {
+      return LOG_DEBUG;
+    }
+  if (LogAllowMatch (begin, end, "info"))
+    {
+      return LOG_INFO;
+    }
+  if (LogAllowMatch (begin, end, "function"))
+    {
+      return LOG_FUNCTION;
+    }
+  if (LogAllowMatch (begin, end, "logic"))
+    {
+      return LOG_LOGIC;
+    }
+  if (LogAllowMatch (begin, end, "level_error"))
+    {
+      return LOG_LEVEL_ERROR;
+    }
+  if (LogAllowMatch (begin, end, "level_warn"))
+    {
+      return LOG_LEVEL_WARN;
+    }
+  if (LogAllowMatch (begin, end, "level_debug"))
+    {
+      return LOG_LEVEL_DEBUG;
+    }
+  if (LogAllowMatch (begin, end, "level_info"))
+    {
+      return LOG_LEVEL_INFO;
+    }
+  if (LogAllowMatch (begin, end, "level_function"))
+    {
+      return LOG_LEVEL_FUNCTION;
+    }
+  if (LogAllowMatch (begin, end, "level_logic"))
+    {
+      return LOG_LEVEL_LOGIC;
+    }
+  if (LogAllowMatch (begin, end, "level_all")
+      || LogAllowMatch (begin, end, "**")
+      || (first && (LogAllowMatch (begin, end, "all") || LogAllowMatch (begin, end, "*"))))
+    {
+      return LOG_LEVEL_ALL;
+    }
+  return LOG_NONE;
+}
+
+/**
+ * Get the LogLevels of a log component selected by a list in the
+ * syntax of the NS_LOG environment variable.
+ *
+ * This is evaluated at compile time, to remove from the binaries the
+ * log statements not selected by the \c --log-allow configuration
+ * option (see NS_LOG_COMPONENT_DEFINE()).
+ *
+ * \param [in] name The log component name.
+ * \param [in] list The list of components and levels,
+ *             e.g. "TcpSocketBase=level_info:Ipv4L3Protocol".
+ * \returns The LogLevels selected for the component.
+ */
+constexpr int32_t
+LogAllowedLevels (const char *name, const char *list)
+{
+  int32_t levels = LOG_NONE;
+  const char *entry = list;
+  while (*entry != 0)
+    {
+      const char *end = entry;
+      while (*end != 0 && *end != ':')
+        {
+          end++;
+        }
+      const char *equal = entry;
+      while (equal != end && *equal != '=')
+        {
+          equal++;
+        }
+      if (LogAllowMatch (entry, equal, name)
+          || LogAllowMatch (entry, equal, "*")
+          || LogAllowMatch (entry, equal, "***"))
+        {
+          if (equal == end)
+            {
+              levels |= LOG_LEVEL_ALL;
+            }
+          else
+            {
+              const char *option = equal + 1;
+              bool first = true;
+              while (true)
+                {
+                  const char *next = option;
+                  while (next != end && *next != '|')
+                    {
+                      next++;
+                    }
+                  levels |= LogAllowLevels (option, next, first);
+                  first = false;
+                  if (next == end)
+                    {
+                      break;
+                    }
+                  option = next + 1;
+                }
+            }
+        }
+      entry = (*end == 0) ? end : end + 1;
+    }
+  return levels;
+}
+
 
 } // namespace ns3
 
+#ifdef NS3_LOG_ALLOW
+/**
+ * Get the LogLevels whose log statements are compiled, for the code
+ * which does not see the NS_LOG_COMPONENT_DEFINE() of its log component,
+ * such as the template classes: all of them.
+ *
+ * \returns All the LogLevels.
+ */
+constexpr int32_t
+g_logAllowedLevels (long)
+{
+  return ns3::LOG_LEVEL_ALL;
+}
+#endif /* NS3_LOG_ALLOW */
+
 
 /**
  * Define a Log component with a specific name.
@@ -200,10 +427,23 @@ void LogComponentDisableAll (enum LogLevel level);
  *   // Further definitions outside of the ns3 namespace
  *\endcode
  *
+ * When ns-3 is configured with \c --log-allow, this macro also defines
+ * the LogLevels of the component selected by the option, and the
+ * log statements of the other levels are removed from the binaries.
+ *
  * \param [in] name The log component name.
  */
+#ifdef NS3_LOG_ALLOW
+#define NS_LOG_COMPONENT_DEFINE(name)                           \
+  static constexpr int32_t g_logAllowedLevels (int)             \
+  {                                                             \
+    return ns3::LogAllowedLevels (name, NS3_LOG_ALLOW);         \
+  }                                                             \
+  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__)
+#else
 #define NS_LOG_COMPONENT_DEFINE(name)                           \
   static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__)
+#endif
 
 /**
  * Define a logging component with a mask.
@@ -213,8 +453,17 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] name The log component name.
  * \param [in] mask The default mask.
  */
+#ifdef NS3_LOG_ALLOW
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                \
+  static constexpr int32_t g_logAllowedLevels (int)             \
+  {                                                             \
+    return ns3::LogAllowedLevels (name, NS3_LOG_ALLOW);         \
+  }                                                             \
   static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, mask)
+#else
+#define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                \
+  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, mask)
+#endif
 
 /**
  * Declare a reference to a Log component.
@@ -421,6 +670,8 @@ public:
   static ComponentList * GetComponentList (void);
 
 private:
+  friend class LogStream;
+
   /**
    * Parse the `NS_LOG` environment variable for options relating to this
    * LogComponent.
@@ -431,6 +682,7 @@ private:
   int32_t     m_mask;    //!< Blocked LogLevels.
   std::string m_name;    //!< LogComponent name.
   std::string m_file;    //!< File defining this LogComponent.
+  uint32_t    m_index;   //!< Index of this LogComponent in the log report.
 
 };  // class LogComponent
 
@@ -542,6 +794,303 @@ template<>
 ParameterLogger &
 ParameterLogger::operator<< <uint8_t> (uint8_t param);
 
+/**
+ * The stream of a log message, written by the NS_LOG macros.
+ *
+ * Without a log buffer, the values are written to \c std::clog as they
+ * come.  With a log buffer (see LogBufferEnable()), the values of the
+ * fundamental types, the strings and the stream manipulators are
+ * recorded in binary form, to be formatted when the buffer is flushed;
+ * the values of the other types are formatted in the buffer at once.
+ */
+class LogStream
+{
+  /**
+   * Check if a const value can be written to a \c std::ostream.
+   *
+   * \tparam T \explicit The type of the value.
+   */
+  template <typename T, typename = void>
+  struct IsConstStreamable : std::false_type
+  {};
+  /** \copydoc IsConstStreamable */
+  template <typename T>
+  struct IsConstStreamable<T, decltype (void (std::declval<std::ostream &> ()
+                                               << std::declval<const T &> ()))>
+    : std::true_type
+  {};
+
+public:
+  /**
+   * Start a log message.
+   *
+   * \param [in] component The LogComponent of the message.
+   */
+  LogStream (const LogComponent &component);
+  /** End the log message. */
+  ~LogStream ();
+
+  /**
+   * Write a value which is formatted at once.
+   *
+   * \tparam T \deduced The type of the value.
+   * \param [in] value The value.
+   * \return This LogStream, so it's chainable.
+   */
+  template <typename T>
+  LogStream & operator<< (const T &value);
+
+  /**
+   * Write a value which is formatted at once, by an output streamer
+   * which takes a non-const reference.
+   *
+   * \tparam T \deduced The type of the value.
+   * \param [in] value The value.
+   * \return This LogStream, so it's chainable.
+   */
+  template <typename T,
+            typename std::enable_if<!IsConstStreamable<T>::value, int>::type = 0>
+  LogStream & operator<< (T &value)
+  {
+    std::clog << value;
+    return *this;
+  }
+
+  /**
+   * Write a pointer to an object.
+   *
+   * \tparam T \deduced The type of the object.
+   * \param [in] value The pointer.
+   * \return This LogStream, so it's chainable.
+   */
+  template <typename T,
+            typename std::enable_if<std::is_object<T>::value
+                                    && !std::is_volatile<T>::value
+                                    && !std::is_same<typename std::remove_cv<T>::type, char>::value
+                                    && !std::is_same<typename std::remove_cv<T>::type, signed char>::value
+                                    && !std::is_same<typename std::remove_cv<T>::type, unsigned char>::value,
+                                    int>::type = 0>
+  LogStream & operator<< (T *value)
+  {
+    return Write ('p', static_cast<const void *> (value));
+  }
+
+  /**
+   * Write a value which can be recorded in binary form.
+   *
+   * \param [in] value The value.
+   * \return This LogStream, so it's chainable.
+   * @{
+   */
+  LogStream & operator<< (bool value)
+  {
+    return Write ('b', value);
+  }
+  LogStream & operator<< (char value)
+  {
+    return Write ('c', value);
+  }
+  LogStream & operator<< (signed char value)
+  {
+    return Write ('a', value);
+  }
+  LogStream & operator<< (unsigned char value)
+  {
+    return Write ('A', value);
+  }
+  LogStream & operator<< (short value)
+  {
+    return Write ('s', value);
+  }
+  LogStream & operator<< (unsigned short value)
+  {
+    return Write ('S', value);
+  }
+  LogStream & operator<< (int value)
+  {
+    return Write ('i', value);
+  }
+  LogStream & operator<< (unsigned int value)
+  {
+    return Write ('I', value);
+  }
+  LogStream & operator<< (long value)
+  {
+    return Write ('l', value);
+  }
+  LogStream & operator<< (unsigned long value)
+  {
+    return Write ('L', value);
+  }
+  LogStream & operator<< (long long value)
+  {
+    return Write ('q', value);
+  }
+  LogStream & operator<< (unsigned long long value)
+  {
+    return Write ('Q', value);
+  }
+  LogStream & operator<< (float value)
+  {
+    return Write ('f', value);
+  }
+  LogStream & operator<< (double value)
+  {
+    return Write ('d', value);
+  }
+  LogStream & operator<< (long double value)
+  {
+    return Write ('e', value);
+  }
+  LogStream & operator<< (const void *value)
+  {
+    return Write ('p', value);
+  }
+  LogStream & operator<< (const char *value);
+  LogStream & operator<< (const std::string &value);
+  /** @} */
+
+  /**
+   * Apply a stream manipulator, such as std::endl.
+   *
+   * \param [in] manipulator The manipulator.
+   * \return This LogStream, so it's chainable.
+   * @{
+   */
+  LogStream & operator<< (std::ostream & (*manipulator)(std::ostream &));
+  LogStream & operator<< (std::ios_base & (*manipulator)(std::ios_base &));
+  /** @} */
+
+private:
+  /**
+   * Record a value in the log buffer.
+   *
+   * \param [in] tag The type of the value.
+   * \param [in] value The bytes of the value.
+   * \param [in] size The number of bytes.
+   */
+  static void Record (char tag, const void *value, std::size_t size);
+
+  /**
+   * Write a value which can be recorded in binary form.
+   *
+   * \tparam T \deduced The type of the value.
+   * \param [in] tag The type of the value.
+   * \param [in] value The value.
+   * \return This LogStream, so it's chainable.
+   */
+  template <typename T>
+  LogStream & Write (char tag, T value)
+  {
+    if (m_buffered)
+      {
+        Record (tag, &value, sizeof (value));
+      }
+    else
+      {
+        std::clog << value;
+      }
+    return *this;
+  }
+
+  bool m_buffered;      //!< Whether the message is recorded in the log buffer.
+  uint32_t m_previous;  //!< Index of the LogComponent of the enclosing message.
+};
+
+template <typename T>
+LogStream &
+LogStream::operator<< (const T &value)
+{
+  std::clog << value;
+  return *this;
+}
+
+/**
+ * Insert `, ` when streaming function arguments to a LogStream.
+ *
+ * This is the ParameterLogger of the NS_LOG_FUNCTION macro.
+ */
+class LogParameterStream
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] stream Underlying log stream.
+   */
+  LogParameterStream (LogStream &stream);
+
+  /**
+   * Write a function parameter on the log stream,
+   * separating parameters after the first by `,` strings.
+   *
+   * \tparam T \deduced The type of the parameter.
+   * \param [in] param The function parameter.
+   * \return This LogParameterStream, so it's chainable.
+   */
+  template <typename T>
+  LogParameterStream & operator<< (const T &param);
+
+  /**
+   * Overload for vectors, to print each element.
+   *
+   * \tparam T \deduced The type of the elements.
+   * \param [in] vector The vector of parameters
+   * \return This LogParameterStream, so it's chainable.
+   */
+  template <typename T>
+  LogParameterStream & operator<< (const std::vector<T> &vector);
+
+  /**
+   * Overload for strings, which are quoted.
+   *
+   * \param [in] param The function parameter.
+   * \return This LogParameterStream, so it's chainable.
+   * @{
+   */
+  LogParameterStream & operator<< (const std::string &param);
+  LogParameterStream & operator<< (const char *param);
+  /** @} */
+
+  /**
+   * Overload for 8 bit integers, which are printed as numbers.
+   *
+   * \param [in] param The function parameter.
+   * \return This LogParameterStream, so it's chainable.
+   * @{
+   */
+  LogParameterStream & operator<< (int8_t param);
+  LogParameterStream & operator<< (uint8_t param);
+  /** @} */
+
+private:
+  /** Write the separator of the parameters after the first. */
+  void Separate (void);
+
+  bool m_first;          //!< First argument flag, doesn't get `, `.
+  LogStream &m_stream;   //!< Underlying log stream.
+};
+
+template <typename T>
+LogParameterStream &
+LogParameterStream::operator<< (const T &param)
+{
+  Separate ();
+  m_stream << param;
+  return *this;
+}
+
+template <typename T>
+LogParameterStream &
+LogParameterStream::operator<< (const std::vector<T> &vector)
+{
+  for (auto i : vector)
+    {
+      *this << i;
+    }
+  return *this;
+}
+
 } // namespace ns3
 
 /**@}*/  // \ingroup logging
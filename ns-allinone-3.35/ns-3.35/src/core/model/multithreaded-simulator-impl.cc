@@ -0,0 +1,794 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the
+// threads calling them concurrently.
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/**
+ * \ingroup mtp
+ * The logical process run by the calling thread during a parallel
+ * phase, or zero outside of them.
+ */
+thread_local void *g_currentLp = 0;
+
+/** Value of an unset timestamp. */
+const uint64_t NO_TS = 0xffffffffffffffffULL;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MaxThreads",
+                   "Maximum number of threads running the logical processes; "
+                   "zero uses one thread per hardware core",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_partitioned (false),
+    m_lookahead (0),
+    m_maxThreads (0),
+    m_phase (PROCESS),
+    m_generation (0),
+    m_nextLp (0),
+    m_done (0),
+    m_windowEnd (0),
+    m_stop (false),
+    m_stopTs (NO_TS)
+{
+  NS_LOG_FUNCTION (this);
+  LogicalProcess *lp = new LogicalProcess ();
+  lp->id = 0;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  lp->uid = 4;
+  // before ::Run is entered, the currentUid will be zero
+  lp->currentUid = 0;
+  lp->currentTs = 0;
+  lp->currentContext = Simulator::NO_CONTEXT;
+  lp->eventCount = 0;
+  lp->unscheduledEvents = 0;
+  lp->sequence = 0;
+  lp->inbox = 0;
+  m_lps.push_back (lp);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      delete *i;
+    }
+  m_lps.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      Message *message = lp->inbox.exchange (0);
+      while (message != 0)
+        {
+          Message *next = message->next;
+          message->event->Unref ();
+          delete message;
+          message = next;
+        }
+      if (lp->events == 0)
+        {
+          continue;
+        }
+      while (!lp->events->IsEmpty ())
+        {
+          Scheduler::Event next = lp->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      lp->events = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+MultithreadedSimulatorImpl::PartitionCallback &
+MultithreadedSimulatorImpl::GetDefaultPartitioner (void)
+{
+  static PartitionCallback partitioner;
+  return partitioner;
+}
+
+void
+MultithreadedSimulatorImpl::SetDefaultPartitioner (PartitionCallback partitioner)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetDefaultPartitioner () = partitioner;
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ASSERT_MSG (!m_partitioned, "The partition can only be set before Simulator::Run");
+  if (m_partition.size () <= context)
+    {
+      m_partition.resize (context + 1, 0);
+    }
+  m_partition[context] = partition;
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (const Time &lookahead)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  NS_ASSERT_MSG (!m_partitioned, "The lookahead can only be set before Simulator::Run");
+  NS_ASSERT_MSG (lookahead.IsPositive (), "The lookahead must be positive");
+  m_lookahead = lookahead.GetTimeStep ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return static_cast<uint32_t> (m_lps.size ());
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (lp->events != 0)
+        {
+          while (!lp->events->IsEmpty ())
+            {
+              scheduler->Insert (lp->events->RemoveNext ());
+            }
+        }
+      lp->events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetCurrent (void) const
+{
+  if (g_currentLp != 0)
+    {
+      return static_cast<LogicalProcess *> (g_currentLp);
+    }
+  return m_lps[0];
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetLogicalProcess (uint32_t context) const
+{
+  if (m_partitioned && context < m_partition.size ())
+    {
+      return m_lps[m_partition[context]];
+    }
+  return m_lps[0];
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert (LogicalProcess *lp, uint64_t ts,
+                                    uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = lp->uid;
+  lp->uid++;
+  lp->unscheduledEvents++;
+  lp->events->Insert (ev);
+  return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t threads = m_maxThreads;
+  if (threads == 0)
+    {
+      threads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+  if (m_partition.empty () && threads > 1 && !GetDefaultPartitioner ().IsNull ())
+    {
+      m_lookahead = GetDefaultPartitioner () (threads, m_partition).GetTimeStep ();
+    }
+
+  uint32_t nLps = 1;
+  for (std::vector<uint32_t>::const_iterator i = m_partition.begin (); i != m_partition.end (); ++i)
+    {
+      nLps = std::max (nLps, *i + 1);
+    }
+  if (nLps > 1 && m_lookahead == 0)
+    {
+      NS_LOG_WARN ("No positive lookahead, running sequentially");
+      nLps = 1;
+    }
+  if (nLps == 1)
+    {
+      m_partition.clear ();
+    }
+
+  LogicalProcess *lp0 = m_lps[0];
+  for (uint32_t i = 1; i < nLps; ++i)
+    {
+      LogicalProcess *lp = new LogicalProcess ();
+      lp->id = i;
+      lp->events = m_schedulerFactory.Create<Scheduler> ();
+      // Start above the uids of the events moved from LP 0 below,
+      // so that uids stay unique within each event list.
+      lp->uid = lp0->uid;
+      lp->currentUid = 0;
+      lp->currentTs = lp0->currentTs;
+      lp->currentContext = Simulator::NO_CONTEXT;
+      lp->eventCount = 0;
+      lp->unscheduledEvents = 0;
+      lp->sequence = 0;
+      lp->inbox = 0;
+      m_lps.push_back (lp);
+    }
+  m_partitioned = true;
+
+  if (nLps > 1)
+    {
+      // Move the events scheduled during the setup to their owner.
+      std::vector<Scheduler::Event> events;
+      while (!lp0->events->IsEmpty ())
+        {
+          events.push_back (lp0->events->RemoveNext ());
+        }
+      for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+        {
+          LogicalProcess *lp = GetLogicalProcess (i->key.m_context);
+          lp->events->Insert (*i);
+          lp->unscheduledEvents++;
+          lp0->unscheduledEvents--;
+        }
+    }
+  NS_LOG_INFO ("partitions=" << nLps << " threads=" << std::min (threads, nLps) <<
+               " lookahead=" << m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (LogicalProcess *lp)
+{
+  Scheduler::Event next = lp->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= lp->currentTs);
+  lp->unscheduledEvents--;
+  lp->eventCount++;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  lp->currentTs = next.key.m_ts;
+  lp->currentContext = next.key.m_context;
+  lp->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (LogicalProcess *lp)
+{
+  while (!lp->events->IsEmpty ()
+         && lp->events->PeekNext ().key.m_ts < m_windowEnd)
+    {
+      ProcessOneEvent (lp);
+    }
+}
+
+/**
+ * \ingroup mtp
+ * Order of the messages received within a window.
+ *
+ * \param [in] a The first message.
+ * \param [in] b The second message.
+ * \returns \c true if \p a is merged before \p b.
+ */
+template <typename T>
+static bool
+MessageLess (const T *a, const T *b)
+{
+  if (a->timestamp != b->timestamp)
+    {
+      return a->timestamp < b->timestamp;
+    }
+  if (a->sender != b->sender)
+    {
+      return a->sender < b->sender;
+    }
+  return a->sequence < b->sequence;
+}
+
+void
+MultithreadedSimulatorImpl::Receive (LogicalProcess *lp)
+{
+  Message *message = lp->inbox.exchange (0, std::memory_order_acquire);
+  if (message == 0)
+    {
+      return;
+    }
+  std::vector<Message *> messages;
+  while (message != 0)
+    {
+      messages.push_back (message);
+      message = message->next;
+    }
+  // The inbox order depends on thread timing: sort the messages
+  // so that the uids, and hence the order of simultaneous events,
+  // are reproducible.
+  std::sort (messages.begin (), messages.end (), MessageLess<Message>);
+  for (std::vector<Message *>::const_iterator i = messages.begin (); i != messages.end (); ++i)
+    {
+      NS_ASSERT ((*i)->timestamp >= m_windowEnd);
+      Insert (lp, (*i)->timestamp, (*i)->context, (*i)->event);
+      delete *i;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoPhase (void)
+{
+  uint32_t i;
+  while ((i = m_nextLp.fetch_add (1, std::memory_order_relaxed)) < m_lps.size ())
+    {
+      LogicalProcess *lp = m_lps[i];
+      g_currentLp = lp;
+      if (m_phase == PROCESS)
+        {
+          ProcessWindow (lp);
+        }
+      else
+        {
+          Receive (lp);
+        }
+    }
+  g_currentLp = 0;
+}
+
+void
+MultithreadedSimulatorImpl::WorkerLoop (void)
+{
+  uint32_t generation = 0;
+  while (true)
+    {
+      while (m_generation.load (std::memory_order_acquire) == generation)
+        {
+          std::this_thread::yield ();
+        }
+      generation++;
+      if (m_phase == EXIT)
+        {
+          return;
+        }
+      DoPhase ();
+      m_done.fetch_add (1, std::memory_order_release);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPhase (Phase phase)
+{
+  m_phase = phase;
+  m_nextLp.store (0, std::memory_order_relaxed);
+  m_done.store (0, std::memory_order_relaxed);
+  m_generation.fetch_add (1, std::memory_order_release);
+  if (phase == EXIT)
+    {
+      return;
+    }
+  DoPhase ();
+  while (m_done.load (std::memory_order_acquire) < m_threads.size ())
+    {
+      std::this_thread::yield ();
+    }
+}
+
+uint64_t
+MultithreadedSimulatorImpl::NextTs (void) const
+{
+  uint64_t next = NO_TS;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          next = std::min (next, (*i)->events->PeekNext ().key.m_ts);
+        }
+    }
+  return next;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  return NextTs () == NO_TS || m_stop;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_partitioned)
+    {
+      Partition ();
+    }
+  m_stop = false;
+
+  if (m_lps.size () == 1)
+    {
+      LogicalProcess *lp = m_lps[0];
+      while (!lp->events->IsEmpty () && !m_stop)
+        {
+          ProcessOneEvent (lp);
+        }
+    }
+  else
+    {
+      uint32_t threads = m_maxThreads;
+      if (threads == 0)
+        {
+          threads = std::max (std::thread::hardware_concurrency (), 1U);
+        }
+      threads = std::min (threads, GetPartitionCount ());
+      m_generation = 0;
+      for (uint32_t i = 1; i < threads; ++i)
+        {
+          Ptr<SystemThread> thread = Create<SystemThread> (
+              MakeCallback (&MultithreadedSimulatorImpl::WorkerLoop, this));
+          thread->Start ();
+          m_threads.push_back (thread);
+        }
+
+      while (!m_stop)
+        {
+          uint64_t next = NextTs ();
+          if (next == NO_TS)
+            {
+              break;
+            }
+          m_windowEnd = next > NO_TS - m_lookahead ? NO_TS : next + m_lookahead;
+          uint64_t stopTs = m_stopTs.load (std::memory_order_relaxed);
+          if (stopTs < m_windowEnd)
+            {
+              m_windowEnd = std::max (stopTs + 1, next + 1);
+            }
+          RunPhase (PROCESS);
+          RunPhase (RECEIVE);
+        }
+
+      RunPhase (EXIT);
+      for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+        {
+          (*i)->Join ();
+        }
+      m_threads.clear ();
+
+      // Align the clocks of all the logical processes.
+      uint64_t now = 0;
+      for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+        {
+          now = std::max (now, (*i)->currentTs);
+        }
+      for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+        {
+          if ((*i)->currentTs != now)
+            {
+              (*i)->currentTs = now;
+              (*i)->currentUid = 0;
+            }
+        }
+    }
+
+  if (m_stopTs.load () <= GetCurrent ()->currentTs)
+    {
+      m_stopTs = NO_TS;
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+#ifdef NS3_ASSERT_ENABLE
+  int unscheduledEvents = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      unscheduledEvents += (*i)->unscheduledEvents;
+    }
+  NS_ASSERT (NextTs () != NO_TS || unscheduledEvents == 0);
+#endif
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  uint64_t ts = GetCurrent ()->currentTs + delay.GetTimeStep ();
+  uint64_t stopTs = m_stopTs.load ();
+  while (ts < stopTs && !m_stopTs.compare_exchange_weak (stopTs, ts))
+    {
+    }
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+  LogicalProcess *lp = GetCurrent ();
+  Time tAbsolute = delay + TimeStep (lp->currentTs);
+  Scheduler::EventKey key = Insert (lp, (uint64_t) tAbsolute.GetTimeStep (),
+                                    lp->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  LogicalProcess *source = GetCurrent ();
+  LogicalProcess *target = GetLogicalProcess (context);
+  uint64_t ts = source->currentTs + delay.GetTimeStep ();
+  if (g_currentLp == 0 || source == target)
+    {
+      // Outside of the parallel phases every event list can be
+      // accessed safely.
+      Insert (target, ts, context, event);
+      return;
+    }
+
+  if (delay.GetTimeStep () < static_cast<int64_t> (m_lookahead))
+    {
+      NS_FATAL_ERROR ("Event for context " << context << " scheduled with delay " <<
+                      delay << " below the lookahead " << GetLookahead ());
+    }
+  Message *message = new Message ();
+  message->timestamp = ts;
+  message->context = context;
+  message->sender = source->id;
+  message->sequence = source->sequence++;
+  message->event = event;
+  message->next = target->inbox.load (std::memory_order_relaxed);
+  while (!target->inbox.compare_exchange_weak (message->next, message,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+    {
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  LogicalProcess *lp = GetCurrent ();
+  Scheduler::EventKey key = Insert (lp, lp->currentTs, lp->currentContext, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrent ()->currentTs, 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrent ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrent ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  LogicalProcess *lp = GetLogicalProcess (id.GetContext ());
+  NS_ASSERT_MSG (g_currentLp == 0 || g_currentLp == lp,
+                 "Events can only be removed by their logical process");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  lp->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  lp->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (const_cast<SystemMutex &> (m_destroyEventsMutex));
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  LogicalProcess *lp = GetLogicalProcess (id.GetContext ());
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < lp->currentTs
+      || (id.GetTs () == lp->currentTs && id.GetUid () <= lp->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrent ()->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      count += (*i)->eventCount;
+    }
+  return count;
+}
+
+} // namespace ns3
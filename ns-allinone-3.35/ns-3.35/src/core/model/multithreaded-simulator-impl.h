@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+#include "callback.h"
+#include "ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \defgroup mtp Multithreaded Simulator
+ *
+ * Shared-memory parallel simulator implementation.
+ */
+
+/**
+ * \ingroup mtp
+ *
+ * A conservative parallel simulator running several logical processes
+ * on a pool of threads of a single process.
+ *
+ * Every simulation context (i.e. node) is mapped to a logical process
+ * (LP), which owns its own event list.  Events without a context, such
+ * as those scheduled during the simulation setup, belong to LP 0.
+ * The simulation then advances in time windows, as with the granted
+ * time window algorithm of the DistributedSimulatorImpl: the window
+ * starts at the earliest pending event over all the LPs and lasts for
+ * the lookahead, i.e. the smallest delay of an event scheduled by one
+ * LP for another one.  Within a window the LPs are independent and are
+ * executed in parallel, each LP processing its events in timestamp
+ * order.  Events for other LPs are pushed to lock-free inboxes and
+ * merged at the end of the window, in an order which does not depend
+ * on thread timing, so runs are reproducible.
+ *
+ * The mapping of contexts to LPs and the lookahead are set either
+ * explicitly with SetPartition() and SetLookahead() before the first
+ * call to Simulator::Run(), or automatically by the partitioner set
+ * with SetDefaultPartitioner().  The network module installs a
+ * partitioner which splits the topology along point-to-point links,
+ * using the smallest link delay as lookahead.  When no partition
+ * with a positive lookahead can be found the simulation runs
+ * sequentially.
+ *
+ * This implementation is only available when ns-3 is configured with
+ * \c --enable-mtp, which makes the reference counts of the core and
+ * network modules thread-safe.  Models must otherwise only access
+ * the state of other nodes through ScheduleWithContext with a delay
+ * at least equal to the lookahead, and Simulator::Stop(const Time &)
+ * is honoured at window boundaries.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * Partitioner callback.
+   *
+   * The partitioner is called at the first Simulator::Run() if no
+   * partition has been set explicitly.  Its arguments are the
+   * maximum number of partitions wanted and the vector to fill
+   * with the partition of each context; it returns the lookahead.
+   */
+  typedef Callback<Time, uint32_t, std::vector<uint32_t> &> PartitionCallback;
+
+  /**
+   * Set the partitioner used when no partition is set explicitly.
+   *
+   * \param [in] partitioner The partitioner.
+   */
+  static void SetDefaultPartitioner (PartitionCallback partitioner);
+
+  /**
+   * Map a context to a logical process.
+   *
+   * Contexts which are not mapped belong to LP 0.  This can only
+   * be called before the first call to Simulator::Run().
+   *
+   * \param [in] context The context, usually a node id.
+   * \param [in] partition The logical process.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * Set the lookahead.
+   *
+   * Events scheduled for another logical process must be at least
+   * this far in the future.
+   *
+   * \param [in] lookahead The lookahead.
+   */
+  void SetLookahead (const Time &lookahead);
+  /**
+   * Get the lookahead.
+   *
+   * \returns The lookahead.
+   */
+  Time GetLookahead (void) const;
+  /**
+   * Get the number of logical processes.
+   *
+   * \returns The number of logical processes, only known after
+   * the first call to Simulator::Run().
+   */
+  uint32_t GetPartitionCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent to another logical process. */
+  struct Message
+  {
+    uint64_t timestamp;    /**< Absolute event timestamp. */
+    uint32_t context;      /**< Event context. */
+    uint32_t sender;       /**< Sending logical process. */
+    uint64_t sequence;     /**< Sending order in the sending logical process. */
+    EventImpl *event;      /**< The event implementation. */
+    Message *next;         /**< The next message in the inbox. */
+  };
+
+  /** A logical process: a set of contexts with its own event list. */
+  struct LogicalProcess
+  {
+    uint32_t id;                      /**< Index of this LP. */
+    Ptr<Scheduler> events;            /**< The event priority queue. */
+    uint32_t uid;                     /**< Next event unique id. */
+    uint32_t currentUid;              /**< Unique id of the current event. */
+    uint64_t currentTs;               /**< Timestamp of the current event. */
+    uint32_t currentContext;          /**< Execution context of the current event. */
+    uint64_t eventCount;              /**< The event count. */
+    int unscheduledEvents;            /**< Events inserted but not yet run. */
+    uint64_t sequence;                /**< Number of messages sent. */
+    std::atomic<Message *> inbox;     /**< Lock-free stack of incoming messages. */
+  };
+
+  /** Parallel phases, run by all the threads of the pool. */
+  enum Phase
+  {
+    PROCESS,  /**< Process the events of the current window. */
+    RECEIVE,  /**< Merge the inboxes into the event lists. */
+    EXIT      /**< Terminate the worker threads. */
+  };
+
+  /**
+   * Get the storage of the default partitioner.
+   * \returns The default partitioner.
+   */
+  static PartitionCallback & GetDefaultPartitioner (void);
+  /**
+   * Get the logical process of the calling thread.
+   * \returns The current logical process.
+   */
+  LogicalProcess * GetCurrent (void) const;
+  /**
+   * Get the logical process owning a context.
+   * \param [in] context The context.
+   * \returns The logical process.
+   */
+  LogicalProcess * GetLogicalProcess (uint32_t context) const;
+  /**
+   * Insert an event in the event list of a logical process.
+   * \param [in] lp The logical process.
+   * \param [in] ts The absolute event timestamp.
+   * \param [in] context The event context.
+   * \param [in] event The event implementation.
+   * \returns The scheduled event key.
+   */
+  Scheduler::EventKey Insert (LogicalProcess *lp, uint64_t ts,
+                              uint32_t context, EventImpl *event);
+  /** Create the logical processes and distribute the pending events. */
+  void Partition (void);
+  /**
+   * Process the next event of a logical process.
+   * \param [in] lp The logical process.
+   */
+  void ProcessOneEvent (LogicalProcess *lp);
+  /**
+   * Process the events of a logical process within the current window.
+   * \param [in] lp The logical process.
+   */
+  void ProcessWindow (LogicalProcess *lp);
+  /**
+   * Merge the messages received by a logical process.
+   * \param [in] lp The logical process.
+   */
+  void Receive (LogicalProcess *lp);
+  /**
+   * Run a phase in parallel over all the logical processes.
+   * \param [in] phase The phase.
+   */
+  void RunPhase (Phase phase);
+  /** Claim and process logical processes for the current phase. */
+  void DoPhase (void);
+  /** Body of the worker threads. */
+  void WorkerLoop (void);
+  /**
+   * Get the timestamp of the earliest pending event.
+   * \returns The timestamp, or the maximum value if there is none.
+   */
+  uint64_t NextTs (void) const;
+
+  /** The logical processes. */
+  std::vector<LogicalProcess *> m_lps;
+  /** Logical process of each context. */
+  std::vector<uint32_t> m_partition;
+  /** Whether the logical processes have been created. */
+  bool m_partitioned;
+  /** The lookahead, in time steps. */
+  uint64_t m_lookahead;
+  /** The scheduler factory, used for each logical process. */
+  ObjectFactory m_schedulerFactory;
+  /** Maximum number of threads. */
+  uint32_t m_maxThreads;
+
+  /** The worker threads, started at Run; the main thread is a worker as well. */
+  std::vector<Ptr<SystemThread> > m_threads;
+  /** The phase being run. */
+  Phase m_phase;
+  /** Incremented to start a new phase. */
+  std::atomic<uint32_t> m_generation;
+  /** Next logical process to claim in the current phase. */
+  std::atomic<uint32_t> m_nextLp;
+  /** Number of worker threads done with the current phase. */
+  std::atomic<uint32_t> m_done;
+  /** Events with timestamp before this are processed in the current window. */
+  uint64_t m_windowEnd;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** Timestamp of the earliest Stop event. */
+  std::atomic<uint64_t> m_stopTs;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the destroy events. */
+  SystemMutex m_destroyEventsMutex;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -480,6 +480,12 @@ public:
   }
   inline static Time FromDouble (double value, enum Unit unit)
   {
+    struct Information *info = PeekInformation (unit);
+    int64_t steps;
+    if (RoundScaled (info->fromMul ? value * info->factor : value / info->factor, steps))
+      {
+        return Time (steps);
+      }
     return From (int64x64_t (value), unit);
   }
   inline static Time From (const int64x64_t & value, enum Unit unit)
@@ -529,11 +535,23 @@ public:
   }
   inline double ToDouble (enum Unit unit) const
   {
-    return To (unit).GetDouble ();
+    // A single rounding, rather than the conversion of the
+    // int64x64_t value of To().
+    struct Information *info = PeekInformation (unit);
+    if (info->toMul)
+      {
+        return static_cast<double> (m_data) * info->factor;
+      }
+    return static_cast<double> (m_data) / info->factor;
   }
   inline int64x64_t To (enum Unit unit) const
   {
     struct Information *info = PeekInformation (unit);
+    if (info->toMul && m_data <= info->maxToMul && m_data >= -info->maxToMul)
+      {
+        // Integer scaling, to a finer unit.
+        return int64x64_t (m_data * info->factor);
+      }
     int64x64_t retval = int64x64_t (m_data);
     if (info->toMul)
       {
@@ -588,6 +606,7 @@ private:
     int64_t factor;                 //!< Ratio of this unit / current unit
     int64x64_t timeTo;              //!< Multiplier to convert to this unit
     int64x64_t timeFrom;            //!< Multiplier to convert from this unit
+    int64_t maxToMul;               //!< Largest value converted to this unit without overflow
   };
   /** Current time unit, and conversion info. */
   struct Resolution
@@ -617,6 +636,47 @@ private:
     return &(PeekResolution ()->info[timeUnit]);
   }
 
+  /**
+   *  Round a time value scaled in double precision to the nearest
+   *  integer, if this gives the result of the int64x64_t arithmetic.
+   *
+   *  Below $2^{52}$ every half integer is a double, so rounding
+   *  the exact value to a double can bring it to a half integer, but
+   *  not across one: the result is exact, unless it is half way.
+   *
+   *  \param [in] value The scaled value.
+   *  \param [out] steps The value rounded to the nearest integer.
+   *  
+eturn \c true if \pname{steps} is exact.
+   */
+  static inline bool RoundScaled (double value, int64_t & steps)
+  {
+    // The negation also catches NaN.
+    if (!(value < 4503599627370496.0 && value > -4503599627370496.0))
+      {
+        return false;
+      }
+    int64_t integral = static_cast<int64_t> (value);
+    double fraction = value - integral;
+    if (fraction == 0.5 || fraction == -0.5)
+      {
+        return false;
+      }
+    steps = integral + (fraction > 0.5) - (fraction < -0.5);
+    return true;
+  }
+  /**
+   *  Whether a time value converts exactly to a double.
+   *
+   *  \param [in] value The time value.
+   *  
+eturn \c true if \pname{value} is a double.
+   */
+  static inline bool IsExactDouble (int64_t value)
+  {
+    return value <= (INT64_C (1) << 53) && value >= -(INT64_C (1) << 53);
+  }
+
   /**
    *  Set the default resolution
    *
@@ -1013,6 +1073,12 @@ template<class T>
 typename std::enable_if<std::is_floating_point<T>::value, Time>::type
 operator * (const Time& lhs, T rhs)
 {
+  int64_t steps;
+  if (sizeof (T) <= sizeof (double) && Time::IsExactDouble (lhs.m_data)
+      && Time::RoundScaled (lhs.m_data * static_cast<double> (rhs), steps))
+    {
+      return Time (steps);
+    }
   return lhs * int64x64_t(rhs);
 }
 
@@ -1088,6 +1154,12 @@ template<class T>
 typename std::enable_if<std::is_floating_point<T>::value, Time>::type
 operator / (const Time& lhs, T rhs)
 {
+  int64_t steps;
+  if (sizeof (T) <= sizeof (double) && Time::IsExactDouble (lhs.m_data)
+      && Time::RoundScaled (lhs.m_data / static_cast<double> (rhs), steps))
+    {
+      return Time (steps);
+    }
   return lhs / int64x64_t(rhs);
 }
 
@@ -110,6 +110,22 @@ MakeObjectMapAccessor (U T::*memberVector)
       // quiet compiler.
       return 0;
     }
+    virtual bool DoFind (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const
+    {
+      const T *obj = dynamic_cast<const T *> (object);
+      typename U::key_type key = static_cast<typename U::key_type> (index);
+      if (obj == 0 || static_cast<std::size_t> (key) != index)
+        {
+          return false;
+        }
+      typename U::const_iterator j = (obj->*m_memberVector).find (key);
+      if (j == (obj->*m_memberVector).end ())
+        {
+          return false;
+        }
+      *value = (*j).second;
+      return true;
+    }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
   spec->m_memberVector = memberVector;
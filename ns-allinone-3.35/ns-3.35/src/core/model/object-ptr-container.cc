@@ -128,6 +128,33 @@ ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &valu
   return true;
 }
 bool
+ObjectPtrContainerAccessor::Find (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const
+{
+  NS_LOG_FUNCTION (this << object << index);
+  return DoFind (object, index, value);
+}
+bool
+ObjectPtrContainerAccessor::DoFind (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const
+{
+  NS_LOG_FUNCTION (this << object << index);
+  std::size_t n;
+  if (!DoGetN (object, &n))
+    {
+      return false;
+    }
+  for (std::size_t i = 0; i < n; i++)
+    {
+      std::size_t k;
+      Ptr<Object> o = DoGet (object, i, &k);
+      if (k == index)
+        {
+          *value = o;
+          return true;
+        }
+    }
+  return false;
+}
+bool
 ObjectPtrContainerAccessor::HasGetter (void) const
 {
   NS_LOG_FUNCTION (this);
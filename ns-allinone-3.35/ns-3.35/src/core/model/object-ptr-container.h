@@ -228,8 +228,29 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Find an instance of the container by its index, without getting
+   * all the instances as Get() does.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance.
+   * \param [out] value The instance.
+   * \returns \c true if the container has an instance with this index.
+   */
+  bool Find (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const;
 
 private:
+  /**
+   * Find an instance of the container by its index.
+   *
+   * The default implementation looks through all the instances.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance.
+   * \param [out] value The instance.
+   * \returns \c true if the container has an instance with this index.
+   */
+  virtual bool DoFind (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const;
   /**
    * Get the number of instances in the container.
    *
@@ -272,6 +293,16 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual bool DoFind (const ObjectBase *object, std::size_t index, Ptr<Object> *value) const
+    {
+      const T *obj = dynamic_cast<const T *> (object);
+      if (obj == 0 || index >= static_cast<std::size_t> ((obj->*m_getN)()))
+        {
+          return false;
+        }
+      *value = (obj->*m_get)(index);
+      return true;
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
@@ -37,6 +37,10 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <set>
+#ifdef NS3_MTP
+#include <mutex>
+#endif
 
 /**
  * \file
@@ -50,6 +54,31 @@ NS_LOG_COMPONENT_DEFINE ("RandomVariableStream");
 
 NS_OBJECT_ENSURE_REGISTERED (RandomVariableStream);
 
+namespace {
+
+/**
+ * \ingroup randomvariable
+ * Get the set of the existing streams.
+ *
+ * The set is never deleted, so that streams held by static
+ * variables can still be destroyed at exit.
+ *
+ * \returns The set of the existing streams.
+ */
+std::set<RandomVariableStream *> &
+GetStreams (void)
+{
+  static std::set<RandomVariableStream *> *streams = new std::set<RandomVariableStream *> ();
+  return *streams;
+}
+
+#ifdef NS3_MTP
+/** Mutex protecting the set of the existing streams. */
+std::mutex g_streamsMutex;
+#endif
+
+} // unnamed namespace
+
 TypeId
 RandomVariableStream::GetTypeId (void)
 {
@@ -77,11 +106,36 @@ RandomVariableStream::RandomVariableStream ()
   : m_rng (0)
 {
   NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_streamsMutex);
+#endif
+  GetStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream ()
 {
   NS_LOG_FUNCTION (this);
   delete m_rng;
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_streamsMutex);
+#endif
+  GetStreams ().erase (this);
+}
+
+void
+RandomVariableStream::AdvanceAllStreams (uint64_t n)
+{
+  NS_LOG_FUNCTION (n);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_streamsMutex);
+#endif
+  std::set<RandomVariableStream *> &streams = GetStreams ();
+  for (std::set<RandomVariableStream *>::iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      if ((*i)->m_rng != 0)
+        {
+          (*i)->m_rng->AdvanceSubstreams (n);
+        }
+    }
 }
 
 void
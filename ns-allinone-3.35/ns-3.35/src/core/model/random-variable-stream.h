@@ -149,6 +149,18 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Move every existing stream to the same position in a later
+   * sub-stream.
+   *
+   * After a simulation is forked (see Checkpoint::Fork()), this makes
+   * the random values of each branch independent, as if each branch
+   * had used a different run number from the start.
+   *
+   * \param [in] n The number of sub-streams, i.e. of runs, to skip.
+   */
+  static void AdvanceAllStreams (uint64_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
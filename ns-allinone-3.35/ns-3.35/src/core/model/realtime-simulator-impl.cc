@@ -21,6 +21,7 @@
 #include "wall-clock-synchronizer.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "synchronizer.h"
 
 #include "ptr.h"
@@ -31,8 +32,10 @@
 #include "system-mutex.h"
 #include "boolean.h"
 #include "enum.h"
+#include "trace-source-accessor.h"
 
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -65,10 +68,19 @@ RealtimeSimulatorImpl::GetTypeId (void)
                    MakeEnumChecker (SYNC_BEST_EFFORT, "BestEffort",
                                     SYNC_HARD_LIMIT, "HardLimit"))
     .AddAttribute ("HardLimit",
-                   "Maximum acceptable real-time jitter (used in conjunction with SynchronizationMode=HardLimit)",
+                   "Maximum acceptable real-time jitter (used in conjunction with SynchronizationMode=HardLimit; "
+                   "with SynchronizationMode=BestEffort, later events are only reported)",
                    TimeValue (Seconds (0.1)),
                    MakeTimeAccessor (&RealtimeSimulatorImpl::m_hardLimit),
                    MakeTimeChecker ())
+    .AddTraceSource ("Lateness",
+                     "How long after its time on the wall clock each event is run",
+                     MakeTraceSourceAccessor (&RealtimeSimulatorImpl::m_latenessTrace),
+                     "ns3::RealtimeSimulatorImpl::LatenessTracedCallback")
+    .AddTraceSource ("HardLimitExceeded",
+                     "The lateness of the events run later than the HardLimit",
+                     MakeTraceSourceAccessor (&RealtimeSimulatorImpl::m_hardLimitExceededTrace),
+                     "ns3::RealtimeSimulatorImpl::LatenessTracedCallback")
   ;
   return tid;
 }
@@ -91,6 +103,8 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
+  m_inbox = 0;
+  ResetLatenessStatistics ();
 
   m_main = SystemThread::Self ();
 
@@ -108,6 +122,13 @@ void
 RealtimeSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  for (InboxEvent *event = m_inbox.exchange (0); event != 0; )
+    {
+      InboxEvent *next = event->next;
+      event->ev.impl->Unref ();
+      delete event;
+      event = next;
+    }
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
@@ -230,6 +251,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         // tsNext is the simulation time of the next event we want to execute.
         //
         tsNow = m_synchronizer->GetCurrentRealtime ();
+        DrainInbox ();
         tsNext = NextTs ();
 
         //
@@ -260,6 +282,17 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         m_synchronizer->SetCondition (false);
       }
 
+      //
+      // The other threads signal the synchronizer after pushing their events
+      // to the inbox, without the critical section: an event pushed after
+      // the inbox was drained, but signalled before the condition was reset,
+      // would not interrupt the wait, so look again.
+      //
+      if (m_inbox.load () != 0)
+        {
+          continue;
+        }
+
       //
       // We have a time to delay.  This time may actually not be valid anymore
       // since we released the critical section immediately above, and a real-time
@@ -317,6 +350,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // whatever event is at the head of this list if the list is in time order.
   //
   Scheduler::Event next;
+  uint64_t tsFinal;
 
   {
     CriticalSection cs (m_mutex);
@@ -327,6 +361,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // event we're working on won't be on the list and so subsequent operations won't
     // mess with us.
     //
+    DrainInbox ();
     NS_ASSERT_MSG (m_events->IsEmpty () == false,
                    "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
     next = m_events->RemoveNext ();
@@ -361,9 +396,9 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // We check the simulation time against the current real time to make this
     // judgement.
     //
+    tsFinal = m_synchronizer->GetCurrentRealtime ();
     if (m_synchronizationMode == SYNC_HARD_LIMIT)
       {
-        uint64_t tsFinal = m_synchronizer->GetCurrentRealtime ();
         uint64_t tsJitter;
 
         if (tsFinal >= m_currentTs)
@@ -388,9 +423,19 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // event list so we can execute it outside a critical section without fear of someone
   // changing things out from under us.
 
+  // The trace sinks may schedule events, so out of the critical section too.
+  RecordLateness (tsFinal);
+
   EventImpl *event = next.impl;
   m_synchronizer->EventStart ();
-  event->Invoke ();
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Get ()->Invoke (event, m_currentContext);
+    }
+  else
+    {
+      event->Invoke ();
+    }
   m_synchronizer->EventEnd ();
   event->Unref ();
 }
@@ -401,7 +446,7 @@ RealtimeSimulatorImpl::IsFinished (void) const
   bool rc;
   {
     CriticalSection cs (m_mutex);
-    rc = m_events->IsEmpty () || m_stop;
+    rc = (m_events->IsEmpty () && m_inbox.load () == 0) || m_stop;
   }
 
   return rc;
@@ -444,6 +489,7 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        DrainInbox ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -544,23 +590,15 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 {
   NS_LOG_FUNCTION (this << context << delay << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (context, delay, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + delay.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        //
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += delay.GetTimeStep ();
-      }
+    uint64_t ts = m_currentTs + delay.GetTimeStep ();
 
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
@@ -610,6 +648,12 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (context, time, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
@@ -618,6 +662,7 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
     Scheduler::Event ev;
     ev.impl = impl;
     ev.key.m_ts = ts;
+    ev.key.m_context = context;
     ev.key.m_uid = m_uid;
     m_uid++;
     m_unscheduledEvents++;
@@ -637,6 +682,13 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext (uint32_t context, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << context << impl);
+
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (context, Time (0), impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
@@ -853,4 +905,149 @@ RealtimeSimulatorImpl::GetHardLimit (void) const
   return m_hardLimit;
 }
 
+void
+RealtimeSimulatorImpl::PushInbox (uint32_t context, const Time &delay, EventImpl *impl)
+{
+  InboxEvent *event = new InboxEvent;
+  event->ev.impl = impl;
+  event->ev.key.m_context = context;
+  //
+  // If the simulator is running, we're pacing and have a meaningful
+  // realtime clock.  If we're not, the event is relative to m_currentTs,
+  // where we stopped, which only the simulation thread may read.
+  //
+  event->relative = !m_running;
+  event->ev.key.m_ts = delay.GetTimeStep ();
+  if (!event->relative)
+    {
+      event->ev.key.m_ts += m_synchronizer->GetCurrentRealtime ();
+    }
+
+  InboxEvent *head = m_inbox.load ();
+  do
+    {
+      event->next = head;
+    }
+  while (!m_inbox.compare_exchange_weak (head, event));
+  m_synchronizer->Signal ();
+}
+
+void
+RealtimeSimulatorImpl::DrainInbox (void)
+{
+  if (m_inbox.load () == 0)
+    {
+      return;
+    }
+  // Take the whole inbox, and put it back in the order of the pushes.
+  InboxEvent *event = m_inbox.exchange (0);
+  InboxEvent *first = 0;
+  while (event != 0)
+    {
+      InboxEvent *next = event->next;
+      event->next = first;
+      first = event;
+      event = next;
+    }
+  for (event = first; event != 0; )
+    {
+      Scheduler::Event ev = event->ev;
+      if (event->relative)
+        {
+          ev.key.m_ts += m_currentTs;
+        }
+      //
+      // The real time at which the event was pushed may already be behind an
+      // event run since: the event is late, and runs as soon as possible.
+      //
+      ev.key.m_ts = std::max (ev.key.m_ts, m_currentTs);
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+      InboxEvent *next = event->next;
+      delete event;
+      event = next;
+    }
+}
+
+void
+RealtimeSimulatorImpl::RecordLateness (uint64_t tsNow)
+{
+  uint64_t lateness = tsNow > m_currentTs ? tsNow - m_currentTs : 0;
+  uint32_t bin = 0;
+  for (uint64_t v = lateness; v != 0 && bin < 63; v >>= 1)
+    {
+      ++bin;
+    }
+  ++m_latenessHistogram[bin];
+  ++m_latenessCount;
+  m_latenessSum += lateness;
+  m_latenessMax = std::max (m_latenessMax, lateness);
+  if (!m_latenessTrace.IsEmpty ())
+    {
+      m_latenessTrace (TimeStep (lateness));
+    }
+  if (lateness > static_cast<uint64_t> (m_hardLimit.GetTimeStep ()))
+    {
+      ++m_hardLimitExceeded;
+      m_hardLimitExceededTrace (TimeStep (lateness));
+    }
+}
+
+RealtimeSimulatorImpl::LatenessStatistics
+RealtimeSimulatorImpl::GetLatenessStatistics (void) const
+{
+  NS_LOG_FUNCTION (this);
+  LatenessStatistics statistics;
+  statistics.events = m_latenessCount;
+  statistics.lateEvents = m_latenessCount - m_latenessHistogram[0];
+  statistics.hardLimitExceeded = m_hardLimitExceeded;
+  statistics.mean = TimeStep (m_latenessCount > 0 ? std::llround (m_latenessSum / m_latenessCount) : 0);
+  statistics.percentile99 = GetLatenessPercentile (99);
+  statistics.max = TimeStep (m_latenessMax);
+  return statistics;
+}
+
+Time
+RealtimeSimulatorImpl::GetLatenessPercentile (double percentile) const
+{
+  NS_LOG_FUNCTION (this << percentile);
+  if (m_latenessCount == 0)
+    {
+      return TimeStep (0);
+    }
+  double rank = std::min (std::max (percentile, 0.0), 100.0) / 100 * m_latenessCount;
+  double below = 0;
+  for (uint32_t bin = 0; bin < 64; ++bin)
+    {
+      if (m_latenessHistogram[bin] == 0 || below + m_latenessHistogram[bin] < rank)
+        {
+          below += m_latenessHistogram[bin];
+          continue;
+        }
+      if (bin == 0)
+        {
+          return TimeStep (0);
+        }
+      // Interpolate in [2^(bin-1), 2^bin), bounded by the maximum.
+      double low = std::ldexp (1.0, bin - 1);
+      double high = std::min (std::ldexp (1.0, bin), static_cast<double> (m_latenessMax));
+      double fraction = (rank - below) / m_latenessHistogram[bin];
+      return TimeStep (std::llround (low + fraction * std::max (high - low, 0.0)));
+    }
+  return TimeStep (m_latenessMax);
+}
+
+void
+RealtimeSimulatorImpl::ResetLatenessStatistics (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::fill (m_latenessHistogram, m_latenessHistogram + 64, 0);
+  m_latenessCount = 0;
+  m_latenessSum = 0;
+  m_latenessMax = 0;
+  m_hardLimitExceeded = 0;
+}
+
 } // namespace ns3
@@ -30,7 +30,9 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "traced-callback.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -52,6 +54,16 @@ namespace ns3 {
  * \ingroup realtime
  *
  * Realtime version of SimulatorImpl.
+ *
+ * Events scheduled by other threads, such as the readers of
+ * emulated devices, are pushed without locking to an inbox, which
+ * the simulation thread moves to the event list before choosing the
+ * next event: the scheduling threads never wait for the simulation
+ * thread.
+ *
+ * The lateness of each event, how long after its time on the wall
+ * clock it is run, is reported by the \c Lateness trace source and
+ * summarized by GetLatenessStatistics().
  */
 class RealtimeSimulatorImpl : public SimulatorImpl
 {
@@ -84,6 +96,24 @@ public:
     SYNC_HARD_LIMIT,
   };
 
+  /** Summary of the lateness of the events. */
+  struct LatenessStatistics
+  {
+    uint64_t events;             //!< Number of events run.
+    uint64_t lateEvents;         //!< Number of events run after their time.
+    uint64_t hardLimitExceeded;  //!< Number of events later than the hard limit.
+    Time mean;                   //!< Mean lateness.
+    Time percentile99;           //!< 99th percentile of the lateness.
+    Time max;                    //!< Maximum lateness.
+  };
+
+  /**
+   * TracedCallback signature for the lateness of an event.
+   *
+   * \param [in] lateness How long after its time the event is run.
+   */
+  typedef void (* LatenessTracedCallback)(Time lateness);
+
   /** Constructor. */
   RealtimeSimulatorImpl ();
   /** Destructor. */
@@ -156,6 +186,26 @@ public:
    */
   Time GetHardLimit (void) const;
 
+  /**
+   * Get the statistics of the lateness of the events run since the
+   * simulator started, or since the last ResetLatenessStatistics().
+   *
+   * The percentiles are estimated from a histogram with one bin per
+   * power of two time steps.
+   *
+   * \returns The lateness statistics.
+   */
+  LatenessStatistics GetLatenessStatistics (void) const;
+  /**
+   * Estimate a percentile of the lateness of the events.
+   *
+   * \param [in] percentile The percentile, between 0 and 100.
+   * \returns The estimated lateness.
+   */
+  Time GetLatenessPercentile (double percentile) const;
+  /** Clear the lateness statistics. */
+  void ResetLatenessStatistics (void);
+
 private:
   /**
    * Is the simulator running?
@@ -174,6 +224,25 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Queue an event scheduled by another thread.
+   *
+   * \param [in] context The event context.
+   * \param [in] delay The delay, from the current real time.
+   * \param [in] event The event.
+   */
+  void PushInbox (uint32_t context, const Time &delay, EventImpl *event);
+  /**
+   * Move the events queued by other threads to the event list.
+   * Should be called by the simulation thread, with #m_mutex locked.
+   */
+  void DrainInbox (void);
+  /**
+   * Update the lateness statistics.
+   *
+   * \param [in] tsNow The current real time.
+   */
+  void RecordLateness (uint64_t tsNow);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -184,7 +253,17 @@ private:
   /** Has the stopping condition been reached? */
   bool m_stop;
   /** Is the simulator currently running. */
-  bool m_running;
+  std::atomic<bool> m_running;
+
+  /** An event scheduled by another thread. */
+  struct InboxEvent
+  {
+    Scheduler::Event ev;  //!< The event, without its uid.
+    bool relative;        //!< Whether the timestamp is relative to the current event.
+    InboxEvent *next;     //!< The previous event of the inbox.
+  };
+  /** The events scheduled by other threads, last first. */
+  std::atomic<InboxEvent *> m_inbox;
 
   /**
    * \name Mutex-protected variables.
@@ -222,6 +301,29 @@ private:
 
   /** Main SystemThread. */
   SystemThread::ThreadId m_main;
+
+  /**
+   * \name Lateness statistics.
+   *
+   * Only used by the simulation thread.
+   */
+  /**@{*/
+  /** Number of events with a lateness in [2^(i-1), 2^i) time steps, or 0 for i = 0. */
+  uint64_t m_latenessHistogram[64];
+  /** Number of events run. */
+  uint64_t m_latenessCount;
+  /** Sum of the lateness, in time steps. */
+  double m_latenessSum;
+  /** Maximum lateness, in time steps. */
+  uint64_t m_latenessMax;
+  /** Number of events later than the hard limit. */
+  uint64_t m_hardLimitExceeded;
+  /**@}*/
+
+  /** Trace of the lateness of each event. */
+  TracedCallback<Time> m_latenessTrace;
+  /** Trace of the lateness of the events later than the hard limit. */
+  TracedCallback<Time> m_hardLimitExceededTrace;
 };
 
 } // namespace ns3
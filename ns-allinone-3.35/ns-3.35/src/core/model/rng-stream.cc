@@ -389,6 +389,12 @@ RngStream::RngStream (const RngStream& r)
     }
 }
 
+void
+RngStream::AdvanceSubstreams (uint64_t n)
+{
+  AdvanceNthBy (n, 76, m_currentState);
+}
+
 void
 RngStream::AdvanceNthBy (uint64_t nth, int by, double state[6])
 {
@@ -70,6 +70,12 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Jump to the same position in a later sub-stream.
+   *
+   * \param [in] n The number of sub-streams to skip.
+   */
+  void AdvanceSubstreams (uint64_t n);
 
 private:
   /**
@@ -110,6 +110,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> LadderScheduler </td>
+ *      <td class="markdownTableBodyLeft"> `std::vector []` rungs </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> Constant </td>
+ *      <td class="markdownTableBodyLeft"> 24 bytes per bucket </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> ListScheduler </td>
  *      <td class="markdownTableBodyLeft"> `std::list` </td>
  *      <td class="markdownTableBodyLeft"> Linear </td>
@@ -137,6 +145,9 @@ class EventImpl;
  *
  * It is possible to change the Scheduler choice during a simulation,
  * via Simulator::SetScheduler.
+ * The AdaptiveScheduler makes this choice automatically: it times the
+ * other Schedulers on the events of the first part of the run, and
+ * keeps the fastest.
  *
  * The Scheduler base class specifies the interface used to maintain the
  * event list. If you want to provide a new event list scheduler,
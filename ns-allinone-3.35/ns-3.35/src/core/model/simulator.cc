@@ -24,6 +24,7 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -152,6 +153,10 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Get ()->Flush ();
+    }
 }
 
 void
@@ -173,6 +178,7 @@ Simulator::Run (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   Time::ClearMarkedTimes ();
+  EventProfiler::Get ()->Configure ();
   GetImpl ()->Run ();
 }
 
@@ -287,6 +287,7 @@ Time::SetResolution (enum Unit unit, struct Resolution *resolution,
           info->toMul = true;
           info->fromMul = false;
         }
+      info->maxToMul = info->toMul ? std::numeric_limits<int64_t>::max () / factor : 0;
     }
   resolution->unit = unit;
 }
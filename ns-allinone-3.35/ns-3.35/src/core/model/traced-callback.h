@@ -22,6 +22,7 @@
 #define TRACED_CALLBACK_H
 
 #include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +47,19 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * The chain is stored contiguously, and calling a TracedCallback with
+ * no Callback connected costs a single inline test.  A caller which
+ * has to build the arguments of the trace, e.g. a copy of a packet,
+ * should check IsEmpty() first, to skip building them when nothing
+ * is connected:
+ *
+ * \code
+ *   if (!m_rxTrace.IsEmpty ())
+ *     {
+ *       m_rxTrace (packet->Copy (), m_node->GetObject<Ipv4> ());
+ *     }
+ * \endcode
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -91,6 +105,10 @@ public:
   void operator() (Ts... args) const;
   /**
    * \brief Checks if the Callbacks list is empty.
+   *
+   * This is the inline check which lets callers skip building the
+   * arguments of the trace when nothing is connected.
+   *
    * \return true if the Callbacks list is empty.
    */
   bool IsEmpty () const;
@@ -112,9 +130,18 @@ private:
    *
    * \tparam Ts \deduced Types of the functor arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  typedef std::vector<Callback<void,Ts...> > CallbackList;
+  /**
+   * The chain of Callbacks.
+   *
+   * The Callbacks disconnected while the chain is called are only
+   * nullified, and removed from the chain once the call is over.
+   */
+  mutable CallbackList m_callbackList;
+  /** The number of calls of the chain in progress. */
+  mutable uint32_t m_calling;
+  /** Whether Callbacks were disconnected during a call of the chain. */
+  mutable bool m_disconnected;
 };
 
 } // namespace ns3
@@ -128,7 +155,9 @@ namespace ns3 {
 
 template<typename... Ts>
 TracedCallback<Ts...>::TracedCallback ()
-  : m_callbackList ()
+  : m_callbackList (),
+    m_calling (0),
+    m_disconnected (false)
 {}
 template<typename... Ts>
 void
@@ -160,14 +189,20 @@ TracedCallback<Ts...>::DisconnectWithoutContext (const CallbackBase & callback)
   for (typename CallbackList::iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); /* empty */)
     {
-      if ((*i).IsEqual (callback))
+      if ((*i).IsNull () || !(*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
+          i++;
         }
-      else
+      else if (m_calling > 0)
         {
+          (*i).Nullify ();
+          m_disconnected = true;
           i++;
         }
+      else
+        {
+          i = m_callbackList.erase (i);
+        }
     }
 }
 template<typename... Ts>
@@ -186,10 +221,34 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(args...);
+      return;
+    }
+  // Index the chain, rather than iterate it, and hold the Callback
+  // being invoked, since it can connect Callbacks, which moves the
+  // chain, or disconnect itself.
+  m_calling++;
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          Callback<void,Ts...> cb = m_callbackList[i];
+          cb (args...);
+        }
+    }
+  if (--m_calling == 0 && m_disconnected)
+    {
+      typename CallbackList::iterator i = m_callbackList.begin ();
+      for (typename CallbackList::iterator j = m_callbackList.begin (); j != m_callbackList.end (); j++)
+        {
+          if (!(*j).IsNull ())
+            {
+              *i++ = *j;
+            }
+        }
+      m_callbackList.erase (i, m_callbackList.end ());
+      m_disconnected = false;
     }
 }
 
@@ -20,6 +20,7 @@
 #include "ns3/callback.h"
 #include "ns3/unused.h"
 #include <stdint.h>
+#include <string>
 
 using namespace ns3;
 
@@ -739,6 +740,64 @@ MakeCallbackTemplatesTestCase::DoRun (void)
   that.CheckParentalRights ();
 }
 
+// ===========================================================================
+// Test Callbacks made from lambdas
+// ===========================================================================
+class LambdaCallbackTestCase : public TestCase
+{
+public:
+  LambdaCallbackTestCase ();
+  virtual ~LambdaCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LambdaCallbackTestCase::LambdaCallbackTestCase ()
+  : TestCase ("Check Callbacks made from lambdas")
+{}
+
+void
+LambdaCallbackTestCase::DoRun (void)
+{
+  int sum = 0;
+  Callback<void, int> target1 = [&sum] (int a) { sum += a; };
+  Callback<void, int> copy = target1;
+  target1 (1);
+  copy (2);
+  NS_TEST_ASSERT_MSG_EQ (sum, 3, "Callback did not fire");
+  NS_TEST_ASSERT_MSG_EQ (target1.IsEqual (copy), true, "Copy of a Callback not equal");
+
+  Callback<void, int> target2 = [&sum] (int a) { sum += a; };
+  NS_TEST_ASSERT_MSG_EQ (target1.IsEqual (target2), false, "Callbacks of different lambdas equal");
+
+  Callback<int, int, int> target3 = [] (int a, int b) { return a * b; };
+  NS_TEST_ASSERT_MSG_EQ (target3 (6, 7), 42, "Callback did not return the value");
+
+  //
+  // Bind a context, as TracedCallback::Connect does, and check that it
+  // is passed to each call.
+  //
+  std::string context;
+  Callback<void, std::string, int> target4 = [&context, &sum] (std::string c, int a) { context = c; sum += a; };
+  Callback<void, int> bound = target4.Bind (std::string ("/NodeList/0/DeviceList/0"));
+  bound (4);
+  bound (5);
+  NS_TEST_ASSERT_MSG_EQ (context, "/NodeList/0/DeviceList/0", "Bound context not passed");
+  NS_TEST_ASSERT_MSG_EQ (sum, 12, "Bound Callback did not fire");
+
+  //
+  // Make and release many Callbacks, which recycles their memory.
+  //
+  for (int i = 0; i < 1000; i++)
+    {
+      Callback<void, int> cb = [&sum, i] (int a) { sum += a - i; };
+      cb (i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (sum, 12, "Recycled Callbacks did not fire");
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -756,6 +815,7 @@ CallbackTestSuite::CallbackTestSuite ()
   AddTestCase (new MakeBoundCallbackTestCase, TestCase::QUICK);
   AddTestCase (new NullifyCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeCallbackTemplatesTestCase, TestCase::QUICK);
+  AddTestCase (new LambdaCallbackTestCase, TestCase::QUICK);
 }
 
 static CallbackTestSuite CallbackTestSuite;
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/checkpoint.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * Checkpoint test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Check the branches of a checkpoint resume from the state of the
+ * simulation, with independent random values.
+ */
+class CheckpointForkTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CheckpointForkTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** Periodic event. */
+  void Tick (void);
+  /**
+   * Get the file of the results of a branch.
+   * \param [in] branch The branch.
+   * \returns The file name.
+   */
+  std::string GetFilename (uint32_t branch);
+
+  /** Number of ticks. */
+  uint32_t m_ticks;
+};
+
+CheckpointForkTestCase::CheckpointForkTestCase ()
+  : TestCase ("Check the branches of a checkpoint"),
+    m_ticks (0)
+{}
+
+void
+CheckpointForkTestCase::Tick (void)
+{
+  ++m_ticks;
+  Simulator::Schedule (MilliSeconds (1), &CheckpointForkTestCase::Tick, this);
+}
+
+std::string
+CheckpointForkTestCase::GetFilename (uint32_t branch)
+{
+  std::ostringstream oss;
+  oss << "checkpoint-branch-" << branch;
+  return CreateTempDirFilename (oss.str ());
+}
+
+void
+CheckpointForkTestCase::DoRun (void)
+{
+  const uint32_t nBranches = 3;
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  Simulator::ScheduleNow (&CheckpointForkTestCase::Tick, this);
+  Simulator::Stop (MicroSeconds (9500));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 10, "Wrong number of ticks before the checkpoint");
+
+  uint32_t branch;
+  if (Checkpoint::Fork (nBranches, branch, 2))
+    {
+      Simulator::Stop (MilliSeconds (10));
+      Simulator::Run ();
+      {
+        std::ofstream os (GetFilename (branch).c_str ());
+        os.precision (17);
+        os << m_ticks << " " << Simulator::Now ().GetMicroSeconds () << " " << random->GetValue () << std::endl;
+      }
+      // Leave the test runner to the calling process.
+      _exit (0);
+    }
+
+  const std::vector<int> &status = Checkpoint::GetExitStatus ();
+  NS_TEST_ASSERT_MSG_EQ (status.size (), nBranches, "Wrong number of branches");
+  std::vector<double> values;
+  for (uint32_t i = 0; i < nBranches; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (status[i], 0, "Branch " << i << " failed");
+      std::ifstream is (GetFilename (i).c_str ());
+      uint32_t ticks = 0;
+      int64_t now = 0;
+      double value = -1;
+      is >> ticks >> now >> value;
+      NS_TEST_EXPECT_MSG_EQ (ticks, 20, "Wrong number of ticks in branch " << i);
+      NS_TEST_EXPECT_MSG_EQ (now, 19500, "Wrong stop time in branch " << i);
+      values.push_back (value);
+    }
+  NS_TEST_EXPECT_MSG_EQ (values[0], random->GetValue (), "Branch 0 should keep the random values");
+  NS_TEST_EXPECT_MSG_NE (values[1], values[0], "Branch 1 should draw other random values");
+  NS_TEST_EXPECT_MSG_NE (values[2], values[1], "Branch 2 should draw other random values");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup core-tests
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  CheckpointTestSuite ()
+    : TestSuite ("checkpoint")
+  {
+    AddTestCase (new CheckpointForkTestCase ());
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * CheckpointTestSuite instance variable.
+ */
+static CheckpointTestSuite g_checkpointTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
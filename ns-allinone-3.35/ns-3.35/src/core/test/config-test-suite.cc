@@ -27,6 +27,7 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
@@ -840,6 +841,106 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * An object with a map of objects, with sparse keys.
+ */
+class ConfigMapTestObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /** The MapItems attribute target. */
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_items;
+};
+
+TypeId
+ConfigMapTestObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ConfigMapTestObject")
+    .SetParent<Object> ()
+    .AddAttribute ("MapItems", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigMapTestObject::m_items),
+                   MakeObjectMapChecker<ConfigTestObject> ())
+  ;
+  return tid;
+}
+
+/**
+ * \ingroup config-tests
+ * Test that the paths with indices of large containers resolve to the
+ * same objects, whether the entries are found by index or not.
+ */
+class LargeContainerConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  LargeContainerConfigTestCase ();
+  /** Destructor. */
+  virtual ~LargeContainerConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LargeContainerConfigTestCase::LargeContainerConfigTestCase ()
+  : TestCase ("Check the resolution of indices in large vectors and maps of Object")
+{}
+
+void
+LargeContainerConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("LargeContainerRoot", root);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (objects.back ());
+    }
+
+  Config::MatchContainer m = Config::LookupMatches ("/Names/LargeContainerRoot/NodesA/999");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 1, "Index not found");
+  NS_TEST_EXPECT_MSG_EQ (m.Get (0), objects[999], "Wrong object");
+  NS_TEST_EXPECT_MSG_EQ (m.GetMatchedPath (0), "/Names/LargeContainerRoot/NodesA/999/", "Wrong path");
+  m = Config::LookupMatches ("/Names/LargeContainerRoot/NodesA/1000");
+  NS_TEST_EXPECT_MSG_EQ (m.GetN (), 0, "Index out of range found");
+  m = Config::LookupMatches ("/Names/LargeContainerRoot/NodesA/7|[3-5]|5");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 4, "Wrong number of indices");
+  NS_TEST_EXPECT_MSG_EQ (m.Get (0), objects[3], "Indices not sorted");
+  NS_TEST_EXPECT_MSG_EQ (m.Get (3), objects[7], "Indices not sorted");
+  m = Config::LookupMatches ("/Names/LargeContainerRoot/NodesA/[100-899]");
+  NS_TEST_EXPECT_MSG_EQ (m.GetN (), 800, "Wrong number of indices in a large range");
+  m = Config::LookupMatches ("/Names/LargeContainerRoot/NodesA/*");
+  NS_TEST_EXPECT_MSG_EQ (m.GetN (), 1000, "Wrong number of objects");
+
+  Ptr<ConfigMapTestObject> map = CreateObject<ConfigMapTestObject> ();
+  Names::Add ("LargeContainerMap", map);
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      map->m_items[i * 3 + 1] = objects[i];
+    }
+  m = Config::LookupMatches ("/Names/LargeContainerMap/MapItems/2998");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 1, "Key not found");
+  NS_TEST_EXPECT_MSG_EQ (m.Get (0), objects[999], "Wrong object");
+  m = Config::LookupMatches ("/Names/LargeContainerMap/MapItems/[0-9]");
+  NS_TEST_ASSERT_MSG_EQ (m.GetN (), 3, "Wrong number of keys");
+  NS_TEST_EXPECT_MSG_EQ (m.GetMatchedPath (2), "/Names/LargeContainerMap/MapItems/7/", "Wrong path");
+  m = Config::LookupMatches ("/Names/LargeContainerMap/MapItems/*/A");
+  NS_TEST_EXPECT_MSG_EQ (m.GetN (), 0, "Attribute A is not an object");
+
+  Config::Set ("/Names/LargeContainerMap/MapItems/4/A", IntegerValue (7));
+  IntegerValue iv;
+  objects[1]->GetAttribute ("A", iv);
+  NS_TEST_EXPECT_MSG_EQ (iv.Get (), 7, "Object Attribute \"A\" not set as expected");
+  Names::Clear ();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +959,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new LargeContainerConfigTestCase);
 }
 
 /**
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/event-profiler.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * EventProfiler test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Check the events are profiled by handler and context.
+ */
+class EventProfilerTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EventProfilerTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /** Schedule the events of the test. */
+  void ScheduleEvents (void);
+  /** A handler without arguments. */
+  void Fast (void);
+  /**
+   * A handler with an argument.
+   * \param [in] n An argument.
+   */
+  void Slow (uint32_t n);
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the profile of the events")
+{}
+
+void
+EventProfilerTestCase::Fast (void)
+{}
+
+void
+EventProfilerTestCase::Slow (uint32_t n)
+{}
+
+void
+EventProfilerTestCase::ScheduleEvents (void)
+{
+  for (uint32_t i = 0; i < 8; ++i)
+    {
+      Simulator::ScheduleWithContext (1, MicroSeconds (i), &EventProfilerTestCase::Fast, this);
+    }
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Simulator::ScheduleWithContext (2, MicroSeconds (i), &EventProfilerTestCase::Slow, this, i);
+    }
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  EventProfiler *profiler = EventProfiler::Get ();
+  profiler->Enable (1);
+  ScheduleEvents ();
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetEventCount (), 12, "Wrong number of events");
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetSampleCount (), 12, "Every event should be sampled");
+  std::map<std::string, EventProfiler::Entry> handlers = profiler->GetHandlers ();
+  NS_TEST_ASSERT_MSG_EQ (handlers.size (), 2, "Wrong number of handlers");
+  for (std::map<std::string, EventProfiler::Entry>::const_iterator i = handlers.begin (); i != handlers.end (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_NE (i->first.find ("EventProfilerTestCase::*"), std::string::npos,
+                             "Wrong handler name " << i->first);
+      bool slow = i->first.find ("(unsigned int)") != std::string::npos;
+      NS_TEST_EXPECT_MSG_EQ (i->second.samples, (slow ? 4 : 8), "Wrong count of " << i->first);
+    }
+  std::map<uint32_t, EventProfiler::Entry> contexts = profiler->GetContexts ();
+  NS_TEST_ASSERT_MSG_EQ (contexts.size (), 2, "Wrong number of contexts");
+  NS_TEST_EXPECT_MSG_EQ (contexts[1].samples, 8, "Wrong count of context 1");
+  NS_TEST_EXPECT_MSG_EQ (contexts[2].samples, 4, "Wrong count of context 2");
+
+  std::ostringstream collapsed;
+  profiler->WriteCollapsed (collapsed);
+  std::istringstream lines (collapsed.str ());
+  std::string line;
+  uint32_t nLines = 0;
+  while (std::getline (lines, line))
+    {
+      NS_TEST_EXPECT_MSG_EQ (line.compare (0, 5, "node "), 0, "Wrong collapsed stack " << line);
+      ++nLines;
+    }
+  NS_TEST_EXPECT_MSG_EQ (nLines, 2, "Wrong number of collapsed stacks");
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (profiler->GetEventCount (), 0, "The profile should be reset by Destroy");
+
+  // Sample one event out of four on average, and write the profile at Destroy.
+  std::string filename = CreateTempDirFilename ("event-profile.json");
+  profiler->Enable (4, filename);
+  ScheduleEvents ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (profiler->GetEventCount (), 12, "Wrong number of events");
+  NS_TEST_EXPECT_MSG_LT (profiler->GetSampleCount (), 12, "Too many samples");
+  Simulator::Destroy ();
+  profiler->Disable ();
+
+  std::ifstream json (filename.c_str ());
+  std::ostringstream content;
+  content << json.rdbuf ();
+  NS_TEST_EXPECT_MSG_NE (content.str ().find ("\"sample_period\" : 4"), std::string::npos,
+                         "Wrong JSON profile " << content.str ());
+  NS_TEST_EXPECT_MSG_NE (content.str ().find ("\"handlers\""), std::string::npos,
+                         "Wrong JSON profile " << content.str ());
+}
+
+/**
+ * \ingroup core-tests
+ * EventProfiler test suite.
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler")
+  {
+    AddTestCase (new EventProfilerTestCase ());
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * EventProfilerTestSuite instance variable.
+ */
+static EventProfilerTestSuite g_eventProfilerTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
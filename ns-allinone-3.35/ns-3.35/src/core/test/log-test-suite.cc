@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+/**
+ * \file
+ * \ingroup logging-tests
+ * Log buffer, log report and log allow list test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging test suite
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuite");
+
+/**
+ * \ingroup logging-tests
+ *
+ * A value formatted at once in the log buffer, which changes the
+ * format state of the stream.
+ */
+struct LogTestValue
+{
+  int value;  //!< The value.
+};
+
+/**
+ * Output streamer for LogTestValue.
+ * \param [in,out] os The output stream.
+ * \param [in] v The value.
+ * \returns The output stream.
+ */
+std::ostream &
+operator<< (std::ostream &os, const LogTestValue &v)
+{
+  return os << "<" << v.value << ">" << std::setprecision (3);
+}
+
+/**
+ * Write log statements, as the NS_LOG macros do.
+ */
+static void
+WriteLogStatements (void)
+{
+  for (int i = 0; i < 20; i++)
+    {
+      LogStream stream (g_log);
+      std::clog << "+" << i << ".0s ";
+      stream << "value " << i << " " << -i * 1000000000LL << " "
+             << std::hex << std::showbase << 255u << std::dec << " "
+             << std::setw (8) << std::setfill ('.') << 3.25 << " "
+             << LogTestValue {i} << " " << 1.0 / 3 << " "
+             << std::string ("str") << '!' << true << std::boolalpha << false
+             << std::noboolalpha << static_cast<uint8_t> ('u')
+             << std::setfill (' ') << std::setprecision (6) << std::endl;
+      stream << "Component:Function(";
+      LogParameterStream (stream) << &stream << "a" << static_cast<int8_t> (-3)
+                                  << std::vector<int> {1, 2} << std::string ("b");
+      stream << ")" << std::endl;
+    }
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Check that the log buffer formats the log statements as they are
+ * formatted without it.
+ */
+class LogBufferTestCase : public TestCase
+{
+public:
+  LogBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogBufferTestCase::LogBufferTestCase ()
+  : TestCase ("Check that the log buffer formats as the log statements")
+{}
+
+void
+LogBufferTestCase::DoRun (void)
+{
+  std::streambuf *clog = std::clog.rdbuf ();
+
+  std::ostringstream direct;
+  std::clog.rdbuf (direct.rdbuf ());
+  WriteLogStatements ();
+  std::clog.copyfmt (std::ios (0));
+
+  // A small buffer, to be flushed several times.
+  std::ostringstream buffered;
+  std::clog.rdbuf (buffered.rdbuf ());
+  LogBufferEnable (1000);
+  WriteLogStatements ();
+  LogBufferDisable ();
+  std::clog.copyfmt (std::ios (0));
+
+  std::ostringstream flushed;
+  std::clog.rdbuf (flushed.rdbuf ());
+  LogBufferEnable ();
+  WriteLogStatements ();
+  NS_TEST_EXPECT_MSG_EQ (flushed.str ().empty (), true, "Log statements not deferred");
+  LogBufferFlush ();
+  LogBufferDisable ();
+  std::clog.copyfmt (std::ios (0));
+
+  std::clog.rdbuf (clog);
+  NS_TEST_EXPECT_MSG_EQ (buffered.str (), direct.str (), "Wrong buffered log statements");
+  NS_TEST_EXPECT_MSG_EQ (flushed.str (), direct.str (), "Wrong flushed log statements");
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Check the bytes and statements of the log report.
+ */
+class LogReportTestCase : public TestCase
+{
+public:
+  LogReportTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogReportTestCase::LogReportTestCase ()
+  : TestCase ("Check the bytes and statements of the log report")
+{}
+
+void
+LogReportTestCase::DoRun (void)
+{
+  std::streambuf *clog = std::clog.rdbuf ();
+  std::ostringstream output;
+  std::clog.rdbuf (output.rdbuf ());
+
+  LogReportEnable ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      LogStream (g_log) << "0123456789" << std::endl;
+    }
+  LogBufferEnable ();
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      LogStream (g_log) << "0123456789" << std::endl;
+    }
+  LogBufferDisable ();
+  LogReportDisable ();
+
+  std::clog.rdbuf (clog);
+  NS_TEST_EXPECT_MSG_EQ (output.str ().size (), 55, "Wrong log output");
+  std::ostringstream report;
+  LogComponentPrintReport (report);
+  std::string line = report.str ();
+  std::string::size_type pos = line.find ("  LogTestSuite\n");
+  NS_TEST_ASSERT_MSG_NE (pos, std::string::npos, "Component not in report " << line);
+  line = line.substr (line.rfind ('\n', pos) + 1, pos - line.rfind ('\n', pos) - 1);
+  std::istringstream is (line);
+  uint64_t bytes = 0;
+  double percent = 0;
+  uint64_t statements = 0;
+  is >> bytes >> percent >> statements;
+  NS_TEST_EXPECT_MSG_EQ (bytes, 55, "Wrong bytes in " << line);
+  NS_TEST_EXPECT_MSG_EQ (statements, 5, "Wrong statements in " << line);
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Check the log levels selected at compile time by LogAllowedLevels().
+ */
+class LogAllowTestCase : public TestCase
+{
+public:
+  LogAllowTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogAllowTestCase::LogAllowTestCase ()
+  : TestCase ("Check the log levels allowed at compile time")
+{}
+
+void
+LogAllowTestCase::DoRun (void)
+{
+  static_assert (LogAllowedLevels ("Foo", "Foo") == LOG_LEVEL_ALL,
+                 "LogAllowedLevels is not a constant expression");
+  const char *list = "Foo=info|warn|prefix_time:Bar=level_debug|func:Foo2:*=error";
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Foo", list), (LOG_INFO | LOG_WARN | LOG_ERROR),
+                         "Wrong levels of Foo");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Bar", list), LOG_LEVEL_DEBUG, "Wrong levels of Bar");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Foo2", list), LOG_LEVEL_ALL, "Wrong levels of Foo2");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Fo", list), LOG_ERROR, "Wrong levels of Fo");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Baz", "Foo:Bar=all|all"), LOG_NONE,
+                         "Wrong levels of Baz");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Bar", "Bar=all|all"), LOG_LEVEL_ALL,
+                         "Wrong levels of Bar=all|all");
+  NS_TEST_EXPECT_MSG_EQ (LogAllowedLevels ("Bar", "Bar=time|all"), LOG_NONE,
+                         "Wrong levels of Bar=time|all");
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * Log TestSuite
+ */
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log", UNIT)
+{
+  AddTestCase (new LogBufferTestCase, TestCase::QUICK);
+  AddTestCase (new LogReportTestCase, TestCase::QUICK);
+  AddTestCase (new LogAllowTestCase, TestCase::QUICK);
+}
+
+static LogTestSuite g_logTestSuite; //!< Static variable for test initialization
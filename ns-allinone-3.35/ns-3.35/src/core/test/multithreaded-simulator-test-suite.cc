@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulator tests
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Run a ring of contexts exchanging messages, sequentially and with
+ * one logical process per context, and check the traces match.
+ */
+class MultithreadedRingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] threads The number of threads.
+   */
+  MultithreadedRingTestCase (uint32_t threads);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the ring.
+   * \param [in] impl The simulator implementation.
+   * \returns The times of the events, per context.
+   */
+  std::vector<std::vector<int64_t> > RunRing (Ptr<SimulatorImpl> impl);
+  /**
+   * Receive a message and forward it to the next context.
+   * \param [in] hops The number of hops left.
+   */
+  void Receive (uint32_t hops);
+  /** Local event, scheduled within a context. */
+  void Local (void);
+
+  /** Number of contexts in the ring. */
+  static const uint32_t N_CONTEXTS = 4;
+  /** The number of threads. */
+  uint32_t m_threads;
+  /** The times of the events, per context. */
+  std::vector<std::vector<int64_t> > m_trace;
+};
+
+MultithreadedRingTestCase::MultithreadedRingTestCase (uint32_t threads)
+  : TestCase ("Check a ring of messages over logical processes"),
+    m_threads (threads)
+{}
+
+void
+MultithreadedRingTestCase::Receive (uint32_t hops)
+{
+  uint32_t context = Simulator::GetContext ();
+  m_trace[context].push_back (Simulator::Now ().GetNanoSeconds ());
+  Simulator::Schedule (MicroSeconds (10 * (context + 1)), &MultithreadedRingTestCase::Local, this);
+  if (hops > 0)
+    {
+      uint32_t next = (context + 1) % N_CONTEXTS;
+      Simulator::ScheduleWithContext (next, MilliSeconds (1) + MicroSeconds (context),
+                                      &MultithreadedRingTestCase::Receive, this, hops - 1);
+    }
+}
+
+void
+MultithreadedRingTestCase::Local (void)
+{
+  m_trace[Simulator::GetContext ()].push_back (-Simulator::Now ().GetNanoSeconds ());
+}
+
+std::vector<std::vector<int64_t> >
+MultithreadedRingTestCase::RunRing (Ptr<SimulatorImpl> impl)
+{
+  m_trace.assign (N_CONTEXTS, std::vector<int64_t> ());
+  Simulator::SetImplementation (impl);
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      Simulator::ScheduleWithContext (i, MicroSeconds (i), &MultithreadedRingTestCase::Receive, this, 20);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_trace;
+}
+
+void
+MultithreadedRingTestCase::DoRun (void)
+{
+  std::vector<std::vector<int64_t> > expected = RunRing (CreateObject<DefaultSimulatorImpl> ());
+
+  Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl> ();
+  impl->SetAttribute ("MaxThreads", UintegerValue (m_threads));
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      impl->SetPartition (i, i);
+    }
+  impl->SetLookahead (MilliSeconds (1));
+  std::vector<std::vector<int64_t> > trace = RunRing (impl);
+
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartitionCount (), N_CONTEXTS, "Wrong number of logical processes");
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (trace[i].size (), expected[i].size (), "Wrong event count for context " << i);
+      NS_TEST_ASSERT_MSG_EQ ((trace[i] == expected[i]), true, "Wrong event times for context " << i);
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Check Simulator::Stop and the clock are consistent
+ * over logical processes.
+ */
+class MultithreadedStopTestCase : public TestCase
+{
+public:
+  MultithreadedStopTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Periodic event, rescheduling itself. */
+  void Tick (void);
+
+  /** Number of ticks. */
+  uint32_t m_ticks;
+  /** Latest tick time. */
+  Time m_last;
+};
+
+MultithreadedStopTestCase::MultithreadedStopTestCase ()
+  : TestCase ("Check Simulator::Stop with logical processes"),
+    m_ticks (0)
+{}
+
+void
+MultithreadedStopTestCase::Tick (void)
+{
+  ++m_ticks;
+  m_last = Simulator::Now ();
+  Simulator::Schedule (MicroSeconds (100), &MultithreadedStopTestCase::Tick, this);
+}
+
+void
+MultithreadedStopTestCase::DoRun (void)
+{
+  Ptr<MultithreadedSimulatorImpl> impl = CreateObject<MultithreadedSimulatorImpl> ();
+  impl->SetAttribute ("MaxThreads", UintegerValue (2));
+  impl->SetPartition (1, 1);
+  impl->SetLookahead (MilliSeconds (1));
+  Simulator::SetImplementation (impl);
+  Simulator::ScheduleWithContext (1, Seconds (0), &MultithreadedStopTestCase::Tick, this);
+  Simulator::Stop (MicroSeconds (1050));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 11, "Wrong number of ticks");
+  NS_TEST_ASSERT_MSG_EQ (m_last, MicroSeconds (1000), "Wrong time of the last tick");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MicroSeconds (1050), "Wrong stop time");
+
+  Simulator::Stop (MicroSeconds (200));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 13, "Wrong number of ticks after resuming");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), MicroSeconds (1250), "Wrong stop time after resuming");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedRingTestCase (1), TestCase::QUICK);
+    AddTestCase (new MultithreadedRingTestCase (4), TestCase::QUICK);
+    AddTestCase (new MultithreadedStopTestCase (), TestCase::QUICK);
+  }
+};
+
+/** Static variable for test initialization. */
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
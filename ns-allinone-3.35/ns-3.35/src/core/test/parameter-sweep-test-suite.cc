@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/csv-reader.h"
+#include "ns3/parameter-sweep.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/test.h"
+
+#include <cstdio>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * ParameterSweep test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Check a sweep runs every configuration, and only the configurations
+ * which did not finish when it is run again.
+ */
+class ParameterSweepTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ParameterSweepTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run the sweep.
+   * \param [in] failing The value of \c alpha whose configurations fail.
+   * \returns The number of configurations run.
+   */
+  uint32_t Sweep (double failing);
+  /**
+   * Read the table of the results.
+   * \returns The rows of the table, header included.
+   */
+  std::vector<std::vector<std::string> > ReadTable (void);
+
+  /** The file of the results. */
+  std::string m_output;
+  /** The file counting the configurations run. */
+  std::string m_count;
+};
+
+ParameterSweepTestCase::ParameterSweepTestCase ()
+  : TestCase ("Check the configurations of a parameter sweep")
+{}
+
+uint32_t
+ParameterSweepTestCase::Sweep (double failing)
+{
+  double alpha = 0;
+  std::string beta = "none";
+  CommandLine cmd;
+  cmd.AddValue ("alpha", "A number", alpha);
+  cmd.AddValue ("beta", "A word", beta);
+  ParameterSweep sweep;
+  sweep.AddCommandLineOptions (cmd);
+  sweep.SetOutput (m_output);
+  sweep.SetMaxConcurrent (2);
+  std::vector<std::string> args;
+  args.push_back ("parameter-sweep");
+  args.push_back ("--sweep=alpha=0.1:0.3:0.1;beta=x,y");
+  args.push_back ("--sweepRuns=3:4");
+  cmd.Parse (args);
+  NS_TEST_EXPECT_MSG_EQ (sweep.GetConfigurationCount (), 12, "Wrong number of configurations");
+
+  std::remove (m_count.c_str ());
+  if (sweep.Run (cmd))
+    {
+      FILE *count = std::fopen (m_count.c_str (), "a");
+      std::fputc ('.', count);
+      std::fclose (count);
+      if (alpha == failing)
+        {
+          _exit (1);
+        }
+      sweep.Record ("value", alpha * 10 + RngSeedManager::GetRun ());
+      if (beta == "y")
+        {
+          sweep.Record ("word", 1);
+        }
+      sweep.Finish ();
+      // Leave the test runner to the calling process.
+      _exit (0);
+    }
+
+  FILE *count = std::fopen (m_count.c_str (), "r");
+  uint32_t run = 0;
+  if (count != 0)
+    {
+      while (std::fgetc (count) == '.')
+        {
+          ++run;
+        }
+      std::fclose (count);
+    }
+  NS_TEST_EXPECT_MSG_EQ (sweep.GetFailureCount (), (failing == 0.2 ? 4 : 0),
+                         "Wrong number of failed configurations");
+  return run;
+}
+
+std::vector<std::vector<std::string> >
+ParameterSweepTestCase::ReadTable (void)
+{
+  std::vector<std::vector<std::string> > rows;
+  CsvReader csv (m_output);
+  while (csv.FetchNextRow ())
+    {
+      // The reader drops a blank last cell.
+      std::vector<std::string> row (rows.empty () ? csv.ColumnCount () : rows[0].size ());
+      for (uint32_t i = 0; i < csv.ColumnCount () && i < row.size (); ++i)
+        {
+          csv.GetValue (i, row[i]);
+        }
+      rows.push_back (row);
+    }
+  return rows;
+}
+
+void
+ParameterSweepTestCase::DoRun (void)
+{
+  m_output = CreateTempDirFilename ("parameter-sweep.csv");
+  m_count = CreateTempDirFilename ("parameter-sweep.count");
+
+  NS_TEST_ASSERT_MSG_EQ (Sweep (0.2), 12, "All the configurations should run");
+  std::vector<std::vector<std::string> > rows = ReadTable ();
+  NS_TEST_ASSERT_MSG_EQ (rows.size (), 9, "Wrong number of rows");
+  NS_TEST_ASSERT_MSG_EQ (rows[0].size (), 5, "Wrong number of columns");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][0], "alpha", "Wrong column");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][1], "beta", "Wrong column");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][2], "RngRun", "Wrong column");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][3], "value", "Wrong column");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][4], "word", "Wrong column");
+  NS_TEST_EXPECT_MSG_EQ (rows[1][0], "0.1", "Wrong alpha");
+  NS_TEST_EXPECT_MSG_EQ (rows[1][1], "x", "Wrong beta");
+  NS_TEST_EXPECT_MSG_EQ (rows[1][2], "3", "Wrong run");
+  NS_TEST_EXPECT_MSG_EQ (rows[1][3], "4", "Wrong value");
+  NS_TEST_EXPECT_MSG_EQ (rows[1][4], "", "The missing value should be blank");
+  NS_TEST_EXPECT_MSG_EQ (rows[4][1], "y", "Wrong beta");
+  NS_TEST_EXPECT_MSG_EQ (rows[4][2], "4", "Wrong run");
+  NS_TEST_EXPECT_MSG_EQ (rows[4][4], "1", "Wrong value");
+  NS_TEST_EXPECT_MSG_EQ (rows[5][0], "0.3", "The failed configurations should be missing");
+  NS_TEST_EXPECT_MSG_EQ (rows[8][3], "7", "Wrong value");
+
+  NS_TEST_ASSERT_MSG_EQ (Sweep (-1), 4, "Only the failed configurations should run again");
+  rows = ReadTable ();
+  NS_TEST_ASSERT_MSG_EQ (rows.size (), 13, "Wrong number of rows");
+  NS_TEST_EXPECT_MSG_EQ (rows[5][0], "0.2", "Wrong alpha");
+  NS_TEST_EXPECT_MSG_EQ (rows[5][3], "5", "Wrong value");
+
+  NS_TEST_ASSERT_MSG_EQ (Sweep (-1), 0, "All the configurations are finished");
+  NS_TEST_EXPECT_MSG_EQ (ReadTable ().size (), 13, "Wrong number of rows");
+}
+
+/**
+ * \ingroup core-tests
+ * ParameterSweep test suite.
+ */
+class ParameterSweepTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  ParameterSweepTestSuite ()
+    : TestSuite ("parameter-sweep")
+  {
+    AddTestCase (new ParameterSweepTestCase ());
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * ParameterSweepTestSuite instance variable.
+ */
+static ParameterSweepTestSuite g_parameterSweepTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
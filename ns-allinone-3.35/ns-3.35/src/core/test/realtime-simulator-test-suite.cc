@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/realtime-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/callback.h"
+
+#include <atomic>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * RealtimeSimulatorImpl test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Check the events scheduled by another thread are all run once, in
+ * order, and that their lateness is recorded.
+ */
+class RealtimeInboxTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RealtimeInboxTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+private:
+  /** Start the scheduling thread. */
+  void Start (void);
+  /** Schedule the events, from another thread. */
+  void SchedulingThread (void);
+  /**
+   * An event scheduled by the thread.
+   * \param [in] i The event index.
+   */
+  void Received (uint32_t i);
+  /**
+   * Sink of the Lateness trace.
+   * \param [in] lateness The lateness of an event.
+   */
+  void Lateness (Time lateness);
+
+  /** The scheduling thread. */
+  std::thread m_thread;
+  /** The number of events scheduled by the thread which were run. */
+  std::atomic<uint32_t> m_received;
+  /** Whether the events were run in order. */
+  bool m_inOrder;
+  /** The number of events traced. */
+  uint64_t m_traced;
+  /** Whether a traced lateness was negative. */
+  bool m_negative;
+};
+
+/** The number of events scheduled by the thread. */
+static const uint32_t g_inboxEvents = 1000;
+
+RealtimeInboxTestCase::RealtimeInboxTestCase ()
+  : TestCase ("Check the events scheduled by other threads"),
+    m_received (0),
+    m_inOrder (true),
+    m_traced (0),
+    m_negative (false)
+{}
+
+void
+RealtimeInboxTestCase::Start (void)
+{
+  m_thread = std::thread (&RealtimeInboxTestCase::SchedulingThread, this);
+}
+
+void
+RealtimeInboxTestCase::SchedulingThread (void)
+{
+  for (uint32_t i = 0; i < g_inboxEvents; ++i)
+    {
+      Simulator::ScheduleWithContext (i % 4, MicroSeconds (100),
+                                      &RealtimeInboxTestCase::Received, this, i);
+    }
+}
+
+void
+RealtimeInboxTestCase::Received (uint32_t i)
+{
+  if (i != m_received)
+    {
+      m_inOrder = false;
+    }
+  if (Simulator::GetContext () != i % 4)
+    {
+      m_inOrder = false;
+    }
+  ++m_received;
+}
+
+void
+RealtimeInboxTestCase::Lateness (Time lateness)
+{
+  ++m_traced;
+  m_negative |= lateness.IsStrictlyNegative ();
+}
+
+void
+RealtimeInboxTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Ptr<RealtimeSimulatorImpl> impl = DynamicCast<RealtimeSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_EQ ((impl != 0), true, "Not a realtime simulator");
+  impl->TraceConnectWithoutContext ("Lateness", MakeCallback (&RealtimeInboxTestCase::Lateness, this));
+
+  Simulator::Schedule (MilliSeconds (1), &RealtimeInboxTestCase::Start, this);
+  Simulator::Stop (MilliSeconds (200));
+  Simulator::Run ();
+  m_thread.join ();
+
+  RealtimeSimulatorImpl::LatenessStatistics stats = impl->GetLatenessStatistics ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received.load (), g_inboxEvents, "Events were lost");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Events were run out of order");
+  // The start and stop events, and the events of the thread.
+  NS_TEST_EXPECT_MSG_EQ (stats.events, g_inboxEvents + 2, "Wrong number of events");
+  NS_TEST_EXPECT_MSG_EQ (m_traced, stats.events, "Wrong number of traced events");
+  NS_TEST_EXPECT_MSG_EQ (m_negative, false, "Negative lateness");
+  NS_TEST_EXPECT_MSG_EQ ((stats.mean <= stats.max), true, "Mean larger than the maximum");
+  NS_TEST_EXPECT_MSG_EQ ((stats.percentile99 <= stats.max), true, "Percentile larger than the maximum");
+}
+
+void
+RealtimeInboxTestCase::DoTeardown (void)
+{
+  if (m_thread.joinable ())
+    {
+      m_thread.join ();
+    }
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+
+/**
+ * \ingroup core-tests
+ * Check the lateness percentiles.
+ */
+class RealtimeLatenessTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RealtimeLatenessTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+private:
+  /** An event doing nothing. */
+  static void Nothing (void);
+};
+
+RealtimeLatenessTestCase::RealtimeLatenessTestCase ()
+  : TestCase ("Check the lateness percentiles")
+{}
+
+void
+RealtimeLatenessTestCase::Nothing (void)
+{}
+
+void
+RealtimeLatenessTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Ptr<RealtimeSimulatorImpl> impl = DynamicCast<RealtimeSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_EQ ((impl != 0), true, "Not a realtime simulator");
+
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (10 * i), &RealtimeLatenessTestCase::Nothing);
+    }
+  // The realtime simulator only stops when told to.
+  Simulator::Stop (MilliSeconds (2));
+  Simulator::Run ();
+
+  RealtimeSimulatorImpl::LatenessStatistics stats = impl->GetLatenessStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (stats.events, 101, "Wrong number of events");
+  Time previous = Seconds (0);
+  for (double p = 0; p <= 100; p += 10)
+    {
+      Time percentile = impl->GetLatenessPercentile (p);
+      NS_TEST_EXPECT_MSG_EQ ((percentile >= previous), true, "Percentiles should increase");
+      NS_TEST_EXPECT_MSG_EQ ((percentile <= stats.max), true, "Percentile larger than the maximum");
+      previous = percentile;
+    }
+  NS_TEST_EXPECT_MSG_EQ (impl->GetLatenessPercentile (100), stats.max, "Wrong maximum");
+
+  impl->ResetLatenessStatistics ();
+  stats = impl->GetLatenessStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (stats.events, 0, "Statistics not cleared");
+  NS_TEST_EXPECT_MSG_EQ (stats.max, Seconds (0), "Statistics not cleared");
+  Simulator::Destroy ();
+}
+
+void
+RealtimeLatenessTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+
+/**
+ * \ingroup core-tests
+ * RealtimeSimulatorImpl test suite.
+ */
+class RealtimeSimulatorTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RealtimeSimulatorTestSuite ()
+    : TestSuite ("realtime-simulator")
+  {
+    AddTestCase (new RealtimeInboxTestCase ());
+    AddTestCase (new RealtimeLatenessTestCase ());
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * RealtimeSimulatorTestSuite instance variable.
+ */
+static RealtimeSimulatorTestSuite g_realtimeSimulatorTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
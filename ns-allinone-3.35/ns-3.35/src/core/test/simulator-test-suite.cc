@@ -24,6 +24,11 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/adaptive-scheduler.h"
+#include "ns3/uinteger.h"
+
+#include <limits>
 
 using namespace ns3;
 
@@ -170,6 +175,139 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events are removed in order with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  uint64_t state = 1;
+  uint32_t removed = 0;
+  bool first = true;
+  Scheduler::Event last = { 0, { 0, 0, 0 } };
+
+  // Interleave bursts of near-future and far-future insertions,
+  // explicit removals and in-order removals.
+  for (uint32_t round = 0; round < 200; ++round)
+    {
+      std::vector<Scheduler::Event> inserted;
+      for (uint32_t i = 0; i < 100; ++i)
+        {
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          uint64_t delay = (state >> 33) % (i % 4 == 0 ? 1000000 : 100);
+          Scheduler::Event ev = { 0, { now + delay, uid++, 0 } };
+          scheduler->Insert (ev);
+          inserted.push_back (ev);
+        }
+      for (uint32_t i = 0; i < inserted.size (); i += 7)
+        {
+          scheduler->Remove (inserted[i]);
+          ++removed;
+        }
+      for (uint32_t i = 0; i < 80 && !scheduler->IsEmpty (); ++i)
+        {
+          Scheduler::Event next = scheduler->PeekNext ();
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, ev.key.m_uid, "PeekNext and RemoveNext disagree");
+          NS_TEST_ASSERT_MSG_EQ ((ev.key.m_uid % 100 % 7 == 0), false, "Removed event dequeued");
+          NS_TEST_ASSERT_MSG_EQ ((first || last < ev), true, "Event dequeued out of order");
+          first = false;
+          last = ev;
+          now = ev.key.m_ts;
+          ++removed;
+        }
+    }
+  while (!scheduler->IsEmpty ())
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ ((last < ev), true, "Event dequeued out of order");
+      last = ev;
+      ++removed;
+    }
+  NS_TEST_EXPECT_MSG_EQ (removed, uid, "Some events were lost");
+}
+
+class AdaptiveSchedulerTestCase : public TestCase
+{
+public:
+  AdaptiveSchedulerTestCase ();
+  virtual void DoRun (void);
+};
+
+AdaptiveSchedulerTestCase::AdaptiveSchedulerTestCase ()
+  : TestCase ("Check that the AdaptiveScheduler selects the fastest candidate")
+{}
+
+void
+AdaptiveSchedulerTestCase::DoRun (void)
+{
+  ObjectFactory factory ("ns3::AdaptiveScheduler");
+  factory.Set ("SampleSize", UintegerValue (500));
+  factory.Set ("TrialSize", UintegerValue (1000));
+  Ptr<AdaptiveScheduler> scheduler = factory.Create<AdaptiveScheduler> ();
+  uint32_t uid = 0;
+  uint64_t state = 1;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      Scheduler::Event ev = { 0, { (state >> 33) % 10000, uid++, 0 } };
+      scheduler->Insert (ev);
+    }
+
+  // Hold model: each removed event schedules a new one.
+  Scheduler::Event last = { 0, { 0, 0, 0 } };
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ ((i == 0 || last < ev), true, "Event dequeued out of order");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsSelected (), (i >= 499), "Selected at the wrong time");
+      last = ev;
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      Scheduler::Event next = { 0, { ev.key.m_ts + (state >> 33) % 10000, uid++, 0 } };
+      scheduler->Insert (next);
+    }
+
+  std::map<std::string, double> costs = scheduler->GetCosts ();
+  NS_TEST_ASSERT_MSG_EQ (costs.size (), 6, "Every candidate should be timed");
+  std::string best;
+  double bestCost = std::numeric_limits<double>::infinity ();
+  for (std::map<std::string, double>::const_iterator i = costs.begin (); i != costs.end (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_GT (i->second, 0, "Wrong cost for " << i->first);
+      if (i->second < bestCost)
+        {
+          best = i->first;
+          bestCost = i->second;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (scheduler->GetSelectedType ().GetName (), best,
+                         "The fastest candidate should be selected");
+
+  uint32_t removed = 1000;
+  while (!scheduler->IsEmpty ())
+    {
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ ((last < ev), true, "Event dequeued out of order");
+      last = ev;
+      ++removed;
+    }
+  NS_TEST_EXPECT_MSG_EQ (removed, uid, "Some events were lost");
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -483,5 +621,24 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    ObjectFactory adaptive (AdaptiveScheduler::GetTypeId ().GetName ());
+    adaptive.Set ("SampleSize", UintegerValue (5));
+    AddTestCase (new SimulatorEventsTestCase (adaptive), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    adaptive.Set ("SampleSize", UintegerValue (1000));
+    AddTestCase (new SchedulerOrderTestCase (adaptive), TestCase::QUICK);
+    AddTestCase (new AdaptiveSchedulerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -21,6 +21,7 @@
  */
 
 #include <array>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <string>
@@ -29,6 +30,7 @@
 
 #include "ns3/nstime.h"
 #include "ns3/int64x64.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
 using namespace ns3;
@@ -535,6 +537,202 @@ TimeInputOutputTestCase::DoRun (void)
   CheckAs (t * 1e+8, "+9.961925y");
 }
 
+/**
+ * \ingroup core-tests
+ * \brief Check the double precision and integer fast paths of Time
+ * against the int64x64_t arithmetic.
+ */
+class TimeFastPathTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor for TimeFastPathTestCase.
+   */
+  TimeFastPathTestCase ();
+
+private:
+  /**
+   * \brief DoRun for TimeFastPathTestCase.
+   */
+  virtual void DoRun (void);
+};
+
+TimeFastPathTestCase::TimeFastPathTestCase ()
+  : TestCase ("Check the fast paths of time arithmetic")
+{}
+
+void
+TimeFastPathTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (Time::GetResolution (), Time::NS, "Expected the default resolution");
+  const int64x64_t second (1000000000);
+
+  NS_TEST_EXPECT_MSG_EQ (Seconds (0.1), MilliSeconds (100), "0.1s");
+  NS_TEST_EXPECT_MSG_EQ (Time::FromDouble (-2.5, Time::NS), NanoSeconds (-3), "Half way is away from zero");
+  NS_TEST_EXPECT_MSG_EQ (Seconds (1e8), Time (int64x64_t (1e8) * second), "Large values");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (5) * 0.5, NanoSeconds (3), "Half way is away from zero");
+  NS_TEST_EXPECT_MSG_EQ (NanoSeconds (5) / 2.0, NanoSeconds (3), "Half way is away from zero");
+  NS_TEST_EXPECT_MSG_EQ (MicroSeconds (5).To (Time::PS), int64x64_t (5000000), "Integer conversion");
+  NS_TEST_EXPECT_MSG_EQ (Time::Max () * 0.5, Time (int64x64_t (Time::Max ().GetTimeStep ()) * int64x64_t (0.5)),
+                         "Values beyond double precision");
+
+  // Durations of a few hundred microseconds scaled by rates, as in
+  // the PHY models.
+  uint64_t state = 88172645463325252ULL;
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      int64_t steps = static_cast<int64_t> (state % 1000000000) - 500000000;
+      double scale = static_cast<double> (state >> 11) / (1ULL << 53) * 4;
+      Time t (steps);
+
+      NS_TEST_ASSERT_MSG_EQ (t * scale, t * int64x64_t (scale), "Time * double " << steps << " " << scale);
+      NS_TEST_ASSERT_MSG_EQ (t / (scale + 0.25), t / int64x64_t (scale + 0.25),
+                             "Time / double " << steps << " " << scale);
+      double seconds = steps * 1e-9 * scale;
+      NS_TEST_ASSERT_MSG_EQ (Seconds (seconds), Time (int64x64_t (seconds) * second),
+                             "Seconds (" << seconds << ")");
+      NS_TEST_ASSERT_MSG_EQ_TOL (t.GetSeconds (), (int64x64_t (steps) / second).GetDouble (), std::fabs (t.GetSeconds ()) * 1e-13,
+                                 "GetSeconds () " << steps);
+      NS_TEST_ASSERT_MSG_EQ (t.To (Time::PS), int64x64_t (steps) * int64x64_t (1000),
+                             "To (Time::PS) " << steps);
+    }
+}
+
+/**
+ * \ingroup core-tests
+ * \brief Measure the throughput of time arithmetic, with the fast
+ * paths of Time and with the int64x64_t arithmetic they replace.
+ */
+class TimeArithmeticPerformanceTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor for TimeArithmeticPerformanceTestCase.
+   */
+  TimeArithmeticPerformanceTestCase ();
+
+private:
+  /**
+   * \brief DoRun for TimeArithmeticPerformanceTestCase.
+   */
+  virtual void DoRun (void);
+  /**
+   * Time an operation.
+   * \tparam F \deduced The operation type.
+   * \param [in] what The name of the operation.
+   * \param [in] operation The operation, applied to the Times.
+   * \returns The number of operations per second.
+   */
+  template <typename F>
+  double Measure (const std::string & what, F operation);
+
+  /** The Times the operations are applied to. */
+  std::vector<Time> m_times;
+};
+
+TimeArithmeticPerformanceTestCase::TimeArithmeticPerformanceTestCase ()
+  : TestCase ("Measure the throughput of time arithmetic")
+{}
+
+template <typename F>
+double
+TimeArithmeticPerformanceTestCase::Measure (const std::string & what, F operation)
+{
+  const uint32_t repetitions = 200;
+  int64_t sum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (uint32_t r = 0; r < repetitions; ++r)
+    {
+      for (std::vector<Time>::const_iterator i = m_times.begin (); i != m_times.end (); ++i)
+        {
+          sum += operation (*i);
+        }
+    }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+  double rate = repetitions * m_times.size () / elapsed.count ();
+  std::cout << GetParent ()->GetName () << ": " << std::left << std::setw (28) << what
+            << std::right << std::setw (12) << std::fixed << std::setprecision (0) << rate
+            << " op/s  (" << sum % 10 << ")" << std::endl;
+  return rate;
+}
+
+void
+TimeArithmeticPerformanceTestCase::DoRun (void)
+{
+  uint64_t state = 88172645463325252ULL;
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      m_times.push_back (NanoSeconds (state % 10000000));
+    }
+  const double scale = 1.0 / 3;
+  const int64x64_t second (1000000000);
+
+  struct Comparison
+  {
+    double before;
+    double after;
+  } comparison[5];
+
+  // Only the first Run () stops the tracking of the Times for
+  // resolution changes, which would dominate the measurements.
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  comparison[0].before = Measure ("Time * double, int64x64", [=] (const Time & t)
+    {
+      return (t * int64x64_t (scale)).GetTimeStep ();
+    });
+  comparison[0].after = Measure ("Time * double", [=] (const Time & t)
+    {
+      return (t * scale).GetTimeStep ();
+    });
+  comparison[1].before = Measure ("Time / double, int64x64", [=] (const Time & t)
+    {
+      return (t / int64x64_t (scale)).GetTimeStep ();
+    });
+  comparison[1].after = Measure ("Time / double", [=] (const Time & t)
+    {
+      return (t / scale).GetTimeStep ();
+    });
+  comparison[2].before = Measure ("Seconds (double), int64x64", [=] (const Time & t)
+    {
+      return Time (int64x64_t (t.GetTimeStep () * 1e-10) * second).GetTimeStep ();
+    });
+  comparison[2].after = Measure ("Seconds (double)", [] (const Time & t)
+    {
+      return Seconds (t.GetTimeStep () * 1e-10).GetTimeStep ();
+    });
+  comparison[3].before = Measure ("GetSeconds (), int64x64", [=] (const Time & t)
+    {
+      return static_cast<int64_t> ((int64x64_t (t.GetTimeStep ()) / second).GetDouble () * 1e6);
+    });
+  comparison[3].after = Measure ("GetSeconds ()", [] (const Time & t)
+    {
+      return static_cast<int64_t> (t.GetSeconds () * 1e6);
+    });
+  comparison[4].before = Measure ("To (Time::PS), int64x64", [] (const Time & t)
+    {
+      return (int64x64_t (t.GetTimeStep ()) * int64x64_t (1000)).GetHigh ();
+    });
+  comparison[4].after = Measure ("To (Time::PS)", [] (const Time & t)
+    {
+      return t.To (Time::PS).GetHigh ();
+    });
+
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      std::cout << GetParent ()->GetName () << ": speed-up " << i << ": "
+                << std::setprecision (2) << comparison[i].after / comparison[i].before
+                << std::endl;
+    }
+}
+
 /**
 * \ingroup core-tests
 * \brief   Time test Suite.  Runs the appropriate test cases for time
@@ -547,9 +745,26 @@ public:
   {
     AddTestCase (new TimeWithSignTestCase (), TestCase::QUICK);
     AddTestCase (new TimeInputOutputTestCase (), TestCase::QUICK);
+    AddTestCase (new TimeFastPathTestCase (), TestCase::QUICK);
     // This should be last, since it changes the resolution
     AddTestCase (new TimeSimpleTestCase (), TestCase::QUICK);
   }
 }
 /** \brief Member variable for time test suite */
 g_timeTestSuite;
+
+/**
+ * \ingroup core-tests
+ * \brief Time performance test suite.
+ */
+static class TimePerformanceTestSuite : public TestSuite
+{
+public:
+  TimePerformanceTestSuite ()
+    : TestSuite ("time-perf", PERFORMANCE)
+  {
+    AddTestCase (new TimeArithmeticPerformanceTestCase (), TestCase::QUICK);
+  }
+}
+/** \brief Member variable for time performance test suite */
+g_timePerformanceTestSuite;
@@ -113,6 +113,70 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbConnect (uint8_t a);
+  void CbDisconnect (uint8_t a);
+  void CbCount (uint8_t a);
+
+  TracedCallback<uint8_t> m_trace;
+  uint32_t m_count;
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback Callbacks which connect and disconnect Callbacks")
+{}
+
+void
+ReentrantTracedCallbackTestCase::CbConnect (uint8_t a)
+{
+  NS_UNUSED (a);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+    }
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbConnect, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbDisconnect (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnect, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbCount (uint8_t a)
+{
+  NS_UNUSED (a);
+  m_count++;
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  //
+  // A Callback which disconnects itself, and one which connects many
+  // other ones, must not invalidate the chain while it is called.  The
+  // Callbacks connected during the call are called by the same call.
+  //
+  m_count = 0;
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnect, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbConnect, this));
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 10, "Connected Callbacks not called");
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 20, "Disconnected Callbacks called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +187,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
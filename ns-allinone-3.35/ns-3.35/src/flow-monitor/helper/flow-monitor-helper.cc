@@ -174,5 +174,46 @@ FlowMonitorHelper::SerializeToXmlFile (std::string fileName, bool enableHistogra
     }
 }
 
+std::map<std::string, double>
+FlowMonitorHelper::GetSummary (void)
+{
+  std::map<std::string, double> summary;
+  if (!m_flowMonitor)
+    {
+      return summary;
+    }
+  m_flowMonitor->CheckForLostPackets ();
+  const FlowMonitor::FlowStatsContainer &stats = m_flowMonitor->GetFlowStats ();
+  uint64_t txPackets = 0;
+  uint64_t rxPackets = 0;
+  uint64_t lostPackets = 0;
+  uint64_t jitterCount = 0;
+  double throughput = 0;
+  Time delaySum;
+  Time jitterSum;
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+    {
+      const FlowMonitor::FlowStats &flow = i->second;
+      txPackets += flow.txPackets;
+      rxPackets += flow.rxPackets;
+      lostPackets += flow.lostPackets;
+      delaySum += flow.delaySum;
+      jitterSum += flow.jitterSum;
+      jitterCount += flow.rxPackets > 1 ? flow.rxPackets - 1 : 0;
+      Time duration = flow.timeLastRxPacket - flow.timeFirstTxPacket;
+      if (flow.rxPackets > 0 && duration.IsStrictlyPositive ())
+        {
+          throughput += flow.rxBytes * 8.0 / duration.GetSeconds ();
+        }
+    }
+  summary["flows"] = stats.size ();
+  summary["txPackets"] = txPackets;
+  summary["rxPackets"] = rxPackets;
+  summary["lostPackets"] = lostPackets;
+  summary["throughput"] = throughput;
+  summary["meanDelay"] = rxPackets > 0 ? delaySum.GetSeconds () / rxPackets : 0;
+  summary["meanJitter"] = jitterCount > 0 ? jitterSum.GetSeconds () / jitterCount : 0;
+  return summary;
+}
 
 } // namespace ns3
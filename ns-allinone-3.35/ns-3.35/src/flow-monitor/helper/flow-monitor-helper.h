@@ -24,6 +24,7 @@
 #include "ns3/object-factory.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/flow-classifier.h"
+#include <map>
 #include <string>
 
 namespace ns3 {
@@ -112,6 +113,19 @@ public:
    */
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /**
+   * Summarize the statistics of all the flows, e.g. to record them as
+   * the results of a configuration of a ParameterSweep.
+   *
+   * The summary holds the number of flows, the transmitted, received
+   * and lost packets, the aggregate throughput in bit/s from the first
+   * transmission to the last reception of each flow, and the mean
+   * delay and jitter in seconds.
+   *
+   * eturn the statistics, by name
+   */
+  std::map<std::string, double> GetSummary (void);
+
 private:
   /**
    * \brief Copy constructor
@@ -585,7 +585,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -1000,13 +1003,19 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
           for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
             {
               NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
-              CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+              if (!m_txTrace.IsEmpty ())
+                {
+                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                }
               outInterface->Send (it->first, it->second, target);
             }
         }
       else
         {
-          CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+          if (!m_txTrace.IsEmpty ())
+            {
+              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+            }
           outInterface->Send (packet, ipHeader, target);
         }
     }
@@ -937,7 +937,10 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
 
   if (ipv6Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
+        }
     }
   else
     {
@@ -1160,13 +1163,19 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
 
               for (std::list<Ipv6ExtensionFragment::Ipv6PayloadHeaderPair>::const_iterator it = fragments.begin (); it != fragments.end (); it++)
                 {
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv6> (), interface);
+                  if (!m_txTrace.IsEmpty ())
+                    {
+                      CallTxTrace (it->second, it->first, m_node->GetObject<Ipv6> (), interface);
+                    }
                   outInterface->Send (it->first, it->second, route->GetGateway ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv6> (), interface);
+              if (!m_txTrace.IsEmpty ())
+                {
+                  CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv6> (), interface);
+                }
               outInterface->Send (packet, ipHeader, route->GetGateway ());
             }
         }
@@ -1188,13 +1197,19 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
 
               for (std::list<Ipv6ExtensionFragment::Ipv6PayloadHeaderPair>::const_iterator it = fragments.begin (); it != fragments.end (); it++)
                 {
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv6> (), interface);
+                  if (!m_txTrace.IsEmpty ())
+                    {
+                      CallTxTrace (it->second, it->first, m_node->GetObject<Ipv6> (), interface);
+                    }
                   outInterface->Send (it->first, it->second, ipHeader.GetDestination ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv6> (), interface);
+              if (!m_txTrace.IsEmpty ())
+                {
+                  CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv6> (), interface);
+                }
               outInterface->Send (packet, ipHeader, ipHeader.GetDestination ());
             }
         }
@@ -30,6 +30,7 @@
 #include "ns3/simulator.h"
 #include "ns3/scheduler.h"
 #include "ns3/event-impl.h"
+#include "ns3/event-profiler.h"
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
 #include "ns3/ptr.h"
@@ -322,7 +323,14 @@ DistributedSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Get ()->Invoke (next.impl, m_currentContext);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 }
 
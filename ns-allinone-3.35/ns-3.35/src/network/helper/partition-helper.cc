@@ -0,0 +1,790 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "partition-helper.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#ifdef NS3_MTP
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PartitionHelper");
+
+namespace {
+
+/** A link between two nodes, or two groups of nodes. */
+struct Link
+{
+  uint32_t a;       //!< First end.
+  uint32_t b;       //!< Second end.
+  Time delay;       //!< Link delay.
+  double traffic;   //!< Expected traffic.
+};
+
+/**
+ * Compare links by delay.
+ * \param [in] x The first link.
+ * \param [in] y The second link.
+ * \returns \c true if \p x is shorter than \p y.
+ */
+bool
+DelayLess (const Link &x, const Link &y)
+{
+  return x.delay < y.delay;
+}
+
+/** Union-find forest tracking the weight of each set. */
+class Groups
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] weights The weight of each element.
+   */
+  Groups (const std::vector<double> &weights)
+    : m_parent (weights.size ()),
+      m_weight (weights),
+      m_count (static_cast<uint32_t> (weights.size ()))
+  {
+    for (uint32_t i = 0; i < m_parent.size (); ++i)
+      {
+        m_parent[i] = i;
+      }
+  }
+  /**
+   * Find the representative of an element.
+   * \param [in] i The element.
+   * \returns The representative of the set of \p i.
+   */
+  uint32_t Find (uint32_t i)
+  {
+    while (m_parent[i] != i)
+      {
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+      }
+    return i;
+  }
+  /**
+   * Merge the sets of two elements.
+   * \param [in] i The first element.
+   * \param [in] j The second element.
+   * \returns The weight of the merged set.
+   */
+  double Merge (uint32_t i, uint32_t j)
+  {
+    i = Find (i);
+    j = Find (j);
+    if (i != j)
+      {
+        m_parent[j] = i;
+        m_weight[i] += m_weight[j];
+        --m_count;
+      }
+    return m_weight[i];
+  }
+  /**
+   * Get the number of sets.
+   * \returns The number of sets.
+   */
+  uint32_t GetCount (void) const
+  {
+    return m_count;
+  }
+
+private:
+  std::vector<uint32_t> m_parent;   //!< Parent of each element.
+  std::vector<double> m_weight;     //!< Weight of each set, valid for the representatives.
+  uint32_t m_count;                 //!< Number of sets.
+};
+
+/** A weighted undirected graph, stored as adjacency lists. */
+struct Graph
+{
+  /** Weight of each vertex. */
+  std::vector<double> weight;
+  /** Neighbours of each vertex, with the edge weights. */
+  std::vector<std::vector<std::pair<uint32_t, double> > > edges;
+};
+
+/** Graphs with at most this number of vertices are bisected directly. */
+const uint32_t COARSEST = 64;
+
+/**
+ * Coarsen a graph by heavy-edge matching: each vertex is merged with
+ * the unmatched neighbour to which it has the heaviest edge.
+ *
+ * \param [in] graph The graph.
+ * \param [out] coarse The coarse graph.
+ * \param [out] map The coarse vertex of each vertex.
+ */
+void
+Coarsen (const Graph &graph, Graph &coarse, std::vector<uint32_t> &map)
+{
+  const uint32_t NONE = std::numeric_limits<uint32_t>::max ();
+  uint32_t n = static_cast<uint32_t> (graph.weight.size ());
+
+  // Visit the vertices with the fewest neighbours first, so that they
+  // still find a match.
+  std::vector<std::pair<std::size_t, uint32_t> > order;
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      order.push_back (std::make_pair (graph.edges[v].size (), v));
+    }
+  std::sort (order.begin (), order.end ());
+
+  map.assign (n, NONE);
+  std::vector<std::vector<uint32_t> > members;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint32_t v = order[i].second;
+      if (map[v] != NONE)
+        {
+          continue;
+        }
+      uint32_t match = v;
+      double heaviest = -1;
+      for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[v].begin ();
+           e != graph.edges[v].end (); ++e)
+        {
+          if (map[e->first] == NONE && e->first != v && e->second > heaviest)
+            {
+              match = e->first;
+              heaviest = e->second;
+            }
+        }
+      map[v] = static_cast<uint32_t> (members.size ());
+      map[match] = map[v];
+      members.push_back (std::vector<uint32_t> (1, v));
+      if (match != v)
+        {
+          members.back ().push_back (match);
+        }
+    }
+
+  uint32_t nCoarse = static_cast<uint32_t> (members.size ());
+  coarse.weight.assign (nCoarse, 0);
+  coarse.edges.assign (nCoarse, std::vector<std::pair<uint32_t, double> > ());
+  // Position of each coarse neighbour in the adjacency list being built,
+  // to merge the parallel edges.
+  std::vector<uint32_t> slot (nCoarse, NONE);
+  for (uint32_t c = 0; c < nCoarse; ++c)
+    {
+      std::vector<std::pair<uint32_t, double> > &edges = coarse.edges[c];
+      for (std::vector<uint32_t>::const_iterator v = members[c].begin (); v != members[c].end (); ++v)
+        {
+          coarse.weight[c] += graph.weight[*v];
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[*v].begin ();
+               e != graph.edges[*v].end (); ++e)
+            {
+              uint32_t u = map[e->first];
+              if (u == c)
+                {
+                  continue;
+                }
+              if (slot[u] == NONE)
+                {
+                  slot[u] = static_cast<uint32_t> (edges.size ());
+                  edges.push_back (std::make_pair (u, e->second));
+                }
+              else
+                {
+                  edges[slot[u]].second += e->second;
+                }
+            }
+        }
+      for (std::vector<std::pair<uint32_t, double> >::const_iterator e = edges.begin ();
+           e != edges.end (); ++e)
+        {
+          slot[e->first] = NONE;
+        }
+    }
+}
+
+/**
+ * Compute the gain of moving a vertex to the other side of a bisection,
+ * i.e. the reduction of the weight of the cut edges.
+ *
+ * \param [in] graph The graph.
+ * \param [in] side The side of each vertex.
+ * \param [in] v The vertex.
+ * \returns The gain.
+ */
+double
+Gain (const Graph &graph, const std::vector<uint8_t> &side, uint32_t v)
+{
+  double gain = 0;
+  for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[v].begin ();
+       e != graph.edges[v].end (); ++e)
+    {
+      gain += (side[e->first] != side[v]) ? e->second : -e->second;
+    }
+  return gain;
+}
+
+/**
+ * Refine a bisection by greedy moves of vertices between the sides,
+ * restoring the balance first, then reducing the cut.
+ *
+ * \param [in] graph The graph.
+ * \param [in,out] side The side of each vertex.
+ * \param [in] target The target weight of each side.
+ * \param [in] tolerance The imbalance tolerance.
+ */
+void
+Refine (const Graph &graph, std::vector<uint8_t> &side,
+        const double target[2], double tolerance)
+{
+  uint32_t n = static_cast<uint32_t> (graph.weight.size ());
+  double limit[2] = { target[0] * (1 + tolerance), target[1] * (1 + tolerance) };
+  double weight[2] = { 0, 0 };
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      weight[side[v]] += graph.weight[v];
+    }
+
+  for (uint32_t pass = 0; pass < 8; ++pass)
+    {
+      std::vector<std::pair<double, uint32_t> > order;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          order.push_back (std::make_pair (-Gain (graph, side, v), v));
+        }
+      std::sort (order.begin (), order.end ());
+
+      bool moved = false;
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          uint32_t v = order[i].second;
+          uint8_t from = side[v];
+          uint8_t to = 1 - from;
+          double w = graph.weight[v];
+          if (weight[to] + w > limit[to] && weight[to] + w > weight[from] - w)
+            {
+              // The move would unbalance the bisection.
+              continue;
+            }
+          double gain = Gain (graph, side, v);
+          bool rebalance = weight[from] > limit[from];
+          bool better = gain > 0 || (gain == 0 && weight[from] - w >= weight[to] + w);
+          if (rebalance || better)
+            {
+              side[v] = to;
+              weight[from] -= w;
+              weight[to] += w;
+              moved = true;
+            }
+        }
+      if (!moved)
+        {
+          break;
+        }
+    }
+}
+
+/**
+ * Bisect a graph by greedy graph growing: starting from a seed,
+ * the vertex with the largest gain is added to the first side until
+ * it reaches its target weight.  Several seeds are tried and the
+ * smallest cut is kept.
+ *
+ * \param [in] graph The graph.
+ * \param [out] side The side of each vertex.
+ * \param [in] target The target weight of each side.
+ */
+void
+Grow (const Graph &graph, std::vector<uint8_t> &side, const double target[2])
+{
+  uint32_t n = static_cast<uint32_t> (graph.weight.size ());
+  std::vector<uint32_t> seeds;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      uint32_t seed = i * n / 4;
+      if (std::find (seeds.begin (), seeds.end (), seed) == seeds.end ())
+        {
+          seeds.push_back (seed);
+        }
+    }
+
+  double bestCut = std::numeric_limits<double>::max ();
+  for (std::vector<uint32_t>::const_iterator seed = seeds.begin (); seed != seeds.end (); ++seed)
+    {
+      std::vector<uint8_t> trial (n, 1);
+      // Gain of moving each vertex to the first side.
+      std::vector<double> gain (n, 0);
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          gain[v] = Gain (graph, trial, v);
+        }
+      double weight = 0;
+      uint32_t next = *seed;
+      while (true)
+        {
+          trial[next] = 0;
+          weight += graph.weight[next];
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[next].begin ();
+               e != graph.edges[next].end (); ++e)
+            {
+              gain[e->first] += 2 * e->second;
+            }
+          uint32_t best = n;
+          for (uint32_t v = 0; v < n; ++v)
+            {
+              if (trial[v] == 1 && (best == n || gain[v] > gain[best]))
+                {
+                  best = v;
+                }
+            }
+          if (best == n
+              || weight >= target[0]
+              || weight + graph.weight[best] - target[0] > target[0] - weight)
+            {
+              break;
+            }
+          next = best;
+        }
+
+      double cut = 0;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[v].begin ();
+               e != graph.edges[v].end (); ++e)
+            {
+              if (trial[v] != trial[e->first])
+                {
+                  cut += e->second;
+                }
+            }
+        }
+      if (cut < bestCut)
+        {
+          bestCut = cut;
+          side.swap (trial);
+        }
+    }
+}
+
+/**
+ * Bisect a graph: coarsen it, bisect the coarsest graph, and refine
+ * the bisection while projecting it back to the finer graphs.
+ *
+ * \param [in] graph The graph.
+ * \param [out] side The side of each vertex.
+ * \param [in] target The target weight of each side.
+ * \param [in] tolerance The imbalance tolerance.
+ */
+void
+Bisect (const Graph &graph, std::vector<uint8_t> &side,
+        const double target[2], double tolerance)
+{
+  uint32_t n = static_cast<uint32_t> (graph.weight.size ());
+  if (n > COARSEST)
+    {
+      Graph coarse;
+      std::vector<uint32_t> map;
+      Coarsen (graph, coarse, map);
+      if (coarse.weight.size () < 0.9 * n)
+        {
+          std::vector<uint8_t> coarseSide;
+          Bisect (coarse, coarseSide, target, tolerance);
+          side.resize (n);
+          for (uint32_t v = 0; v < n; ++v)
+            {
+              side[v] = coarseSide[map[v]];
+            }
+          Refine (graph, side, target, tolerance);
+          return;
+        }
+    }
+  Grow (graph, side, target);
+  Refine (graph, side, target, tolerance);
+}
+
+/**
+ * Partition a graph in \p nParts parts by recursive bisection.
+ *
+ * \param [in] graph The graph.
+ * \param [in] nParts The number of parts.
+ * \param [in] first The id of the first part.
+ * \param [in] tolerance The imbalance tolerance of each bisection.
+ * \param [out] part The part of each vertex.
+ */
+void
+Split (const Graph &graph, uint32_t nParts, uint32_t first, double tolerance,
+       std::vector<uint32_t> &part)
+{
+  uint32_t n = static_cast<uint32_t> (graph.weight.size ());
+  part.assign (n, first);
+  nParts = std::min (nParts, n);
+  if (nParts <= 1)
+    {
+      return;
+    }
+
+  double total = 0;
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      total += graph.weight[v];
+    }
+  uint32_t nParts0 = nParts / 2;
+  double target[2] = { total * nParts0 / nParts, total * (nParts - nParts0) / nParts };
+  std::vector<uint8_t> side;
+  Bisect (graph, side, target, tolerance);
+
+  for (uint8_t s = 0; s < 2; ++s)
+    {
+      // Extract the subgraph of this side.
+      std::vector<uint32_t> index (n, n);
+      std::vector<uint32_t> vertices;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          if (side[v] == s)
+            {
+              index[v] = static_cast<uint32_t> (vertices.size ());
+              vertices.push_back (v);
+            }
+        }
+      Graph sub;
+      sub.weight.resize (vertices.size ());
+      sub.edges.resize (vertices.size ());
+      for (uint32_t i = 0; i < vertices.size (); ++i)
+        {
+          sub.weight[i] = graph.weight[vertices[i]];
+          for (std::vector<std::pair<uint32_t, double> >::const_iterator e = graph.edges[vertices[i]].begin ();
+               e != graph.edges[vertices[i]].end (); ++e)
+            {
+              if (side[e->first] == s)
+                {
+                  sub.edges[i].push_back (std::make_pair (index[e->first], e->second));
+                }
+            }
+        }
+      std::vector<uint32_t> subPart;
+      Split (sub, s == 0 ? nParts0 : nParts - nParts0, s == 0 ? first : first + nParts0,
+             tolerance, subPart);
+      for (uint32_t i = 0; i < vertices.size (); ++i)
+        {
+          part[vertices[i]] = subPart[i];
+        }
+    }
+}
+
+#ifdef NS3_MTP
+/**
+ * Default partitioner of the MultithreadedSimulatorImpl.
+ * \param [in] nParts The maximum number of partitions.
+ * \param [out] partition The partition of each node.
+ * \returns The lookahead.
+ */
+Time
+DefaultPartitioner (uint32_t nParts, std::vector<uint32_t> &partition)
+{
+  return PartitionHelper ().Partition (nParts, partition);
+}
+
+/** Install the default partitioner at load time. */
+struct DefaultPartitionerInstaller
+{
+  DefaultPartitionerInstaller ()
+  {
+    MultithreadedSimulatorImpl::SetDefaultPartitioner (MakeCallback (&DefaultPartitioner));
+  }
+} g_defaultPartitionerInstaller; //!< Installs the default partitioner
+#endif /* NS3_MTP */
+
+} // unnamed namespace
+
+PartitionHelper::PartitionHelper ()
+  : m_tolerance (0.1)
+{
+  NS_LOG_FUNCTION (this);
+  m_report.nParts = 0;
+  m_report.imbalance = 0;
+  m_report.cutChannels = 0;
+  m_report.cutTraffic = 0;
+}
+
+void
+PartitionHelper::SetNodeWeight (Ptr<Node> node, double weight)
+{
+  NS_LOG_FUNCTION (this << node << weight);
+  NS_ASSERT_MSG (weight >= 0, "Node weights must not be negative");
+  m_nodeWeights[node->GetId ()] = weight;
+}
+
+void
+PartitionHelper::SetChannelTraffic (Ptr<Channel> channel, double traffic)
+{
+  NS_LOG_FUNCTION (this << channel << traffic);
+  NS_ASSERT_MSG (traffic >= 0, "Channel traffic must not be negative");
+  m_channelTraffic[channel->GetId ()] = traffic;
+}
+
+void
+PartitionHelper::SetImbalanceTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  NS_ASSERT_MSG (tolerance >= 0, "The imbalance tolerance must not be negative");
+  m_tolerance = tolerance;
+}
+
+bool
+PartitionHelper::IsSplittable (Ptr<Channel> channel, Time &delay)
+{
+  NS_LOG_FUNCTION (channel);
+  TypeId tid = channel->GetInstanceTypeId ();
+  TypeId pointToPoint;
+  TypeId simple;
+  bool splittable =
+    (TypeId::LookupByNameFailSafe ("ns3::PointToPointChannel", &pointToPoint)
+     && (tid == pointToPoint || tid.IsChildOf (pointToPoint)))
+    || (TypeId::LookupByNameFailSafe ("ns3::SimpleChannel", &simple)
+        && tid == simple && channel->GetNDevices () == 2);
+  TimeValue value;
+  if (!splittable || !channel->GetAttributeFailSafe ("Delay", value))
+    {
+      return false;
+    }
+  delay = value.Get ();
+  return delay.IsStrictlyPositive ();
+}
+
+Time
+PartitionHelper::Partition (uint32_t nParts, std::vector<uint32_t> &partition)
+{
+  NS_LOG_FUNCTION (this << nParts);
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<double> nodeWeights (nNodes, 1);
+  for (std::map<uint32_t, double>::const_iterator i = m_nodeWeights.begin (); i != m_nodeWeights.end (); ++i)
+    {
+      if (i->first < nNodes)
+        {
+          nodeWeights[i->first] = i->second;
+        }
+    }
+  double total = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      total += nodeWeights[i];
+    }
+
+  // Merge the nodes which cannot be split, and collect the other links.
+  Groups base (nodeWeights);
+  std::vector<Link> links;
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      std::vector<uint32_t> nodes;
+      for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+        {
+          Ptr<NetDevice> device = channel->GetDevice (j);
+          if (device != 0 && device->GetNode () != 0)
+            {
+              nodes.push_back (device->GetNode ()->GetId ());
+            }
+        }
+      if (nodes.size () < 2)
+        {
+          continue;
+        }
+      Time delay;
+      if (nodes.size () == 2 && IsSplittable (channel, delay))
+        {
+          std::map<uint32_t, double>::const_iterator traffic = m_channelTraffic.find (channel->GetId ());
+          Link link = { nodes[0], nodes[1], delay,
+                        traffic == m_channelTraffic.end () ? 1.0 : traffic->second };
+          links.push_back (link);
+          continue;
+        }
+      for (std::size_t j = 1; j < nodes.size (); ++j)
+        {
+          base.Merge (nodes[0], nodes[j]);
+        }
+    }
+  std::stable_sort (links.begin (), links.end (), &DelayLess);
+
+  // Find the largest lookahead for which the groups linked by shorter
+  // links can still be balanced.
+  nParts = std::max (1U, std::min (nParts, nNodes));
+  double limit = total / nParts * (1 + m_tolerance);
+  std::size_t merged = 0;
+  {
+    Groups trial = base;
+    while (merged < links.size ())
+      {
+        Time delay = links[merged].delay;
+        bool feasible = true;
+        std::size_t next = merged;
+        for (; next < links.size () && links[next].delay == delay; ++next)
+          {
+            feasible = trial.Merge (links[next].a, links[next].b) <= limit && feasible;
+          }
+        if (!feasible || trial.GetCount () < nParts)
+          {
+            break;
+          }
+        merged = next;
+      }
+  }
+  Groups groups = base;
+  for (std::size_t i = 0; i < merged; ++i)
+    {
+      groups.Merge (links[i].a, links[i].b);
+    }
+  NS_LOG_LOGIC (merged << " links merged, " << groups.GetCount () << " groups");
+
+  // Build the graph of the groups and partition it.
+  std::vector<uint32_t> vertex (nNodes, nNodes);
+  Graph graph;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t root = groups.Find (i);
+      if (vertex[root] == nNodes)
+        {
+          vertex[root] = static_cast<uint32_t> (graph.weight.size ());
+          graph.weight.push_back (0);
+        }
+      graph.weight[vertex[root]] += nodeWeights[i];
+    }
+  graph.edges.resize (graph.weight.size ());
+  for (std::vector<Link>::const_iterator i = links.begin (); i != links.end (); ++i)
+    {
+      uint32_t a = vertex[groups.Find (i->a)];
+      uint32_t b = vertex[groups.Find (i->b)];
+      if (a != b)
+        {
+          graph.edges[a].push_back (std::make_pair (b, i->traffic));
+          graph.edges[b].push_back (std::make_pair (a, i->traffic));
+        }
+    }
+  uint32_t levels = static_cast<uint32_t> (std::ceil (std::log2 (static_cast<double> (nParts))));
+  std::vector<uint32_t> part;
+  Split (graph, nParts, 0, m_tolerance / std::max (levels, 1U), part);
+
+  partition.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      partition[i] = part[vertex[groups.Find (i)]];
+    }
+
+  // Summarize the partition.
+  m_report.nParts = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      m_report.nParts = std::max (m_report.nParts, partition[i] + 1);
+    }
+  m_report.loads.assign (m_report.nParts, 0);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      m_report.loads[partition[i]] += nodeWeights[i];
+    }
+  double largest = m_report.loads.empty () ? 0 :
+    *std::max_element (m_report.loads.begin (), m_report.loads.end ());
+  m_report.imbalance = total > 0 ? largest * m_report.nParts / total : 0;
+  m_report.lookahead = Seconds (0);
+  m_report.cutChannels = 0;
+  m_report.cutTraffic = 0;
+  m_report.bundles.clear ();
+  for (std::vector<Link>::const_iterator i = links.begin (); i != links.end (); ++i)
+    {
+      uint32_t a = partition[i->a];
+      uint32_t b = partition[i->b];
+      if (a == b)
+        {
+          continue;
+        }
+      if (m_report.cutChannels == 0 || i->delay < m_report.lookahead)
+        {
+          m_report.lookahead = i->delay;
+        }
+      m_report.cutChannels++;
+      m_report.cutTraffic += i->traffic;
+      std::pair<uint32_t, uint32_t> key (std::min (a, b), std::max (a, b));
+      std::map<std::pair<uint32_t, uint32_t>, Bundle>::iterator bundle = m_report.bundles.find (key);
+      if (bundle == m_report.bundles.end ())
+        {
+          Bundle first = { 1, i->traffic, i->delay };
+          m_report.bundles[key] = first;
+        }
+      else
+        {
+          bundle->second.channels++;
+          bundle->second.traffic += i->traffic;
+          bundle->second.delay = std::min (bundle->second.delay, i->delay);
+        }
+    }
+  NS_LOG_INFO ("nodes=" << nNodes << " partitions=" << m_report.nParts <<
+               " lookahead=" << m_report.lookahead.As (Time::US) <<
+               " imbalance=" << m_report.imbalance <<
+               " cut=" << m_report.cutChannels);
+  return m_report.lookahead;
+}
+
+Time
+PartitionHelper::AssignSystemIds (uint32_t nSystems)
+{
+  NS_LOG_FUNCTION (this << nSystems);
+  std::vector<uint32_t> partition;
+  Time lookahead = Partition (nSystems, partition);
+  for (uint32_t i = 0; i < partition.size (); ++i)
+    {
+      NodeList::GetNode (i)->SetAttribute ("SystemId", UintegerValue (partition[i]));
+    }
+  return lookahead;
+}
+
+const PartitionHelper::Report &
+PartitionHelper::GetReport (void) const
+{
+  return m_report;
+}
+
+void
+PartitionHelper::PrintReport (std::ostream &os) const
+{
+  os << "partitions " << m_report.nParts
+     << ", lookahead " << m_report.lookahead.As (Time::US)
+     << ", imbalance " << m_report.imbalance
+     << ", cut channels " << m_report.cutChannels
+     << ", cut traffic " << m_report.cutTraffic << std::endl;
+  for (uint32_t i = 0; i < m_report.loads.size (); ++i)
+    {
+      os << "  partition " << i << ": load " << m_report.loads[i] << std::endl;
+    }
+  for (std::map<std::pair<uint32_t, uint32_t>, Bundle>::const_iterator i = m_report.bundles.begin ();
+       i != m_report.bundles.end (); ++i)
+    {
+      os << "  bundle " << i->first.first << "-" << i->first.second
+         << ": " << i->second.channels << " channels"
+         << ", traffic " << i->second.traffic
+         << ", delay " << i->second.delay.As (Time::US) << std::endl;
+    }
+}
+
+} // namespace ns3
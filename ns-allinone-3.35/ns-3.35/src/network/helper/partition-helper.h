@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PARTITION_HELPER_H
+#define PARTITION_HELPER_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class Channel;
+class Node;
+
+/**
+ * \ingroup network
+ *
+ * \brief Split the nodes of a topology into partitions for
+ * parallel simulation.
+ *
+ * Nodes can only be simulated in different partitions if all their
+ * interactions are delayed events, so that the smallest delay gives
+ * the lookahead of the partition.  This is the case of the
+ * point-to-point channels, which deliver packets to the remote
+ * node with ScheduleWithContext after the channel delay, and of the
+ * SimpleChannel between two devices.  All the nodes sharing any
+ * other channel, or a link without delay, are kept in the same
+ * partition.
+ *
+ * The helper builds the graph of the nodes of the NodeList and the
+ * links of the ChannelList, where each node is weighted by its
+ * expected load and each link by its expected traffic (one by
+ * default, see SetNodeWeight() and SetChannelTraffic()).  It then
+ * proceeds in two steps:
+ *
+ * - Maximise the lookahead: the links are merged by increasing delay
+ *   as long as a partition of the merged groups can remain balanced,
+ *   within the imbalance tolerance.  The delay of the first link
+ *   which cannot be merged is the lookahead.
+ * - Minimise the traffic between partitions, by multilevel recursive
+ *   bisection of the graph of the merged groups: the graph is
+ *   coarsened by heavy-edge matching, bisected by greedy graph
+ *   growing, and the bisection is refined at each level while
+ *   uncoarsening.
+ *
+ * The partition can be used to set the system id of each node for
+ * the distributed simulators of the mpi module (see AssignSystemIds()).
+ * As the point-to-point helper chooses between local and remote
+ * channels when the devices are installed, the topology is then
+ * typically built twice: once with a single system to compute the
+ * partition, and once, after Simulator::Destroy(), with the system
+ * ids found.  GetReport() gives the predicted lookahead, the load
+ * balance, and the links between each pair of partitions, which are
+ * the remote channel bundles of the NullMessageSimulatorImpl.
+ *
+ * When ns-3 is configured with \c --enable-mtp, this helper is also
+ * the default partitioner of the MultithreadedSimulatorImpl.
+ */
+class PartitionHelper
+{
+public:
+  /** Links between a pair of partitions. */
+  struct Bundle
+  {
+    uint32_t channels;  //!< Number of channels.
+    double traffic;     //!< Total expected traffic.
+    Time delay;         //!< Smallest delay, i.e. the lookahead of the bundle.
+  };
+
+  /** Summary of a partition. */
+  struct Report
+  {
+    uint32_t nParts;              //!< Number of partitions.
+    Time lookahead;               //!< Smallest delay of a link between partitions.
+    std::vector<double> loads;    //!< Load of each partition.
+    double imbalance;             //!< Largest load over the average load.
+    uint32_t cutChannels;         //!< Number of links between partitions.
+    double cutTraffic;            //!< Expected traffic between partitions.
+    /** Links between each pair of partitions, indexed by (lower, higher) partition. */
+    std::map<std::pair<uint32_t, uint32_t>, Bundle> bundles;
+  };
+
+  PartitionHelper ();
+
+  /**
+   * Set the expected load of a node, one by default.
+   *
+   * \param [in] node The node.
+   * \param [in] weight The load, e.g. the expected number of events.
+   */
+  void SetNodeWeight (Ptr<Node> node, double weight);
+  /**
+   * Set the expected traffic of a channel, one by default.
+   *
+   * \param [in] channel The channel.
+   * \param [in] traffic The traffic, e.g. the expected number of packets.
+   */
+  void SetChannelTraffic (Ptr<Channel> channel, double traffic);
+  /**
+   * Set the imbalance tolerance.
+   *
+   * A partition may hold up to (1 + \p tolerance) times the average
+   * load, to increase the lookahead or reduce the traffic between
+   * partitions.  The default is 0.1.
+   *
+   * \param [in] tolerance The imbalance tolerance.
+   */
+  void SetImbalanceTolerance (double tolerance);
+
+  /**
+   * Compute a partition of all the nodes of the NodeList.
+   *
+   * \param [in] nParts The maximum number of partitions.
+   * \param [out] partition The partition of each node, indexed by node id.
+   * \returns The lookahead, i.e. the smallest delay of the links
+   *          between partitions, or zero if there is no such link.
+   */
+  Time Partition (uint32_t nParts, std::vector<uint32_t> &partition);
+  /**
+   * Partition the nodes and set the SystemId attribute of each node
+   * to its partition.
+   *
+   * \param [in] nSystems The number of systems.
+   * \returns The lookahead.
+   */
+  Time AssignSystemIds (uint32_t nSystems);
+  /**
+   * Get the summary of the last partition.
+   *
+   * \returns The summary.
+   */
+  const Report & GetReport (void) const;
+  /**
+   * Print the summary of the last partition.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void PrintReport (std::ostream &os) const;
+
+  /**
+   * Check whether a channel can be split between partitions.
+   *
+   * \param [in] channel The channel.
+   * \param [out] delay The channel delay, if the channel can be split.
+   * \returns \c true if the nodes of the channel can be in different partitions.
+   */
+  static bool IsSplittable (Ptr<Channel> channel, Time &delay);
+
+private:
+  /** Expected load of the nodes, by node id. */
+  std::map<uint32_t, double> m_nodeWeights;
+  /** Expected traffic of the channels, by channel id. */
+  std::map<uint32_t, double> m_channelTraffic;
+  /** Imbalance tolerance. */
+  double m_tolerance;
+  /** Summary of the last partition. */
+  Report m_report;
+};
+
+} // namespace ns3
+
+#endif /* PARTITION_HELPER_H */
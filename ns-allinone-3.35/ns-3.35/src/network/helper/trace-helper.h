@@ -216,6 +216,9 @@ public:
    * that can solve the problem so we use one of those to carry the stream
    * around and deal with the lifetime issues.
    * 
+   * If the global value "AsciiTraceFormat" is "Binary", the stream is a
+   * binary trace file created by CreateBinaryFileStream().
+   *
    * @param filename file name
    * @param filemode file mode
    * @returns a smart pointer to the output stream
@@ -223,6 +226,19 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create an output stream object writing a binary trace file.
+   *
+   * The default trace sinks record their packet events in the file as
+   * binary records (see BinaryTraceWriter), and the text written to the
+   * stream is recorded as lines.  The \c binary-trace-converter program
+   * converts the file to the text of the ascii traces, or to columns.
+   *
+   * @param filename file name
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -43,6 +43,57 @@ static struct Zeroes
   const uint32_t size;  //!< buffer size
 } g_zeroes; //!< Zero-filled buffer
 
+/**
+ * \ingroup packet
+ * Number of size classes of the BufferData free lists, from 64 bytes
+ * to 64 KiB.
+ */
+static const uint32_t g_sizeClasses = 11;
+/**
+ * \ingroup packet
+ * Size of the smallest size class, as a power of two.
+ */
+static const uint32_t g_minSizeClassShift = 6;
+/**
+ * \ingroup packet
+ * Maximum size of the BufferData in the free list of each size class.
+ */
+static const uint32_t g_maxFreeListBytes = 8 << 20;
+/**
+ * \ingroup packet
+ * Size of the smallest Buffer whose bytes are moved to a slice rather
+ * than copied.
+ */
+static const uint32_t g_minSliceSize = 256;
+
+/**
+ * \ingroup packet
+ * \param size a BufferData size
+ * \returns the smallest size class which can hold size bytes, or
+ *          g_sizeClasses if size is larger than the largest size class.
+ */
+uint32_t
+GetSizeClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  while (sizeClass < g_sizeClasses && (1U << (sizeClass + g_minSizeClassShift)) < size)
+    {
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+/**
+ * \ingroup packet
+ * \param sizeClass a size class
+ * \returns the size of the BufferData of the size class.
+ */
+uint32_t
+GetSizeClassSize (uint32_t sizeClass)
+{
+  return 1U << (sizeClass + g_minSizeClassShift);
+}
+
 }
 
 namespace ns3 {
@@ -50,7 +101,13 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+thread_local Buffer::PoolStatistics Buffer::g_poolStatistics;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+Buffer::PoolStatistics Buffer::g_poolStatistics;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -75,22 +132,33 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList *Buffer::g_freeList = 0;
+thread_local struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#else
 uint32_t Buffer::g_maxSize = 0;
 Buffer::FreeList *Buffer::g_freeList = 0;
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#endif
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
   if (IS_INITIALIZED (g_freeList))
     {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
+      for (uint32_t sizeClass = 0; sizeClass < g_sizeClasses; sizeClass++)
         {
-          Buffer::Deallocate (*i);
+          for (Buffer::FreeList::iterator i = g_freeList[sizeClass].begin ();
+               i != g_freeList[sizeClass].end (); i++)
+            {
+              Buffer::Deallocate (*i);
+            }
         }
-      delete g_freeList;
+      delete [] g_freeList;
       g_freeList = DESTROYED;
+      g_poolStatistics.cached = 0;
+      g_poolStatistics.cachedBytes = 0;
     }
 }
 
@@ -101,17 +169,22 @@ Buffer::Recycle (struct Buffer::Data *data)
   NS_ASSERT (data->m_count == 0);
   NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
+  /* feed into the free list of its size class */
+  uint32_t sizeClass = GetSizeClass (data->m_size);
+  if (sizeClass == g_sizeClasses ||
+      data->m_size != GetSizeClassSize (sizeClass) ||
       IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
+      g_freeList[sizeClass].size () >= std::min (1000U, g_maxFreeListBytes / data->m_size))
     {
       Buffer::Deallocate (data);
     }
   else
     {
       NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      g_freeList[sizeClass].push_back (data);
+      g_poolStatistics.recycles++;
+      g_poolStatistics.cached++;
+      g_poolStatistics.cachedBytes += data->m_size;
     }
 }
 
@@ -119,23 +192,24 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
-      g_freeList = new Buffer::FreeList ();
+      g_freeList = new Buffer::FreeList [g_sizeClasses];
     }
-  else if (IS_INITIALIZED (g_freeList))
+  /* round up to the size class, and try to find a buffer in its free list. */
+  uint32_t sizeClass = GetSizeClass (dataSize);
+  if (sizeClass < g_sizeClasses)
     {
-      while (!g_freeList->empty ()) 
+      dataSize = GetSizeClassSize (sizeClass);
+      if (IS_INITIALIZED (g_freeList) && !g_freeList[sizeClass].empty ())
         {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
+          struct Buffer::Data *data = g_freeList[sizeClass].back ();
+          g_freeList[sizeClass].pop_back ();
+          data->m_count = 1;
+          g_poolStatistics.reuses++;
+          g_poolStatistics.cached--;
+          g_poolStatistics.cachedBytes -= data->m_size;
+          return data;
         }
     }
   struct Buffer::Data *data = Buffer::Allocate (dataSize);
@@ -173,6 +247,7 @@ Buffer::Allocate (uint32_t reqSize)
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  g_poolStatistics.allocations++;
   return data;
 }
 
@@ -183,6 +258,14 @@ Buffer::Deallocate (struct Buffer::Data *data)
   NS_ASSERT (data->m_count == 0);
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
+  g_poolStatistics.frees++;
+}
+
+Buffer::PoolStatistics
+Buffer::GetPoolStatistics (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return g_poolStatistics;
 }
 
 Buffer::Buffer ()
@@ -198,6 +281,7 @@ Buffer::Buffer (uint32_t dataSize)
 }
 
 Buffer::Buffer (uint32_t dataSize, bool initialize)
+  : m_slice (0)
 {
   NS_LOG_FUNCTION (this << dataSize << initialize);
   if (initialize == true)
@@ -225,8 +309,12 @@ Buffer::CheckInternalState (void) const
   bool internalSizeOk = m_end - (m_zeroAreaEnd - m_zeroAreaStart) <= m_data->m_size &&
     m_start <= m_data->m_size &&
     m_zeroAreaStart <= m_data->m_size;
+  bool sliceOk = m_slice == 0 ||
+    (m_slice->m_count > 0 &&
+     m_zeroAreaStart != m_zeroAreaEnd &&
+     m_sliceStart + (m_zeroAreaEnd - m_zeroAreaStart) <= m_slice->m_size);
 
-  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk;
+  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk && sliceOk;
   if (!ok)
     {
       LOG_INTERNAL_STATE ("check " << this << 
@@ -244,7 +332,14 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
+#ifdef BUFFER_FREE_LIST
+  /* Buffers tend to grow to the size of the largest buffer seen. */
+  m_data = Buffer::Create (std::min (g_maxSize, GetSizeClassSize (g_sizeClasses - 1)));
+#else
   m_data = Buffer::Create (0);
+#endif
+  m_slice = 0;
+  m_sliceStart = 0;
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
@@ -262,14 +357,26 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Recycle (m_data);
         }
       m_data = o.m_data;
       m_data->m_count++;
     }
+  if (m_slice != o.m_slice)
+    {
+      if (o.m_slice != 0)
+        {
+          o.m_slice->m_count++;
+        }
+      if (m_slice != 0 && --m_slice->m_count == 0)
+        {
+          Recycle (m_slice);
+        }
+      m_slice = o.m_slice;
+    }
+  m_sliceStart = o.m_sliceStart;
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
@@ -285,11 +392,69 @@ Buffer::~Buffer ()
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       Recycle (m_data);
     }
+  if (m_slice != 0 && --m_slice->m_count == 0)
+    {
+      Recycle (m_slice);
+    }
+}
+
+bool
+Buffer::HasSlice (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_slice != 0;
+}
+
+bool
+Buffer::CanSlice (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_zeroAreaStart == m_zeroAreaEnd && GetSize () >= g_minSliceSize;
+}
+
+void
+Buffer::CreateSlice (uint32_t start, uint32_t end)
+{
+  NS_LOG_FUNCTION (this << start << end);
+  NS_ASSERT (m_zeroAreaStart == m_zeroAreaEnd && m_slice == 0);
+  /* The bytes of the buffer become the slice, and the "virtual zero
+   * area", of a new buffer data storage:
+   * Before: |--*******---|
+   * After:  |----|          (*******: the slice)
+   */
+  uint32_t size = GetSize ();
+  m_slice = m_data;
+  m_sliceStart = m_start;
+  uint32_t newStart = std::max (start, g_recommendedStart);
+  m_data = Buffer::Create (newStart + end);
+  m_start = newStart;
+  m_zeroAreaStart = m_start;
+  m_zeroAreaEnd = m_start + size;
+  m_end = m_zeroAreaEnd;
+  m_data->m_dirtyStart = m_start;
+  m_data->m_dirtyEnd = m_end;
+  g_poolStatistics.slices++;
+  g_poolStatistics.slicedBytes += size;
+  LOG_INTERNAL_STATE ("slice size=" << size << ", ");
+}
+
+void
+Buffer::ReleaseSlice (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_slice != 0 && m_zeroAreaStart == m_zeroAreaEnd)
+    {
+      if (--m_slice->m_count == 0)
+        {
+          Recycle (m_slice);
+        }
+      m_slice = 0;
+      m_sliceStart = 0;
+    }
 }
 
 uint32_t
@@ -310,7 +475,18 @@ Buffer::AddAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // Shared data may be used by another thread: never write to it.
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
+  if ((m_start < start || isDirty) && CanSlice ())
+    {
+      /* share the bytes of the buffer rather than copy them. */
+      CreateSlice (start, 0);
+      isDirty = false;
+    }
   if (m_start >= start && !isDirty)
     {
       /* enough space in the buffer and not dirty. 
@@ -328,8 +504,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (--m_data->m_count == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -355,7 +530,18 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // Shared data may be used by another thread: never write to it.
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
+  if ((GetInternalEnd () + end > m_data->m_size || isDirty) && CanSlice ())
+    {
+      /* share the bytes of the buffer rather than copy them. */
+      CreateSlice (0, end);
+      isDirty = false;
+    }
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
       /* enough space in buffer and not dirty
@@ -373,8 +559,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Buffer::Recycle (m_data);
         }
@@ -402,6 +587,7 @@ Buffer::AddAtEnd (const Buffer &o)
   NS_LOG_FUNCTION (this << &o);
 
   if (m_data->m_count == 1 &&
+      m_slice == 0 && o.m_slice == 0 &&
       (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
       m_end == m_data->m_dirtyEnd &&
       o.m_start == o.m_zeroAreaStart &&
@@ -431,11 +617,63 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
-  *this = CreateFullCopy ();
-  AddAtEnd (o.GetSize ());
-  Buffer::Iterator destStart = End ();
-  destStart.Prev (o.GetSize ());
-  destStart.Write (o.Begin (), o.End ());
+  if (m_zeroAreaStart == m_zeroAreaEnd &&
+      o.m_zeroAreaStart == o.m_zeroAreaEnd &&
+      o.GetSize () >= g_minSliceSize)
+    {
+      /**
+       * The bytes of the other buffer become the slice of this
+       * buffer, rather than being copied.
+       */
+      if (m_data->m_count > 1)
+        {
+          /* the bytes added at the end later must not be written
+           * to a shared buffer data storage. */
+          uint32_t size = GetSize ();
+          struct Buffer::Data *newData = Buffer::Create (size);
+          memcpy (newData->m_data, m_data->m_data + m_start, size);
+          if (--m_data->m_count == 0)
+            {
+              Buffer::Recycle (m_data);
+            }
+          m_data = newData;
+          m_start = 0;
+          m_end = size;
+          m_data->m_dirtyStart = m_start;
+        }
+      uint32_t size = o.GetSize ();
+      m_slice = o.m_data;
+      m_slice->m_count++;
+      m_sliceStart = o.m_start;
+      m_zeroAreaStart = m_end;
+      m_zeroAreaEnd = m_end + size;
+      m_end = m_zeroAreaEnd;
+      m_data->m_dirtyEnd = m_end;
+      m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
+      g_poolStatistics.slices++;
+      g_poolStatistics.slicedBytes += size;
+      LOG_INTERNAL_STATE ("add slice=" << size << ", ");
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  /**
+   * A buffer has a single "virtual zero area": keep the larger one
+   * virtual, and write the bytes of the other buffer, zeroes included.
+   */
+  uint32_t size = o.GetSize ();
+  if (o.m_zeroAreaEnd - o.m_zeroAreaStart > m_zeroAreaEnd - m_zeroAreaStart)
+    {
+      Buffer tmp = o;
+      tmp.AddAtStart (GetSize ());
+      CopyData (tmp.m_data->m_data + tmp.m_start, GetSize ());
+      *this = tmp;
+    }
+  else
+    {
+      AddAtEnd (size);
+      o.CopyData (m_data->m_data + GetInternalEnd () - size, size);
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -459,6 +697,7 @@ Buffer::RemoveAtStart (uint32_t start)
       m_start = m_zeroAreaStart;
       m_zeroAreaEnd -= delta;
       m_end -= delta;
+      m_sliceStart += delta;
     } 
   else if (newStart <= m_end)
     {
@@ -480,6 +719,7 @@ Buffer::RemoveAtStart (uint32_t start)
       m_zeroAreaEnd = m_end;
       m_zeroAreaStart = m_end;
     }
+  ReleaseSlice ();
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem start=" << start << ", ");
   NS_ASSERT (CheckInternalState ());
@@ -515,6 +755,7 @@ Buffer::RemoveAtEnd (uint32_t end)
       m_zeroAreaEnd = m_start;
       m_zeroAreaStart = m_start;
     }
+  ReleaseSlice ();
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem end=" << end << ", ");
   NS_ASSERT (CheckInternalState ());
@@ -539,17 +780,11 @@ Buffer::CreateFullCopy (void) const
   NS_ASSERT (CheckInternalState ());
   if (m_zeroAreaEnd - m_zeroAreaStart != 0) 
     {
+      /* a single AddAtStart to an empty buffer, so that the bytes are
+       * contiguous, and never moved to a slice. */
       Buffer tmp;
-      tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
-      tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
-      uint32_t dataStart = m_zeroAreaStart - m_start;
-      tmp.AddAtStart (dataStart);
-      tmp.Begin ().Write (m_data->m_data+m_start, dataStart);
-      uint32_t dataEnd = m_end - m_zeroAreaEnd;
-      tmp.AddAtEnd (dataEnd);
-      Buffer::Iterator i = tmp.End ();
-      i.Prev (dataEnd);
-      i.Write (m_data->m_data+m_zeroAreaStart,dataEnd);
+      tmp.AddAtStart (GetSize ());
+      tmp.Begin ().Write (Begin (), End ());
       NS_ASSERT (tmp.CheckInternalState ());
       return tmp;
     }
@@ -561,6 +796,11 @@ uint32_t
 Buffer::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_slice != 0)
+    {
+      /* the bytes of the slice are serialized as start data. */
+      return sizeof (uint32_t) + sizeof (uint32_t) + ((GetSize () + 3) & (~0x3)) + sizeof (uint32_t);
+    }
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -581,6 +821,10 @@ uint32_t
 Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  if (m_slice != 0)
+    {
+      return CreateFullCopy ().Serialize (buffer, maxSize);
+    }
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -729,6 +973,11 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
           size -= m_zeroAreaStart-m_start;
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
           uint32_t left = tmpsize;
+          if (m_slice != 0)
+            {
+              os->write ((const char*)(m_slice->m_data + m_sliceStart), left);
+              left = 0;
+            }
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
@@ -760,6 +1009,12 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
         { 
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
           uint32_t left = tmpsize;
+          if (m_slice != 0)
+            {
+              memcpy (buffer, m_slice->m_data + m_sliceStart, left);
+              buffer += left;
+              left = 0;
+            }
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
@@ -844,27 +1099,42 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+  m_current += size;
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      if (start.m_slice != 0)
+        {
+          memcpy (to, &start.m_slice[start.m_current - start.m_zeroStart], toCopy);
+        }
+      else
+        {
+          memset (to, 0, toCopy);
+        }
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
-  m_current += toCopy;
 }
 
 void 
@@ -24,6 +24,9 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 #define BUFFER_FREE_LIST 1
 
@@ -88,6 +91,21 @@ namespace ns3 {
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * The "virtual zero area" can also be backed by the bytes of another
+ * BufferData instance, the "slice": when bytes must be added to a Buffer
+ * which has no zero area, which is larger than a few hundred bytes, and
+ * whose BufferData cannot be written to (typically a fragment created
+ * by CreateFragment) or is too small, its content becomes the slice of
+ * a new, small, BufferData which holds the added bytes.  The bytes of
+ * the slice are shared with the other Buffer instances, and not copied.
+ * Likewise, a large Buffer without zero area appended to a Buffer
+ * without zero area becomes its slice.  Like the zero bytes, the bytes
+ * of the slice can be read but not written.
+ *
+ * The BufferData instances are recycled in free lists, one per size
+ * class (powers of two) and, when the multithreaded simulator is
+ * enabled, per thread.
  */
 class Buffer 
 {
@@ -482,6 +500,11 @@ private:
      * to this pointer.
      */
     uint8_t *m_data;
+    /**
+     * a pointer to the bytes of the slice which back the "virtual zero
+     * area", from its start, or null if the area holds zeroes.
+     */
+    uint8_t const *m_slice;
   };
 
   /**
@@ -642,6 +665,31 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * Statistics of the BufferData free lists, and of the slices, of the
+   * calling thread.
+   */
+  struct PoolStatistics
+  {
+    uint64_t allocations; //!< Number of BufferData allocated from the heap.
+    uint64_t reuses;      //!< Number of BufferData taken from a free list.
+    uint64_t recycles;    //!< Number of BufferData put back in a free list.
+    uint64_t frees;       //!< Number of BufferData returned to the heap.
+    uint32_t cached;      //!< Number of BufferData in the free lists.
+    uint64_t cachedBytes; //!< Size of the BufferData in the free lists.
+    uint64_t slices;      //!< Number of slices created.
+    uint64_t slicedBytes; //!< Number of bytes shared by slices rather than copied.
+  };
+  /**
+   * \returns the statistics of the BufferData free lists of the calling
+   *          thread.
+   */
+  static PoolStatistics GetPoolStatistics (void);
+  /**
+   * \returns true if this buffer holds bytes shared through a slice.
+   */
+  bool HasSlice (void) const;
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -663,7 +711,11 @@ private:
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
      */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /**
      * the size of the m_data field below.
      */
@@ -726,6 +778,27 @@ private:
    */
   uint32_t GetInternalEnd (void) const;
 
+  /**
+   * \brief Move the bytes of this buffer to the slice of a new buffer
+   * data storage, instead of copying them.
+   *
+   * This buffer must have no zero area.
+   *
+   * \param start the free space needed before the bytes
+   * \param end the free space needed after the bytes
+   */
+  void CreateSlice (uint32_t start, uint32_t end);
+  /**
+   * \brief Check whether the bytes of this buffer should be moved to a
+   * slice rather than copied.
+   * \returns true if the bytes should be moved to a slice.
+   */
+  bool CanSlice (void) const;
+  /**
+   * \brief Release the slice, once the zero area is empty.
+   */
+  void ReleaseSlice (void);
+
   /**
    * \brief Recycle the buffer memory
    * \param data the buffer data storage
@@ -750,6 +823,16 @@ private:
   static void Deallocate (struct Buffer::Data *data);
 
   struct Data *m_data; //!< the buffer data storage
+  /**
+   * the buffer data storage whose bytes back the "virtual zero area",
+   * or null if the area holds zeroes.
+   */
+  struct Data *m_slice;
+  /**
+   * offset to the bytes backing the start of the "virtual zero area"
+   * from the start of m_slice->m_data
+   */
+  uint32_t m_sliceStart;
 
   /**
    * keep track of the maximum value of m_zeroAreaStart across
@@ -767,7 +850,11 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
+#ifdef NS3_MTP
+  static thread_local uint32_t g_recommendedStart;
+#else
   static uint32_t g_recommendedStart;
+#endif
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -798,10 +885,23 @@ private:
   {
     ~LocalStaticDestructor ();
   };
+#ifdef NS3_MTP
+  // One set of free lists per thread, so that the threads of the
+  // MultithreadedSimulatorImpl do not need to synchronize.
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data containers, one per size class
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+#else
   static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
+  static FreeList *g_freeList; //!< Buffer data containers, one per size class
   static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
+#endif
+#ifdef NS3_MTP
+  static thread_local PoolStatistics g_poolStatistics; //!< Free list statistics
+#else
+  static PoolStatistics g_poolStatistics; //!< Free list statistics
+#endif
 };
 
 } // namespace ns3
@@ -817,7 +917,8 @@ Buffer::Iterator::Iterator ()
     m_dataStart (0),
     m_dataEnd (0),
     m_current (0),
-    m_data (0)
+    m_data (0),
+    m_slice (0)
 {
 }
 Buffer::Iterator::Iterator (Buffer const*buffer)
@@ -839,6 +940,7 @@ Buffer::Iterator::Construct (const Buffer *buffer)
   m_dataStart = buffer->m_start;
   m_dataEnd = buffer->m_end;
   m_data = buffer->m_data->m_data;
+  m_slice = buffer->m_slice != 0 ? buffer->m_slice->m_data + buffer->m_sliceStart : 0;
 }
 
 void 
@@ -1008,7 +1110,7 @@ Buffer::Iterator::PeekU8 (void)
     }
   else if (m_current < m_zeroEnd)
     {
-      return 0;
+      return m_slice != 0 ? m_slice[m_current - m_zeroStart] : 0;
     }
   else
     {
@@ -1049,6 +1151,8 @@ Buffer::Iterator::Read (Buffer::Iterator start, uint32_t size)
 
 Buffer::Buffer (Buffer const&o)
   : m_data (o.m_data),
+    m_slice (o.m_slice),
+    m_sliceStart (o.m_sliceStart),
     m_maxZeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
@@ -1056,6 +1160,10 @@ Buffer::Buffer (Buffer const&o)
     m_end (o.m_end)
 {
   m_data->m_count++;
+  if (m_slice != 0)
+    {
+      m_slice->m_count++;
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
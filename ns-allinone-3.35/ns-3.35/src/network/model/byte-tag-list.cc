@@ -22,6 +22,9 @@
 #include <vector>
 #include <cstring>
 #include <limits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
 #define USE_FREE_LIST 1
 #define FREE_LIST_SIZE 1000
@@ -40,7 +43,11 @@ NS_LOG_COMPONENT_DEFINE ("ByteTagList");
  */
 struct ByteTagListData {
   uint32_t size;   //!< size of the data
+#ifdef NS3_MTP
+  std::atomic<uint32_t> count;  //!< use counter (for smart deallocation)
+#else
   uint32_t count;  //!< use counter (for smart deallocation)
+#endif
   uint32_t dirty;  //!< number of bytes actually in use
   uint8_t data[4]; //!< data
 };
@@ -53,12 +60,20 @@ struct ByteTagListData {
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
 public:
   ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
+};
+#ifdef NS3_MTP
+// One free list per thread, so that the threads of the
+// MultithreadedSimulatorImpl do not need to synchronize.
+static thread_local ByteTagListDataFreeList g_freeList; //!< Container for struct ByteTagListData
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#else
+static ByteTagListDataFreeList g_freeList; //!< Container for struct ByteTagListData
 static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#endif
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -199,8 +214,14 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_data = Allocate (spaceNeeded);
       m_used = 0;
     } 
+#ifdef NS3_MTP
+  // Shared data may be used by another thread: never write to it.
+  else if (m_data->size < spaceNeeded ||
+           m_data->count != 1)
+#else
   else if (m_data->size < spaceNeeded ||
            (m_data->count != 1 && m_data->dirty != m_used))
+#endif
     {
       struct ByteTagListData *newData = Allocate (spaceNeeded);
       std::memcpy (&newData->data, &m_data->data, m_used);
@@ -282,28 +303,7 @@ ByteTagList::AddAtEnd (int32_t appendOffset)
     {
       return;
     }
-  ByteTagList list;
-  ByteTagList::Iterator i = BeginAll ();
-  while (i.HasNext ())
-    {
-      ByteTagList::Iterator::Item item = i.Next ();
-
-      if (item.start >= appendOffset)
-        {
-          continue;
-        }
-      if (item.end > appendOffset)
-        {
-          item.end = appendOffset;
-        }
-      TagBuffer buf = list.Add (item.tid, item.size, item.start, item.end);
-      buf.CopyFrom (item.buf);
-      if (item.end > m_maxEnd)
-        {
-          m_maxEnd = item.end;
-        }
-    }
-  *this = list;
+  Clip (0, appendOffset);
 }
 
 void 
@@ -314,29 +314,69 @@ ByteTagList::AddAtStart (int32_t prependOffset)
     {
       return;
     }
-  m_minStart = INT32_MAX;
-  ByteTagList list;
-  ByteTagList::Iterator i = BeginAll ();
-  while (i.HasNext ())
-    {
-      ByteTagList::Iterator::Item item = i.Next ();
+  Clip (std::max (prependOffset, 0), OFFSET_MAX);
+}
 
-      if (item.end <= prependOffset)
-        {
-          continue;
-        }
-      if (item.start < prependOffset)
-        {
-          item.start = prependOffset;
-        }
-      TagBuffer buf = list.Add (item.tid, item.size, item.start, item.end);
-      buf.CopyFrom (item.buf);
-      if (item.start < m_minStart)
+void
+ByteTagList::Clip (int32_t start, int32_t end)
+{
+  NS_LOG_FUNCTION (this << start << end);
+  if (m_data == 0)
+    {
+      return;
+    }
+  struct ByteTagListData *data = m_data;
+  if (m_data->count != 1)
+    {
+      data = Allocate (m_used);
+    }
+  int32_t minStart = INT32_MAX;
+  int32_t maxEnd = INT32_MIN;
+  uint32_t used = 0;
+  uint32_t current = 0;
+  while (current < m_used)
+    {
+      TagBuffer buf = TagBuffer (&m_data->data[current], &m_data->data[m_used]);
+      uint32_t tid = buf.ReadU32 ();
+      uint32_t size = buf.ReadU32 ();
+      int32_t tagStart = buf.ReadU32 () + m_adjustment;
+      int32_t tagEnd = buf.ReadU32 () + m_adjustment;
+      uint32_t tagSize = 4 + 4 + 4 + 4 + size;
+      tagStart = std::max (tagStart, start);
+      tagEnd = std::min (tagEnd, end);
+      if (tagStart < tagEnd)
         {
-          m_minStart = item.start;
+          tagStart -= m_adjustment;
+          tagEnd -= m_adjustment;
+          if (data != m_data || used != current)
+            {
+              std::memmove (&data->data[used + 16], &m_data->data[current + 16], size);
+            }
+          TagBuffer tag = TagBuffer (&data->data[used], &data->data[used + tagSize]);
+          tag.WriteU32 (tid);
+          tag.WriteU32 (size);
+          tag.WriteU32 (tagStart);
+          tag.WriteU32 (tagEnd);
+          minStart = std::min (minStart, tagStart);
+          maxEnd = std::max (maxEnd, tagEnd);
+          used += tagSize;
         }
+      current += tagSize;
+    }
+  if (data != m_data)
+    {
+      Deallocate (m_data);
+      m_data = data;
+    }
+  if (used == 0)
+    {
+      RemoveAll ();
+      return;
     }
-  *this = list;
+  m_used = used;
+  m_data->dirty = used;
+  m_minStart = minStart;
+  m_maxEnd = maxEnd;
 }
 
 #ifdef USE_FREE_LIST
@@ -376,8 +416,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
       return;
     }
   g_maxSize = std::max (g_maxSize, data->size);
-  data->count--;
-  if (data->count == 0)
+  if (--data->count == 0)
     {
       if (g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
@@ -414,8 +453,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  data->count--;
-  if (data->count == 0)
+  if (--data->count == 0)
     {
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
@@ -58,7 +58,8 @@ struct ByteTagListData;
  *     boundaries remain in ByteTagList. It is not a problem as iterator fixes
  *     the boundaries before returning item. However, when packet is extending,
  *     it calls ByteTagList::AddAtStart or ByteTagList::AddAtEnd to cut byte
- *     tags that will otherwise cover new bytes.
+ *     tags that will otherwise cover new bytes.  The cut is done in place
+ *     when the buffer is not shared.
  */
 class ByteTagList
 {
@@ -262,6 +263,17 @@ private:
    */
   ByteTagList::Iterator BeginAll (void) const;
 
+  /**
+   * \brief Keep only the parts of the tags within [start, end)
+   *
+   * The tags are copied to a new buffer, in a single pass, if the
+   * buffer is shared, and moved in place otherwise.
+   *
+   * \param start the minimum offset of the tags kept
+   * \param end the maximum offset of the tags kept
+   */
+  void Clip (int32_t start, int32_t end);
+
   /**
    * \brief Allocate the memory for the ByteTagListData
    * \param size the memory to allocate
@@ -34,9 +34,16 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
+#ifdef NS3_MTP
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local bool PacketMetadata::m_freeListDestroyed = false;
+#else
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+#endif
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -45,7 +52,11 @@ PacketMetadata::DataFreeList::~DataFreeList ()
     {
       PacketMetadata::Deallocate (*i);
     }
+#ifdef NS3_MTP
+  PacketMetadata::m_freeListDestroyed = true;
+#else
   PacketMetadata::m_enable = false;
+#endif
 }
 
 void 
@@ -77,8 +88,7 @@ PacketMetadata::ReserveCopy (uint32_t size)
   struct PacketMetadata::Data *newData = PacketMetadata::Create (m_used + size);
   memcpy (newData->m_data, m_data->m_data, m_used);
   newData->m_dirtyEnd = m_used;
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
@@ -100,10 +110,15 @@ PacketMetadata::Reserve (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
   NS_ASSERT (m_data != 0);
+#ifdef NS3_MTP
+  // Shared data may be used by another thread: never write to it.
   if (m_data->m_size >= m_used + size &&
-      (m_head == 0xffff ||
-       m_data->m_count == 1 ||
+      m_data->m_count == 1)
+#else
+  if (m_data->m_size >= m_used + size &&
+      (m_data->m_count == 1 ||
        m_data->m_dirtyEnd == m_used))
+#endif
     {
       /* enough room, not dirty. */
     }
@@ -379,10 +394,14 @@ PacketMetadata::AddSmall (const struct PacketMetadata::SmallItem *item)
   uint32_t typeUidSize = GetUleb128Size (item->typeUid);
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t n =  2 + 2 + typeUidSize + sizeSize + 2;
+#ifdef NS3_MTP
+  if (m_used + n > m_data->m_size ||
+      m_data->m_count != 1)
+#else
   if (m_used + n > m_data->m_size ||
-      (m_head != 0xffff &&
-       m_data->m_count != 1 &&
+      (m_data->m_count != 1 &&
        m_used != m_data->m_dirtyEnd))
+#endif
     {
       ReserveCopy (n);
     }
@@ -417,10 +436,14 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   uint32_t fragEndSize = GetUleb128Size (extraItem->fragmentEnd);
   uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
+#ifdef NS3_MTP
   if (m_used + n > m_data->m_size ||
-      (m_head != 0xffff &&
-       m_data->m_count != 1 &&
+      m_data->m_count != 1)
+#else
+  if (m_used + n > m_data->m_size ||
+      (m_data->m_count != 1 &&
        m_used != m_data->m_dirtyEnd))
+#endif
     {
       ReserveCopy (n);
     }
@@ -496,31 +519,101 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
       Append32 (extraItem->packetUid, buffer);
       m_used = std::max (m_used, (uint16_t)(buffer - &m_data->m_data[0]));
       m_data->m_dirtyEnd = m_used;
-      return;
+    }
+  else
+    {
+      /* Below is the slow path which is hit if the new tail we want
+       * to append is bigger than the previous tail, or if the buffer
+       * is shared: the new tail is appended to the buffer, and the
+       * previous item is linked to it, which needs our own buffer.
+       */
+      bool single = m_head == m_tail;
+      if (m_data->m_count != 1 && !single)
+        {
+          ReserveCopy (n);
+        }
+      uint16_t written = AddBig (0xffff, single ? 0xffff : item->prev, item, extraItem);
+      if (single)
+        {
+          m_head = m_used;
+        }
+      else
+        {
+          uint8_t *previous = &m_data->m_data[item->prev];
+          Append16 (m_used, previous);
+        }
+      m_tail = m_used;
+      m_used += written;
+      m_data->m_dirtyEnd = m_used;
     }
 
-  /* Below is the slow path which is hit if the new tail we want 
-   * to append is bigger than the previous tail.
-   */
+  // the trims of the previous tail were read in the item.
+  if (m_head == m_tail)
+    {
+      m_headTrim = 0;
+    }
+  m_tailTrim = 0;
+}
 
-  // create a copy of the packet without its tail.
-  PacketMetadata h (m_packetUid, 0);
-  uint16_t current = m_head;
-  while (current != 0xffff && current != m_tail)
+void
+PacketMetadata::ApplyHeadTrim (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_headTrim != 0);
+  struct PacketMetadata::SmallItem item;
+  PacketMetadata::ExtraItem extraItem;
+  ReadItems (m_head, &item, &extraItem);
+  bool single = m_head == m_tail;
+  m_headTrim = 0;
+  if (single)
+    {
+      m_tailTrim = 0;
+    }
+  else if (m_data->m_count != 1)
+    {
+      // the next item is linked to the new head.
+      ReserveCopy (0);
+    }
+  uint16_t written = AddBig (single ? 0xffff : item.next, 0xffff, &item, &extraItem);
+  if (single)
+    {
+      m_tail = m_used;
+    }
+  else
     {
-      struct PacketMetadata::SmallItem tmpItem;
-      PacketMetadata::ExtraItem tmpExtraItem;
-      ReadItems (current, &tmpItem, &tmpExtraItem);
-      uint16_t written = h.AddBig (0xffff, h.m_tail, 
-                                   &tmpItem, &tmpExtraItem);
-      h.UpdateTail (written);
-      current = tmpItem.next;
+      uint8_t *next = &m_data->m_data[item.next + 2];
+      Append16 (m_used, next);
     }
-  // append new tail.
-  uint16_t written = h.AddBig (0xffff, h.m_tail, item, extraItem);
-  h.UpdateTail (written);
+  m_head = m_used;
+  m_used += written;
+  m_data->m_dirtyEnd = m_used;
+}
 
-  *this = h;
+void
+PacketMetadata::ApplyTailTrim (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_tailTrim != 0);
+  struct PacketMetadata::SmallItem item;
+  PacketMetadata::ExtraItem extraItem;
+  uint32_t read = ReadItems (m_tail, &item, &extraItem);
+  ReplaceTail (&item, &extraItem, read);
+}
+
+void
+PacketMetadata::ForbidSharedAppend (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifndef NS3_MTP
+  /* The removed item can be linked to the items of the other
+   * packets sharing the buffer: the next item written by any of them
+   * must go to a copy of the buffer.
+   */
+  if (m_data->m_count != 1)
+    {
+      m_data->m_dirtyEnd = 0xffff;
+    }
+#endif
 }
 
 
@@ -562,6 +655,16 @@ PacketMetadata::ReadItems (uint16_t current,
       extraItem->fragmentEnd = item->size;
       extraItem->packetUid = m_packetUid;
     }
+  if (current == m_head && m_headTrim != 0)
+    {
+      item->typeUid |= 0x1;
+      extraItem->fragmentStart += m_headTrim;
+    }
+  if (current == m_tail && m_tailTrim != 0)
+    {
+      item->typeUid |= 0x1;
+      extraItem->fragmentEnd -= m_tailTrim;
+    }
   NS_ASSERT (buffer <= &m_data->m_data[m_data->m_size]);
   return buffer - &m_data->m_data[current];
 }
@@ -596,7 +699,11 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
+#ifdef NS3_MTP
+  if (!m_enable || m_freeListDestroyed)
+#else
   if (!m_enable)
+#endif
     {
       PacketMetadata::Deallocate (data);
       return;
@@ -669,6 +776,10 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
       return;
     }
 
+  if (m_headTrim != 0)
+    {
+      ApplyHeadTrim ();
+    }
   struct PacketMetadata::SmallItem item;
   item.next = m_head;
   item.prev = 0xffff;
@@ -712,6 +823,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
         }
       return;
     }
+  ForbidSharedAppend ();
   if (m_head + read == m_used)
     {
       m_used = m_head;
@@ -720,6 +832,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
     {
       m_head = 0xffff;
       m_tail = 0xffff;
+      m_tailTrim = 0;
     }
   else
     {
@@ -738,6 +851,10 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (m_tailTrim != 0)
+    {
+      ApplyTailTrim ();
+    }
   struct PacketMetadata::SmallItem item;
   item.next = 0xffff;
   item.prev = m_tail;
@@ -782,6 +899,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
         }
       return;
     }
+  ForbidSharedAppend ();
   if (m_tail + read == m_used)
     {
       m_used = m_tail;
@@ -790,6 +908,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
     {
       m_head = 0xffff;
       m_tail = 0xffff;
+      m_headTrim = 0;
     }
   else
     {
@@ -855,6 +974,10 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
     }
   else
     {
+      if (m_tailTrim != 0)
+        {
+          ApplyTailTrim ();
+        }
       current = o.m_head;
     }
 
@@ -907,35 +1030,26 @@ PacketMetadata::RemoveAtStart (uint32_t start)
       if (itemRealSize <= leftToRemove)
         {
           // remove from list.
+          ForbidSharedAppend ();
           if (m_head == m_tail)
             {
               m_head = 0xffff;
               m_tail = 0xffff;
+              m_tailTrim = 0;
             }
           else
             {
               m_head = item.next;
             }
+          m_headTrim = 0;
           leftToRemove -= itemRealSize;
         }
       else
         {
-          // fragment the list item.
-          PacketMetadata fragment (m_packetUid, 0);
+          // fragment the list item: the buffer is left untouched.
+          m_headTrim += leftToRemove;
           extraItem.fragmentStart += leftToRemove;
           leftToRemove = 0;
-          uint16_t written = fragment.AddBig (0xffff, fragment.m_tail,
-                                              &item, &extraItem);
-          fragment.UpdateTail (written);
-          while (current != 0xffff && current != m_tail)
-            {
-              current = item.next;
-              ReadItems (current, &item, &extraItem);
-              written = fragment.AddBig (0xffff, fragment.m_tail,
-                                         &item, &extraItem);
-              fragment.UpdateTail (written);
-            }
-          *this = fragment;
         }
       NS_ASSERT (item.size >= extraItem.fragmentEnd - extraItem.fragmentStart &&
                  extraItem.fragmentStart <= extraItem.fragmentEnd);
@@ -971,36 +1085,27 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
       if (itemRealSize <= leftToRemove)
         {
           // remove from list.
+          ForbidSharedAppend ();
           if (m_head == m_tail)
             {
               m_head = 0xffff;
               m_tail = 0xffff;
+              m_headTrim = 0;
             }
           else
             {
               m_tail = item.prev;
             }
+          m_tailTrim = 0;
           leftToRemove -= itemRealSize;
         }
       else
         {
-          // fragment the list item.
-          PacketMetadata fragment (m_packetUid, 0);
+          // fragment the list item: the buffer is left untouched.
           NS_ASSERT (extraItem.fragmentEnd > leftToRemove);
+          m_tailTrim += leftToRemove;
           extraItem.fragmentEnd -= leftToRemove;
           leftToRemove = 0;
-          uint16_t written = fragment.AddBig (fragment.m_head, 0xffff,
-                                              &item, &extraItem);
-          fragment.UpdateHead (written);
-          while (current != 0xffff && current != m_head)
-            {
-              current = item.prev;
-              ReadItems (current, &item, &extraItem);
-              written = fragment.AddBig (fragment.m_head, 0xffff,
-                                         &item, &extraItem);
-              fragment.UpdateHead (written);
-            }
-          *this = fragment;
         }
       NS_ASSERT (item.size >= extraItem.fragmentEnd - extraItem.fragmentStart &&
                  extraItem.fragmentStart <= extraItem.fragmentEnd);
@@ -23,6 +23,9 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -74,6 +77,20 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * The data buffer is append-only: the items of a packet are never
+ * moved, and the copies of a packet share the buffer until one of
+ * them needs to write an item which is not at the end of the buffer,
+ * in which case it makes its own copy of the buffer.
+ *
+ * A fragment (see CreateFragment) shares the buffer of its packet:
+ * the bytes removed from its first and last items are kept apart
+ * (m_headTrim and m_tailTrim), and are only written to the buffer,
+ * as new "big" copies of these items, when another item must be
+ * added before the first item or after the last one.  Until
+ * then, they are applied when the items are decoded, which happens
+ * only when a header or trailer is removed, when packets are
+ * concatenated and when the items are printed or serialized.
  */
 class PacketMetadata 
 {
@@ -413,7 +430,11 @@ private:
    */
   struct Data {
     /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /** size (in bytes) of m_data buffer below */
     uint16_t m_size;
     /** max of the m_used field over all objects which
@@ -536,6 +557,19 @@ public:
   void ReplaceTail (PacketMetadata::SmallItem *item, 
                     PacketMetadata::ExtraItem *extraItem,
                     uint32_t available);
+  /**
+   * \brief Write the bytes removed from the head item in a new head item
+   */
+  void ApplyHeadTrim (void);
+  /**
+   * \brief Write the bytes removed from the tail item in a new tail item
+   */
+  void ApplyTailTrim (void);
+  /**
+   * \brief Make the packets sharing the buffer copy it before they
+   * write an item, because an item was removed from the list
+   */
+  inline void ForbidSharedAppend (void);
   /**
    * \brief Update the head
    * \param written the used bytes
@@ -661,7 +695,13 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
+#ifdef NS3_MTP
+  static thread_local DataFreeList m_freeList; //!< the metadata data storage
+  /** Set when the free list of this thread has been destroyed. */
+  static thread_local bool m_freeListDestroyed;
+#else
   static DataFreeList m_freeList; //!< the metadata data storage
+#endif
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -672,8 +712,13 @@ public:
    */
   static bool m_metadataSkipped;
 
+#ifdef NS3_MTP
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+  static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
   static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
   struct Data *m_data; //!< Metadata storage
   /*
@@ -684,6 +729,8 @@ public:
   uint16_t m_head; //!< list head
   uint16_t m_tail; //!< list tail
   uint16_t m_used; //!< used portion
+  uint32_t m_headTrim; //!< bytes removed from the head item, not yet written
+  uint32_t m_tailTrim; //!< bytes removed from the tail item, not yet written
   uint64_t m_packetUid; //!< packet Uid
 };
 
@@ -696,6 +743,8 @@ PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
+    m_headTrim (0),
+    m_tailTrim (0),
     m_packetUid (uid)
 {
   memset (m_data->m_data, 0xff, 4);
@@ -709,6 +758,8 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
     m_head (o.m_head),
     m_tail (o.m_tail),
     m_used (o.m_used),
+    m_headTrim (o.m_headTrim),
+    m_tailTrim (o.m_tailTrim),
     m_packetUid (o.m_packetUid)
 {
   NS_ASSERT (m_data != 0);
@@ -722,8 +773,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           PacketMetadata::Recycle (m_data);
         }
@@ -734,14 +784,15 @@ PacketMetadata::operator = (PacketMetadata const& o)
   m_head = o.m_head;
   m_tail = o.m_tail;
   m_used = o.m_used;
+  m_headTrim = o.m_headTrim;
+  m_tailTrim = o.m_tailTrim;
   m_packetUid = o.m_packetUid;
   return *this;
 }
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
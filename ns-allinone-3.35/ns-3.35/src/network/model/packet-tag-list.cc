@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a list of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -29,275 +29,300 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+#define FREE_LIST_SIZE 1000
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-PacketTagList::TagData *
-PacketTagList::CreateTagData (size_t dataSize)
-{
-  NS_ASSERT_MSG (dataSize
-                 < std::numeric_limits<decltype(TagData::size)>::max (),
-                 "Requested TagData size " << dataSize
-                 << " exceeds maximum "
-                 << std::numeric_limits<decltype(TagData::size)>::max () );
-
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+namespace {
 
-  TagData * tag = new (p) TagData;
-  tag->size = dataSize;
-  return tag;
+/**
+ * \ingroup packet
+ *
+ * \brief Container of the unused PacketTagList buffers.
+ *
+ * Internal use only.
+ */
+class PacketTagListDataFreeList : public std::vector<uint8_t *>
+{
+public:
+  ~PacketTagListDataFreeList ()
+  {
+    for (iterator i = begin (); i != end (); i++)
+      {
+        delete [] *i;
+      }
+  }
+};
+
+#ifdef NS3_MTP
+// One free list per thread, so that the threads of the
+// MultithreadedSimulatorImpl do not need to synchronize.
+thread_local PacketTagListDataFreeList g_freeList; //!< The unused buffers
+thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#else
+PacketTagListDataFreeList g_freeList; //!< The unused buffers
+uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#endif
+
+} // unnamed namespace
+
+struct PacketTagList::TagListData *
+PacketTagList::Allocate (uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  while (!g_freeList.empty ())
+    {
+      struct TagListData *data = (struct TagListData *)g_freeList.back ();
+      g_freeList.pop_back ();
+      if (data->size >= size)
+        {
+          data->count = 1;
+          data->dirty = 0;
+          return data;
+        }
+      data->~TagListData ();
+      delete [] (uint8_t *)data;
+    }
+  size = std::max (size, g_maxSize);
+  uint8_t *buffer = new uint8_t [sizeof (struct TagListData) + size];
+  struct TagListData *data = new (buffer) TagListData;
+  data->count = 1;
+  data->size = size;
+  data->dirty = 0;
+  return data;
 }
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
+void
+PacketTagList::Deallocate (struct TagListData *data)
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
-
-  // trivial case when list is empty
-  if (m_next == 0)
+  NS_LOG_FUNCTION (data);
+  NS_ASSERT (data->count == 0);
+  g_maxSize = std::max (g_maxSize, data->size);
+  if (g_freeList.size () > FREE_LIST_SIZE
+      || data->size < g_maxSize)
     {
-      return false;
+      data->~TagListData ();
+      delete [] (uint8_t *)data;
+    }
+  else
+    {
+      g_freeList.push_back ((uint8_t *)data);
     }
+}
 
-  bool found = false;
+uint32_t
+PacketTagList::GetUsedSize (void) const
+{
+  if (m_head == 0)
+    {
+      return 0;
+    }
+  return (uint8_t *)m_head - m_data->data + GetTagDataSize (m_head->size);
+}
 
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
+void
+PacketTagList::Link (uint32_t used)
+{
+  NS_LOG_FUNCTION (this << used);
+  m_head = 0;
+  for (uint32_t offset = 0; offset < used; )
+    {
+      struct TagData *cur = (struct TagData *)&m_data->data[offset];
+      cur->next = m_head;
+      m_head = cur;
+      offset += GetTagDataSize (cur->size);
+    }
+}
 
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
+struct PacketTagList::TagData *
+PacketTagList::Find (TypeId tid) const
+{
+  if ((m_mask & GetMaskBit (tid)) == 0)
     {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
+      return 0;
+    }
+  for (struct TagData *cur = m_head; cur != 0; cur = cur->next)
+    {
+      if (cur->tid == tid)
         {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
+          return cur;
         }
-      else
+    }
+  return 0;
+}
+
+struct PacketTagList::TagData *
+PacketTagList::Append (TypeId tid, uint32_t dataSize)
+{
+  NS_LOG_FUNCTION (this << tid << dataSize);
+  NS_ASSERT_MSG (dataSize
+                 < std::numeric_limits<decltype(TagData::size)>::max () / 2,
+                 "Requested TagData size " << dataSize
+                 << " exceeds maximum "
+                 << std::numeric_limits<decltype(TagData::size)>::max () / 2);
+
+  uint32_t used = GetUsedSize ();
+  uint32_t needed = used + GetTagDataSize (dataSize);
+  if (m_data == 0)
+    {
+      m_data = Allocate (needed);
+    }
+#ifdef NS3_MTP
+  // Shared data may be used by another thread: never write to it.
+  else if (m_data->size < needed || m_data->count != 1)
+#else
+  else if (m_data->size < needed
+           || (m_data->count != 1 && m_data->dirty != used))
+#endif
+    {
+      struct TagListData *data = Allocate (needed);
+      std::memcpy (data->data, m_data->data, used);
+      if (--m_data->count == 0)
         {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
+          Deallocate (m_data);
         }
-    }  // while !found && !cow
+      m_data = data;
+      Link (used);
+    }
+  struct TagData *cur = new (&m_data->data[used]) TagData;
+  cur->next = m_head;
+  cur->tid = tid;
+  cur->size = dataSize;
+  m_data->dirty = needed;
+  m_head = cur;
+  m_mask |= GetMaskBit (tid);
+  return cur;
+}
 
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
+void
+PacketTagList::Rewrite (struct TagData *cur, Tag const *tag)
+{
+  NS_LOG_FUNCTION (this << cur << tag);
+  uint32_t used = GetUsedSize ();
+  uint32_t before = (uint8_t *)cur - m_data->data;
+  uint32_t oldSize = GetTagDataSize (cur->size);
+  uint32_t after = used - before - oldSize;
+  uint32_t dataSize = tag != 0 ? tag->GetSerializedSize () : 0;
+  uint32_t newSize = tag != 0 ? GetTagDataSize (dataSize) : 0;
+
+  struct TagListData *data = m_data;
+  if (m_data->count != 1 || m_data->size < used - oldSize + newSize)
     {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
+      data = Allocate (used - oldSize + newSize);
+      std::memcpy (data->data, m_data->data, before);
     }
-
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
-
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
+  std::memmove (&data->data[before + newSize],
+                &m_data->data[before + oldSize], after);
+  if (tag != 0)
+    {
+      cur = new (&data->data[before]) TagData;
+      cur->tid = tag->GetInstanceTypeId ();
+      cur->size = dataSize;
+      tag->Serialize (TagBuffer (cur->data, cur->data + cur->size));
+    }
+  if (data != m_data)
     {
-      if (it->tid == tid)
+      if (--m_data->count == 0)
         {
-          break;
+          Deallocate (m_data);
         }
+      m_data = data;
     }
-  if (it == 0)
+  used = before + newSize + after;
+  m_data->dirty = used;
+  if (used == 0)
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      RemoveAll ();
     }
-
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+  else
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = CreateTagData (cur->size);
-      copy->tid = cur->tid;
-      copy->count = 1;
-      copy->size = cur->size;
-      memcpy (copy->data, cur->data, copy->size);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      Link (used);
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
 }
 
 bool
 PacketTagList::Remove (Tag & tag)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
-}
-
-// COWWriter implementing Remove
-bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
+  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  struct TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
-      // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      return false;
     }
-  else
+  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
+  if (cur == m_head)
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
+      // The most recent tag: just forget it, even if the buffer is
+      // shared.
+      if (cur->next == 0)
         {
-          // there's a next, so make it a merge
-          cur->next->count++;
+          RemoveAll ();
+          return true;
         }
+      m_head = cur->next;
+      return true;
     }
-  return found;
+  Rewrite (cur, 0);
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  struct TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
       Add (tag);
+      return false;
     }
-  return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  if (m_data->count == 1 && tag.GetSerializedSize () == cur->size)
     {
-      // found tid before first merge, so just rewrite
       tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
     }
   else
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = CreateTagData (tag.GetSerializedSize ());
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data, copy->data + copy->size));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
+      Rewrite (cur, &tag);
     }
-  return found;
+  return true;
 }
 
 void
 PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
-    {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
-                     "Error: cannot add the same kind of tag twice.");
-    }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
-  tag.Serialize (TagBuffer (head->data, head->data + head->size));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  NS_ASSERT_MSG (Find (tid) == 0,
+                 "Error: cannot add the same kind of tag twice.");
+  struct TagData *cur = const_cast<PacketTagList *> (this)->Append (tid, tag.GetSerializedSize ());
+  tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  struct TagData *cur = Find (tag.GetInstanceTypeId ());
+  if (cur == 0)
     {
-      if (cur->tid == tid)
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
+  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
+  return true;
 }
 
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
-  return m_next;
+  return m_head;
 }
 
 uint32_t
@@ -309,7 +334,7 @@ PacketTagList::GetSerializedSize (void) const
 
   size = 4; // numberOfTags
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (struct TagData *cur = m_head; cur != 0; cur = cur->next)
     {
       size += 4; // TagData -> size
 
@@ -346,7 +371,7 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (struct TagData *cur = m_head; cur != 0; cur = cur->next)
     {
       if (size + 4 <= maxSize)
         {
@@ -407,48 +432,46 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
   NS_LOG_INFO("Deserializing number of tags " << numberOfTags);
 
-  struct TagData * prevTag = 0;
+  RemoveAll ();
+  // The first tag serialized is the most recent one, which
+  // is added last.
+  std::vector<const uint32_t *> tags;
   for (uint32_t i = 0; i < numberOfTags; ++i)
     {
+      tags.push_back (p);
       NS_ASSERT (sizeCheck >= 4);
       uint32_t tagSize = *p++;
       sizeCheck -= 4;
 
       uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
       NS_ASSERT (sizeCheck >= hashSize);
-      TypeId::hash_t hash;
-      memcpy (&hash, p, sizeof (TypeId::hash_t));
       p += hashSize / 4;
       sizeCheck -= hashSize;
 
-      TypeId tid = TypeId::LookupByHash(hash);
-
-      NS_LOG_INFO ("Deserializing tag of type " << tid);
-
-      struct TagData * newTag = CreateTagData (tagSize);
-      newTag->count = 1;
-      newTag->next = 0;
-      newTag->tid = tid;
-
-      NS_ASSERT (sizeCheck >= tagSize);
-      memcpy (newTag->data, p, tagSize);
-
       // ensure 4 byte boundary
       uint32_t tagWordSize = (tagSize+3) & (~3);
+      NS_ASSERT (sizeCheck >= tagWordSize);
       p += tagWordSize / 4;
       sizeCheck -= tagWordSize;
+    }
 
-      // Set link list pointers.
-      if (i==0)
-        {
-          m_next = newTag;
-        }
-      else
-        {
-          prevTag->next = newTag;
-        }
+  for (std::vector<const uint32_t *>::reverse_iterator i = tags.rbegin ();
+       i != tags.rend (); ++i)
+    {
+      p = *i;
+      uint32_t tagSize = *p++;
 
-      prevTag = newTag;
+      uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
+      TypeId::hash_t hash;
+      memcpy (&hash, p, sizeof (TypeId::hash_t));
+      p += hashSize / 4;
+
+      TypeId tid = TypeId::LookupByHash(hash);
+
+      NS_LOG_INFO ("Deserializing tag of type " << tid);
+
+      struct TagData * newTag = Append (tid, tagSize);
+      memcpy (newTag->data, p, tagSize);
     }
 
   NS_ASSERT (sizeCheck == 0);
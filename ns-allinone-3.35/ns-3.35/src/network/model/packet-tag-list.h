@@ -22,11 +22,14 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a list of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
 #include <ostream>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/type-id.h"
 
 namespace ns3 {
@@ -51,80 +54,74 @@ class Tag;
  *        rankdir = "LR";
  *        clusterrank = local;
  *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
+ *        PTL1 [ label="<l> PacketTagList A | <h> m_head | m_mask" , shape=Mrecord];
+ *        PTL2 [ label="<l> PacketTagList B | <h> m_head | m_mask" , shape=Mrecord];
+ *        subgraph cluster_data {
+ *          label = "TagListData, count = 2, dirty";
+ *          T1   [ label="<l> T1  | <n> next" ];
+ *          T2   [ label="<l> T2  | <n> next" ];
+ *          T3   [ label="<l> T3  | <n> next" ];
+ *          T4   [ label="<l> T4  | <n> next" ];
  *        };
+ *        NULL [ label="0", shape = ellipse ];
+ *        PTL1:h -> T3:l ;
+ *        PTL2:h -> T4:l ;
+ *        T4:n -> T3:l ;
+ *        T3:n -> T2:l ;
+ *        T2:n -> T1:l ;
+ *        T1:n -> NULL ;
  *      }
  * \enddot
  *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
+ *   - Tags are stored in serialized form in TagData structures
+ *     (<tt>T1-T4</tt> in the diagram), laid out one after the other,
+ *     in the order they were added, in a single buffer, the TagListData.
  *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
+ *   - Each TagData points (\c next pointers in the diagram) to the
+ *     TagData before it in the buffer, so the tags can be walked
+ *     from the most recent one to the first one, which points to 0.
  *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
+ *   - Each PacketTagList points to a TagListData, and to the most
+ *     recent TagData of its tags, \c m_head.  Its tags are all the
+ *     TagData of the buffer up to \c m_head.
  *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
+ *   - Each PacketTagList also keeps a 64 bit mask of its tag types,
+ *     indexed by the TypeId uid modulo 64: most of the #Peek
+ *     and #Remove of a tag type which is not in the list fail without
+ *     reading the buffer.  The others, and the searches of the tags in
+ *     the list, walk the few TagData of a single buffer.  The bits of
+ *     the removed tags are only cleared by #RemoveAll.
  *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ *   - \c count is the number of PacketTagLists pointing to the
+ *     TagListData, and \c dirty the number of bytes of its buffer in use.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
  *   - Copy constructor (PacketTagList(const PacketTagList & o))
  *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
+ *     simply point to the same TagListData and TagData as the original
  *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - #Add appends the new tag to the buffer, in place, if the list is
+ *     the only user of the buffer, or if its tags end where the buffer
+ *     is \c dirty (PacketTagList \c B started as a copy of PacketTagList
+ *     \c A, before \c T4 was added to \c B).  Otherwise, the tags of the
+ *     list are copied to a new buffer first.  This does not affect any
+ *     other PacketTagList, hence this is a \c const function.
+ *
+ *   - #Remove of the most recent tag just moves \c m_head to the previous
+ *     TagData.  #Remove of other tags, and #Replace, modify the buffer
+ *     in place if the list is its only user, and copy the tags of the
+ *     list to a new buffer otherwise.
+ *
+ * The buffers are recycled through a free list, so most lists are
+ * built and copied without allocating memory.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
+   * Serialized tag, in the buffer of a PacketTagList.
    *
    * See PacketTagList for a discussion of the data structure.
    *
@@ -140,8 +137,7 @@ public:
    */
   struct TagData
   {
-    struct TagData * next;      /**< Pointer to next in list */
-    uint32_t count;             /**< Number of incoming links */
+    struct TagData * next;      /**< Pointer to the previous tag added */
     TypeId tid;                 /**< Type of the tag serialized into #data */
     uint32_t size;              /**< Size of the \c data buffer */
     uint8_t data[1];            /**< Serialization buffer */
@@ -156,8 +152,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy, pointing to the same
+   * \ref TagData as \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -173,12 +169,12 @@ public:
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * #RemoveAll's the tags.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the head of this list.
    *
    * \param [in] tag The tag to add
    */
@@ -210,7 +206,7 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
@@ -244,68 +240,99 @@ public:
 
 private:
   /**
-   * Allocate and construct a TagData struct, sizing the data area
-   * large enough to serialize dataSize bytes from a Tag.
+   * Buffer of serialized tags, shared by the PacketTagLists.
+   *
+   * See PacketTagList for a discussion of the data structure.
+   */
+  struct TagListData
+  {
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; /**< Number of PacketTagLists using the buffer */
+#else
+    uint32_t count;             /**< Number of PacketTagLists using the buffer */
+#endif
+    uint32_t size;              /**< Size of the \c data buffer */
+    uint32_t dirty;             /**< Number of bytes of \c data in use */
+    alignas (TagData) uint8_t data[1]; /**< The TagData */
+  };  /* struct TagListData */
+
+  /**
+   * Get a buffer of at least \pname{size} bytes, with a \c count of 1.
+   *
+   * \param [in] size The number of bytes needed.
+   * \returns The buffer.
+   */
+  static struct TagListData * Allocate (uint32_t size);
+  /**
+   * Release a buffer no longer used by any PacketTagList.
+   *
+   * \param [in] data The buffer.
+   */
+  static void Deallocate (struct TagListData *data);
+  /**
+   * Get the space taken by a TagData in the buffer.
    *
    * \param [in] dataSize The serialized size of the Tag.
-   * \returns The newly constructed TagData object.
+   * \returns The size of the TagData, aligned for the next one.
    */
-  static
-  TagData * CreateTagData (size_t dataSize);
-  
+  static inline uint32_t GetTagDataSize (uint32_t dataSize);
   /**
-   * Typedef of method function pointer for copy-on-write operations
+   * Get the bit of a tag type in #m_mask.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] tid The TypeId of the tag.
+   * \returns The bit of the tag type.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  static inline uint64_t GetMaskBit (TypeId tid);
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * \returns The number of bytes of the buffer taken by this list.
+   */
+  uint32_t GetUsedSize (void) const;
+  /**
+   * Find a tag.
+   *
+   * \param [in] tid The TypeId of the tag.
+   * \returns The TagData of the tag, or 0 if not in the list.
+   */
+  struct TagData * Find (TypeId tid) const;
+  /**
+   * Append a TagData to the buffer, copying the buffer first if
+   * it cannot be written in place.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] tid The TypeId of the tag.
+   * \param [in] dataSize The serialized size of the tag.
+   * \returns The new TagData, whose data is to be written by the caller.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  struct TagData * Append (TypeId tid, uint32_t dataSize);
   /**
-   * Copy-on-write implementing Remove.
+   * Rewrite the list, without a tag, or with a new value for it.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * The list is modified in place if it is the only user of the buffer,
+   * and copied to a new buffer otherwise.
+   *
+   * \param [in] cur The TagData of the tag.
+   * \param [in] tag The new value of the tag, or 0 to remove it.
    */
-  bool RemoveWriter  (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  void Rewrite (struct TagData *cur, Tag const *tag);
   /**
-   * Copy-on-write implementing Replace
+   * Set the \c next pointers and #m_head from the TagData
+   * found in the first \pname{used} bytes of the buffer.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] used The number of bytes taken by this list.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  void Link (uint32_t used);
 
   /**
-   * Pointer to first \ref TagData on the list
+   * Buffer of the tags
+   */
+  struct TagListData *m_data;
+  /**
+   * Pointer to the most recent \ref TagData of the list
+   */
+  struct TagData *m_head;
+  /**
+   * Bit mask of (at least) the tag types of the list, see GetMaskBit()
    */
-  struct TagData *m_next;
+  uint64_t m_mask;
 };
 
 } // namespace ns3
@@ -317,16 +344,20 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_data (0),
+    m_head (0),
+    m_mask (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_data (o.m_data),
+    m_head (o.m_head),
+    m_mask (o.m_mask)
 {
-  if (m_next != 0)
+  if (m_data != 0)
     {
-      m_next->count++;
+      m_data->count++;
     }
 }
 
@@ -334,16 +365,18 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (m_data == o.m_data && m_head == o.m_head) 
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (o.m_data != 0)
     {
-      m_next->count++;
+      o.m_data->count++;
     }
+  RemoveAll ();
+  m_data = o.m_data;
+  m_head = o.m_head;
+  m_mask = o.m_mask;
   return *this;
 }
 
@@ -355,27 +388,26 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  if (m_data != 0 && --m_data->count == 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
-        {
-          prev->~TagData ();
-          std::free (prev);
-        }
-      prev = cur;
+      Deallocate (m_data);
     }
-  if (prev != 0) 
-    {
-      prev->~TagData ();
-      std::free (prev);
-    }
-  m_next = 0;
+  m_data = 0;
+  m_head = 0;
+  m_mask = 0;
+}
+
+uint32_t
+PacketTagList::GetTagDataSize (uint32_t dataSize)
+{
+  return (sizeof (TagData) - 1 + dataSize + alignof (TagData) - 1)
+         & ~(uint32_t)(alignof (TagData) - 1);
+}
+
+uint64_t
+PacketTagList::GetMaskBit (TypeId tid)
+{
+  return (uint64_t)1 << (tid.GetUid () & 63);
 }
 
 } // namespace ns3
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <fstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/trace-helper.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-writer.h"
+#include "ns3/binary-trace-reader.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a binary ascii trace, converted
+ * to text, is the same as the text of the default ascii trace sinks.
+ */
+class BinaryTraceTextTestCase : public TestCase
+{
+public:
+  BinaryTraceTextTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Trace the events of a packet in the text and binary streams.
+   * \param p The packet.
+   */
+  void TracePacket (Ptr<const Packet> p);
+
+  Ptr<OutputStreamWrapper> m_text;   //!< The text trace
+  Ptr<OutputStreamWrapper> m_binary; //!< The binary trace
+};
+
+BinaryTraceTextTestCase::BinaryTraceTextTestCase ()
+  : TestCase ("Check that a binary trace converts to the text of the ascii trace")
+{
+}
+
+void
+BinaryTraceTextTestCase::TracePacket (Ptr<const Packet> p)
+{
+  Ptr<OutputStreamWrapper> streams[2] = {m_text, m_binary};
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (streams[i], p);
+      AsciiTraceHelper::DefaultDequeueSinkWithContext (streams[i], "/NodeList/0/DeviceList/1", p);
+      AsciiTraceHelper::DefaultDropSinkWithoutContext (streams[i], p);
+      AsciiTraceHelper::DefaultReceiveSinkWithContext (streams[i], "/NodeList/1/DeviceList/0", p);
+      *streams[i]->GetStream () << "custom line " << p->GetUid () << std::endl;
+    }
+}
+
+void
+BinaryTraceTextTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::ostringstream text;
+  std::string filename = CreateTempDirFilename ("binary.tr");
+  m_text = Create<OutputStreamWrapper> (&text);
+  AsciiTraceHelper ascii;
+  m_binary = ascii.CreateBinaryFileStream (filename);
+
+  Ptr<Packet> p = Create<Packet> (100);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  p->AddHeader (llc);
+  EthernetHeader ethernet (false);
+  ethernet.SetSource (Mac48Address ("00:00:00:00:00:01"));
+  ethernet.SetDestination (Mac48Address ("00:00:00:00:00:02"));
+  p->AddHeader (ethernet);
+  EthernetTrailer trailer;
+  trailer.SetFcs (0x12345678);
+  p->AddTrailer (trailer);
+  Ptr<Packet> fragment = p->CreateFragment (10, 50);
+
+  Simulator::Schedule (MilliSeconds (3), &BinaryTraceTextTestCase::TracePacket, this, p);
+  Simulator::Schedule (MilliSeconds (3), &BinaryTraceTextTestCase::TracePacket, this, fragment);
+  // Further than the delta of a record, to check the absolute times.
+  Simulator::Schedule (Seconds (12.5), &BinaryTraceTextTestCase::TracePacket, this, p);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  *m_binary->GetStream () << "unterminated";
+  text << "unterminated";
+  m_text = 0;
+  m_binary = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot open " << filename);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetResolution (), Time::GetResolution (), "Wrong resolution");
+  std::ostringstream converted;
+  NS_TEST_EXPECT_MSG_EQ (reader.WriteText (converted), true, "Conversion failed");
+  NS_TEST_EXPECT_MSG_EQ (converted.str (), text.str (), "Converted trace differs");
+
+  std::ifstream binary (filename.c_str (), std::ios::binary | std::ios::ate);
+  NS_TEST_EXPECT_MSG_LT (static_cast<uint64_t> (binary.tellg ()), text.str ().size (),
+                         "Binary trace not smaller than text");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to check the columns converted from a binary trace.
+ */
+class BinaryTraceColumnsTestCase : public TestCase
+{
+public:
+  BinaryTraceColumnsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceColumnsTestCase::BinaryTraceColumnsTestCase ()
+  : TestCase ("Check the columns converted from a binary trace")
+{
+}
+
+void
+BinaryTraceColumnsTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("columns.tr");
+  std::string columns = CreateTempDirFilename ("columns.npz");
+  {
+    Ptr<BinaryTraceWriter> writer = Create<BinaryTraceWriter> (filename);
+    for (uint32_t i = 0; i < 10; i++)
+      {
+        writer->Write ('r', MicroSeconds (i), "/NodeList/" + std::to_string (i % 2), Create<Packet> (i));
+      }
+  }
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot open " << filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.WriteColumns (columns), true, "Conversion failed");
+
+  std::ifstream is (columns.c_str (), std::ios::binary);
+  std::string npz ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+  NS_TEST_EXPECT_MSG_EQ (npz.compare (0, 4, "PK\x03\x04"), 0, "Not a zip file");
+  const char *names[] = {"time.npy", "event.npy", "context.npy", "uid.npy", "size.npy",
+                         "headers.npy", "contexts.npy", "header_chains.npy"};
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_EXPECT_MSG_NE (npz.find (names[i]), std::string::npos, "Missing " << names[i]);
+    }
+  NS_TEST_EXPECT_MSG_NE (npz.find ("{'descr': '<u4', 'fortran_order': False, 'shape': (10,), }"),
+                         std::string::npos, "Missing sizes");
+  NS_TEST_EXPECT_MSG_NE (npz.find ("{'descr': '|S11', 'fortran_order': False, 'shape': (2,), }"),
+                         std::string::npos, "Missing contexts");
+  NS_TEST_EXPECT_MSG_EQ (npz.compare (npz.size () - 22, 4, "PK\x05\x06"), 0, "Missing zip directory");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary ascii trace TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTextTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceColumnsTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite; //!< Static variable for test initialization
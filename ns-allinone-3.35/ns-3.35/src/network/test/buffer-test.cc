@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -387,6 +389,188 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Aggregates of zero-filled payloads keep the larger zero area virtual.
+  Buffer first = Buffer (1000);
+  first.AddAtStart (2);
+  first.Begin ().WriteU8 (0x11, 2);
+  first.AddAtEnd (1);
+  i = first.End ();
+  i.Prev (1);
+  i.WriteU8 (0x22);
+  Buffer second = Buffer (3000);
+  second.AddAtStart (1);
+  second.Begin ().WriteU8 (0x33);
+  Buffer aggregate = first;
+  aggregate.AddAtEnd (second);
+  NS_TEST_EXPECT_MSG_EQ (aggregate.GetSize (), 4004, "Wrong aggregate size");
+  NS_TEST_EXPECT_MSG_LT (aggregate.GetSerializedSize (), 1100, "Zero area of the second buffer should stay virtual");
+  i = aggregate.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x1111, "Wrong aggregate bytes");
+  i.Next (1000);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x2233, "Wrong aggregate bytes");
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU8 (), 0, "Wrong aggregate bytes");
+  aggregate = second;
+  aggregate.AddAtEnd (first);
+  NS_TEST_EXPECT_MSG_EQ (aggregate.GetSize (), 4004, "Wrong aggregate size");
+  NS_TEST_EXPECT_MSG_LT (aggregate.GetSerializedSize (), 1100, "Zero area of the first buffer should stay virtual");
+  i = aggregate.End ();
+  i.Prev (1004);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x0011, "Wrong aggregate bytes");
+  i.Next (1001);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU8 (), 0x22, "Wrong aggregate bytes");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer slices and BufferData free lists unit tests.
+ */
+class BufferSliceTest : public TestCase {
+private:
+  /**
+   * Checks the buffer content against the pattern written by Fill
+   * \param b The buffer to check
+   * \param offset The pattern offset of the first byte to check
+   * \param start The first byte to check
+   * \param n The number of bytes to check
+   * \returns true if the bytes match the pattern
+   */
+  bool CheckPattern (const Buffer &b, uint32_t offset, uint32_t start, uint32_t n);
+  /**
+   * Creates a buffer without zero area, filled with a pattern
+   * \param n The buffer size
+   * \returns The buffer
+   */
+  Buffer Fill (uint32_t n);
+public:
+  virtual void DoRun (void);
+  BufferSliceTest ();
+};
+
+BufferSliceTest::BufferSliceTest ()
+  : TestCase ("Buffer slices") {
+}
+
+Buffer
+BufferSliceTest::Fill (uint32_t n)
+{
+  Buffer b;
+  b.AddAtStart (n);
+  Buffer::Iterator i = b.Begin ();
+  for (uint32_t j = 0; j < n; j++)
+    {
+      i.WriteU8 (j % 251);
+    }
+  return b;
+}
+
+bool
+BufferSliceTest::CheckPattern (const Buffer &b, uint32_t offset, uint32_t start, uint32_t n)
+{
+  Buffer::Iterator i = b.Begin ();
+  i.Next (start);
+  for (uint32_t j = 0; j < n; j++)
+    {
+      if (i.ReadU8 () != (offset + j) % 251)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+BufferSliceTest::DoRun (void)
+{
+  Buffer payload = Fill (1000);
+  NS_TEST_EXPECT_MSG_EQ (payload.HasSlice (), false, "Payload should be contiguous");
+
+  // A header added to a shared fragment: the fragment bytes are not copied.
+  Buffer::PoolStatistics before = Buffer::GetPoolStatistics ();
+  Buffer fragment = payload.CreateFragment (100, 400);
+  fragment.AddAtStart (20);
+  fragment.Begin ().WriteU8 (0xaa, 20);
+  Buffer::PoolStatistics after = Buffer::GetPoolStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (fragment.HasSlice (), true, "Fragment should be sliced");
+  NS_TEST_EXPECT_MSG_EQ (after.slices - before.slices, 1, "Wrong number of slices");
+  NS_TEST_EXPECT_MSG_EQ (after.slicedBytes - before.slicedBytes, 400, "Wrong number of sliced bytes");
+  NS_TEST_EXPECT_MSG_EQ (fragment.GetSize (), 420, "Wrong fragment size");
+  NS_TEST_EXPECT_MSG_EQ (fragment.Begin ().ReadU8 (), 0xaa, "Wrong header");
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (fragment, 100, 20, 400), true, "Wrong fragment bytes");
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (payload, 0, 0, 1000), true, "Payload modified");
+
+  // Reads across the slice, trailer, copies and serialization.
+  fragment.AddAtEnd (4);
+  Buffer::Iterator i = fragment.End ();
+  i.Prev (4);
+  i.WriteHtonU32 (0x01020304);
+  i = fragment.Begin ();
+  i.Next (18);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU32 (), 0xaaaa6465, "Wrong read across the slice start");
+  i = fragment.End ();
+  i.Prev (6);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU32 (), 0xf7f80102, "Wrong read across the slice end");
+  uint8_t copy[424];
+  NS_TEST_EXPECT_MSG_EQ (fragment.CopyData (copy, 424), 424, "Wrong copied size");
+  NS_TEST_EXPECT_MSG_EQ (copy[20], 100, "Wrong copied byte");
+  NS_TEST_EXPECT_MSG_EQ (copy[419], 499 % 251, "Wrong copied byte");
+  std::ostringstream os;
+  fragment.CopyData (&os, 424);
+  NS_TEST_EXPECT_MSG_EQ (os.str ().size (), 424, "Wrong streamed size");
+  NS_TEST_EXPECT_MSG_EQ ((uint8_t)os.str ()[20], 100, "Wrong streamed byte");
+  uint32_t serializedSize = fragment.GetSerializedSize ();
+  std::vector<uint32_t> serialized (serializedSize / 4);
+  NS_TEST_EXPECT_MSG_EQ (fragment.Serialize ((uint8_t *)&serialized[0], serializedSize), 1, "Serialization failed");
+  Buffer deserialized (0, false);
+  deserialized.Deserialize ((const uint8_t *)&serialized[0], serializedSize);
+  NS_TEST_EXPECT_MSG_EQ (deserialized.GetSize (), 424, "Wrong deserialized size");
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (deserialized, 100, 20, 400), true, "Wrong deserialized bytes");
+  Buffer other;
+  other.AddAtStart (424);
+  other.Begin ().Write (fragment.Begin (), fragment.End ());
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (other, 100, 20, 400), true, "Wrong written bytes");
+  uint8_t const *peeked = fragment.PeekData ();
+  NS_TEST_EXPECT_MSG_EQ (fragment.HasSlice (), false, "PeekData should make the buffer contiguous");
+  NS_TEST_EXPECT_MSG_EQ (peeked[20], 100, "Wrong peeked byte");
+
+  // Removing the bytes of the slice releases it.
+  fragment = payload.CreateFragment (50, 300);
+  fragment.AddAtStart (8);
+  NS_TEST_EXPECT_MSG_EQ (fragment.HasSlice (), true, "Fragment should be sliced");
+  fragment.RemoveAtStart (58);
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (fragment, 100, 0, 250), true, "Wrong bytes after RemoveAtStart");
+  fragment.RemoveAtEnd (250);
+  NS_TEST_EXPECT_MSG_EQ (fragment.HasSlice (), false, "Slice should be released");
+  NS_TEST_EXPECT_MSG_EQ (fragment.GetSize (), 0, "Buffer should be empty");
+
+  // Aggregation: the appended bytes are not copied.
+  Buffer first = Fill (300);
+  Buffer second = payload.CreateFragment (300, 500);
+  before = Buffer::GetPoolStatistics ();
+  first.AddAtEnd (second);
+  after = Buffer::GetPoolStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.slicedBytes - before.slicedBytes, 500, "Appended bytes should be sliced");
+  NS_TEST_EXPECT_MSG_EQ (first.GetSize (), 800, "Wrong aggregate size");
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (first, 0, 0, 300), true, "Wrong aggregate bytes");
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (first, 300, 300, 500), true, "Wrong aggregate bytes");
+  first.AddAtEnd (2);
+  first.AddAtStart (2);
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (first, 0, 2, 800), true, "Wrong aggregate bytes");
+  Buffer third = first.CreateFragment (250, 100);
+  NS_TEST_EXPECT_MSG_EQ (CheckPattern (third, 248, 0, 100), true, "Wrong fragment of the aggregate");
+
+  // BufferData are reused from the free lists.
+  before = Buffer::GetPoolStatistics ();
+  for (uint32_t j = 0; j < 100; j++)
+    {
+      Buffer tmp;
+      tmp.AddAtStart (1500);
+    }
+  after = Buffer::GetPoolStatistics ();
+  NS_TEST_EXPECT_MSG_GT (after.reuses - before.reuses, 90, "BufferData should be reused");
+  NS_TEST_EXPECT_MSG_LT (after.allocations - before.allocations, 10, "Too many allocations");
 }
 
 /**
@@ -405,6 +589,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferSliceTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
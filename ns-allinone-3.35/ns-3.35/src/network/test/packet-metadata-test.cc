@@ -17,7 +17,9 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include <chrono>
 #include <cstdarg>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include "ns3/test.h"
@@ -30,6 +32,20 @@ using namespace ns3;
 
 namespace {
 
+/**
+ * Get the TypeId name of a test header or trailer.
+ * \param base The name of the class template.
+ * \param n The template argument.
+ * \returns The name.
+ */
+std::string
+GetHistoryName (const char *base, int n)
+{
+  std::ostringstream oss;
+  oss << base << "<" << n << ">";
+  return oss.str ();
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -122,9 +138,7 @@ template <int N>
 TypeId
 HistoryHeader<N>::GetTypeId (void)
 {
-  std::ostringstream oss;
-  oss << "ns3::HistoryHeader<"<<N<<">";
-  static TypeId tid = TypeId (oss.str ().c_str ())
+  static TypeId tid = TypeId (GetHistoryName ("ns3::HistoryHeader", N).c_str ())
     .SetParent<HistoryHeaderBase> ()
     .AddConstructor<HistoryHeader<N> > ()
   ;
@@ -259,9 +273,7 @@ template <int N>
 TypeId
 HistoryTrailer<N>::GetTypeId (void)
 {
-  std::ostringstream oss;
-  oss << "ns3::HistoryTrailer<"<<N<<">";
-  static TypeId tid = TypeId (oss.str ().c_str ())
+  static TypeId tid = TypeId (GetHistoryName ("ns3::HistoryTrailer", N).c_str ())
     .SetParent<HistoryTrailerBase> ()
     .AddConstructor<HistoryTrailer<N> > ()
   ;
@@ -900,6 +912,36 @@ PacketMetadataTest::DoRun (void)
                                  p3->GetSize ());
   delete [] buf;
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
+
+  // fragments share the items of their packet until they are changed.
+  p = Create<Packet> (100);
+  ADD_HEADER (p, 10);
+  ADD_TRAILER (p, 4);
+  p1 = p->CreateFragment (5, 106);
+  CHECK_HISTORY (p1, 3, 5, 100, 1);
+  p2 = p1->CreateFragment (2, 100);
+  CHECK_HISTORY (p2, 2, 3, 97);
+  ADD_HEADER (p1, 8);
+  ADD_TRAILER (p1, 3);
+  CHECK_HISTORY (p1, 5, 8, 5, 100, 1, 3);
+  p1->RemoveAtEnd (3 + 1 + 50);
+  CHECK_HISTORY (p1, 3, 8, 5, 50);
+  REM_HEADER (p1, 8);
+  CHECK_HISTORY (p1, 2, 5, 50);
+  CHECK_HISTORY (p, 3, 10, 100, 4);
+  CHECK_HISTORY (p2, 2, 3, 97);
+  p3 = p->CreateFragment (0, 5);
+  CHECK_HISTORY (p3, 1, 5);
+  p3->AddAtEnd (p1);
+  CHECK_HISTORY (p3, 2, 10, 50);
+  REM_HEADER (p3, 10);
+  CHECK_HISTORY (p3, 1, 50);
+  p2->RemoveAtStart (1);
+  p2->RemoveAtEnd (90);
+  CHECK_HISTORY (p2, 2, 2, 7);
+  ADD_TRAILER (p2, 2);
+  ADD_HEADER (p2, 3);
+  CHECK_HISTORY (p2, 4, 3, 2, 7, 2);
 }
 
 
@@ -922,3 +964,121 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
+
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Measure the throughput of packet operations with the metadata enabled.
+ */
+class PacketMetadataPerformanceTest : public TestCase {
+public:
+  PacketMetadataPerformanceTest ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Time a workload.
+   * \tparam F \deduced The workload type.
+   * \param [in] what The name of the workload.
+   * \param [in] workload The workload, run on one packet.
+   */
+  template <typename F>
+  void Measure (const std::string &what, F workload);
+};
+
+PacketMetadataPerformanceTest::PacketMetadataPerformanceTest ()
+  : TestCase ("Measure the throughput of packet operations with the metadata")
+{
+}
+
+template <typename F>
+void
+PacketMetadataPerformanceTest::Measure (const std::string &what, F workload)
+{
+  const uint32_t repetitions = 200000;
+  uint32_t sum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (uint32_t r = 0; r < repetitions; ++r)
+    {
+      sum += workload ();
+    }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now () - start;
+  std::cout << GetParent ()->GetName () << ": " << std::left << std::setw (24) << what
+            << std::right << std::setw (10) << std::fixed << std::setprecision (0)
+            << elapsed.count () / repetitions << " ns/packet  (" << sum % 10 << ")" << std::endl;
+}
+
+void
+PacketMetadataPerformanceTest::DoRun (void)
+{
+  PacketMetadata::Enable ();
+
+  // Down and up a stack of three layers, through a channel.
+  Measure ("push/pop", [] ()
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      ADD_HEADER (p, 20);
+      ADD_HEADER (p, 8);
+      ADD_HEADER (p, 14);
+      ADD_TRAILER (p, 4);
+      Ptr<Packet> received = p->Copy ();
+      REM_TRAILER (received, 4);
+      REM_HEADER (received, 14);
+      REM_HEADER (received, 8);
+      REM_HEADER (received, 20);
+      return received->GetSize ();
+    });
+  // Segments of a stream, as a TCP sender cuts them.
+  Measure ("segment", [] ()
+    {
+      Ptr<Packet> p = Create<Packet> (4000);
+      ADD_HEADER (p, 8);
+      uint32_t size = 0;
+      for (uint32_t offset = 0; offset < p->GetSize (); offset += 536)
+        {
+          Ptr<Packet> segment = p->CreateFragment (offset, std::min (536u, p->GetSize () - offset));
+          ADD_HEADER (segment, 20);
+          size += segment->GetSize ();
+        }
+      return size;
+    });
+  // Fragments of a datagram, with a header each, then reassembled.
+  Measure ("fragment/reassemble", [] ()
+    {
+      Ptr<Packet> p = Create<Packet> (1400);
+      ADD_HEADER (p, 8);
+      ADD_HEADER (p, 20);
+      Ptr<Packet> reassembled = Create<Packet> ();
+      for (uint32_t offset = 0; offset < p->GetSize (); offset += 500)
+        {
+          Ptr<Packet> fragment = p->CreateFragment (offset, std::min (500u, p->GetSize () - offset));
+          ADD_HEADER (fragment, 16);
+          REM_HEADER (fragment, 16);
+          reassembled->AddAtEnd (fragment);
+        }
+      REM_HEADER (reassembled, 20);
+      return reassembled->GetSize ();
+    });
+}
+
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet Metadata performance TestSuite
+ */
+class PacketMetadataPerformanceTestSuite : public TestSuite
+{
+public:
+  PacketMetadataPerformanceTestSuite ();
+};
+
+PacketMetadataPerformanceTestSuite::PacketMetadataPerformanceTestSuite ()
+  : TestSuite ("packet-metadata-perf", PERFORMANCE)
+{
+  AddTestCase (new PacketMetadataPerformanceTest, TestCase::QUICK);
+}
+
+static PacketMetadataPerformanceTestSuite g_packetMetadataPerformanceTest; //!< Static variable for test initialization
@@ -19,6 +19,7 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/crc32.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -647,6 +648,24 @@ PacketTest::DoRun (void)
 
   }
 
+  {
+    // Byte tags cut in a shared buffer, and in place.
+    Ptr<Packet> tmp = Create<Packet> (100);
+    tmp->AddByteTag (ATestTag<20> ());
+    tmp->RemoveAtStart (10);
+    tmp->RemoveAtEnd (10);
+    Ptr<Packet> copy = tmp->Copy ();
+    copy->AddByteTag (ATestTag<21> ());
+    copy->AddHeader (ATestHeader<10> ());
+    copy->AddTrailer (ATestTrailer<10> ());
+    CHECK (tmp, 1, E (20, 0, 80));
+    CHECK (copy, 2, E (20, 10, 90), E (21, 10, 90));
+    tmp->AddHeader (ATestHeader<10> ());
+    tmp->AddTrailer (ATestTrailer<10> ());
+    CHECK (tmp, 1, E (20, 10, 90));
+    CHECK (copy, 2, E (20, 10, 90), E (21, 10, 90));
+  }
+
   {
     Ptr<Packet> tmp = Create<Packet> (0);
     tmp->AddHeader (ATestHeader<156> ());
@@ -1096,6 +1115,60 @@ PacketTagListTest::DoRun (void)
 #   undef RemoveCheck
   }  // Removal
 
+  { // Copy-on-write
+    std::cout << GetName () << "check copy-on-write of shared lists"
+              << std::endl;
+    PacketTagList ptl = ref;
+    PacketTagList cpy = ref;
+    ATestTag<8> t8 (1);
+    ATestTag<9> t9 (1);
+    ptl.Add (t8);             // appended in place
+    cpy.Add (t9);             // copied
+    CheckRefList (ref, "add to copies, orig");
+    CheckRefList (ptl, "add to copies, first");
+    CheckRefList (cpy, "add to copies, second");
+    CheckRef (ptl, t8, "add to copies, first");
+    CheckRef (ptl, t9, "add to copies, first", true);
+    CheckRef (cpy, t9, "add to copies, second");
+    CheckRef (cpy, t8, "add to copies, second", true);
+    CheckRef (ref, t8, "add to copies, orig", true);
+
+    ptl = ref;
+    ptl.Remove (t4);          // copied
+    ptl.Remove (t1);          // in place
+    ptl.Remove (t7);          // most recent
+    t2.m_data = 3;
+    ptl.Replace (t2);         // in place
+    CheckRefList (ref, "remove and replace, orig");
+    const char * msg = "remove and replace, copy";
+    CheckRef (ptl, t1, msg, true);
+    CheckRef (ptl, t2, msg);
+    CheckRef (ptl, t3, msg);
+    CheckRef (ptl, t4, msg, true);
+    CheckRef (ptl, t5, msg);
+    CheckRef (ptl, t6, msg);
+    CheckRef (ptl, t7, msg, true);
+    t2.m_data = 1;
+
+    // Most recent tag first, as before
+    int expected[] = { 6, 5, 3, 2 };
+    int found = 0;
+    for (const PacketTagList::TagData *cur = ptl.Head (); cur != 0; cur = cur->next)
+      {
+        std::ostringstream oss;
+        oss << "anon::ATestTag<" << expected[found] << ">";
+        NS_TEST_EXPECT_MSG_EQ (cur->tid.GetName (), oss.str (), "wrong order");
+        ++found;
+      }
+    NS_TEST_EXPECT_MSG_EQ (found, 4, "wrong number of tags");
+    ptl.Remove (t6);
+    ptl.Remove (t5);
+    ptl.Remove (t3);
+    ptl.Remove (t2);
+    NS_TEST_EXPECT_MSG_EQ ((ptl.Head () == 0), true, "tags left");
+    CheckRefList (ref, "remove all, orig");
+  }
+
   { // Replace
 
     std::cout << GetName () << "check replacing each tag" << std::endl;
@@ -1158,6 +1231,63 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet zero-filled payload unit tests.
+ */
+class PacketVirtualPayloadTest : public TestCase
+{
+public:
+  PacketVirtualPayloadTest ();
+private:
+  void DoRun (void);
+};
+
+PacketVirtualPayloadTest::PacketVirtualPayloadTest ()
+  : TestCase ("Packet zero-filled payload")
+{
+}
+
+void
+PacketVirtualPayloadTest::DoRun (void)
+{
+  // Fragments of a zero-filled payload, with headers, reassembled.
+  Ptr<Packet> packet = Create<Packet> (4000);
+  Ptr<Packet> reassembled = Create<Packet> ();
+  for (uint32_t offset = 0; offset < 4000; offset += 1000)
+    {
+      Ptr<Packet> fragment = packet->CreateFragment (offset, 1000);
+      ATestHeader<10> header;
+      fragment->AddHeader (header);
+      fragment->RemoveHeader (header);
+      reassembled->AddAtEnd (fragment);
+    }
+  NS_TEST_EXPECT_MSG_EQ (reassembled->GetSize (), 4000, "Wrong reassembled size");
+  NS_TEST_EXPECT_MSG_LT (reassembled->GetSerializedSize (), 1000, "Payload should stay virtual");
+
+  // Aggregates of subframes: the largest payload stays virtual.
+  Ptr<Packet> aggregate = Create<Packet> ();
+  for (uint32_t size = 500; size <= 2000; size += 500)
+    {
+      Ptr<Packet> subframe = Create<Packet> (size);
+      subframe->AddHeader (ATestHeader<14> ());
+      aggregate->AddAtEnd (subframe);
+    }
+  NS_TEST_EXPECT_MSG_EQ (aggregate->GetSize (), 5056, "Wrong aggregate size");
+  NS_TEST_EXPECT_MSG_LT (aggregate->GetSerializedSize (), 4000, "Largest payload should stay virtual");
+
+  // The CRC-32 of the packet is calculated without copying it.
+  uint8_t *bytes = new uint8_t[aggregate->GetSize ()];
+  aggregate->CopyData (bytes, aggregate->GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (CRC32Calculate (aggregate), CRC32Calculate (bytes, aggregate->GetSize ()),
+                         "Wrong CRC-32");
+  delete [] bytes;
+  uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  NS_TEST_EXPECT_MSG_EQ (CRC32Calculate (Create<Packet> (check, 9)), 0xcbf43926, "Wrong CRC-32");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1175,6 +1305,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketVirtualPayloadTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/partition-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Base class of the PartitionHelper tests, to build topologies of
+ * SimpleChannels.
+ */
+class PartitionHelperTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] name The test name.
+   */
+  PartitionHelperTestCase (std::string name);
+
+protected:
+  /**
+   * Link two nodes with a point-to-point SimpleChannel.
+   * \param [in] a The first node.
+   * \param [in] b The second node.
+   * \param [in] delay The channel delay.
+   * \returns The channel.
+   */
+  Ptr<Channel> Link (Ptr<Node> a, Ptr<Node> b, Time delay);
+};
+
+PartitionHelperTestCase::PartitionHelperTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+Ptr<Channel>
+PartitionHelperTestCase::Link (Ptr<Node> a, Ptr<Node> b, Time delay)
+{
+  SimpleNetDeviceHelper helper;
+  helper.SetChannelAttribute ("Delay", TimeValue (delay));
+  NetDeviceContainer devices = helper.Install (NodeContainer (a, b));
+  return devices.Get (0)->GetChannel ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check two rings joined by a single link are split on that link,
+ * and the system ids are assigned.
+ */
+class PartitionHelperMinCutTestCase : public PartitionHelperTestCase
+{
+public:
+  PartitionHelperMinCutTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PartitionHelperMinCutTestCase::PartitionHelperMinCutTestCase ()
+  : PartitionHelperTestCase ("Check the partition of two rings")
+{
+}
+
+void
+PartitionHelperMinCutTestCase::DoRun (void)
+{
+  const uint32_t size = 8;
+  NodeContainer nodes;
+  nodes.Create (2 * size);
+  for (uint32_t ring = 0; ring < 2; ++ring)
+    {
+      for (uint32_t i = 0; i < size; ++i)
+        {
+          Link (nodes.Get (ring * size + i), nodes.Get (ring * size + (i + 1) % size), MilliSeconds (1));
+        }
+    }
+  Link (nodes.Get (size / 2), nodes.Get (size), MilliSeconds (2));
+
+  PartitionHelper helper;
+  Time lookahead = helper.AssignSystemIds (2);
+  const PartitionHelper::Report &report = helper.GetReport ();
+  NS_TEST_ASSERT_MSG_EQ (lookahead, MilliSeconds (2), "Wrong lookahead");
+  NS_TEST_ASSERT_MSG_EQ (report.nParts, 2, "Wrong number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (report.cutChannels, 1, "Only the link between the rings should be cut");
+  NS_TEST_ASSERT_MSG_EQ (report.imbalance, 1, "The rings should be balanced");
+  NS_TEST_ASSERT_MSG_EQ (report.bundles.size (), 1, "Wrong number of bundles");
+  NS_TEST_ASSERT_MSG_EQ (report.bundles.begin ()->second.delay, MilliSeconds (2), "Wrong bundle delay");
+  for (uint32_t i = 0; i < 2 * size; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (nodes.Get (i)->GetSystemId (), nodes.Get (i / size * size)->GetSystemId (),
+                             "Node " << i << " is not with its ring");
+    }
+  NS_TEST_ASSERT_MSG_NE (nodes.Get (0)->GetSystemId (), nodes.Get (size)->GetSystemId (),
+                         "The rings should be in different partitions");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the short links are not cut, to maximise the lookahead.
+ */
+class PartitionHelperLookaheadTestCase : public PartitionHelperTestCase
+{
+public:
+  PartitionHelperLookaheadTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PartitionHelperLookaheadTestCase::PartitionHelperLookaheadTestCase ()
+  : PartitionHelperTestCase ("Check the lookahead is maximised")
+{
+}
+
+void
+PartitionHelperLookaheadTestCase::DoRun (void)
+{
+  // A chain alternating short and long links.
+  NodeContainer nodes;
+  nodes.Create (8);
+  for (uint32_t i = 0; i + 1 < nodes.GetN (); ++i)
+    {
+      Link (nodes.Get (i), nodes.Get (i + 1), i % 2 == 0 ? MicroSeconds (10) : MilliSeconds (1));
+    }
+
+  PartitionHelper helper;
+  std::vector<uint32_t> partition;
+  Time lookahead = helper.Partition (4, partition);
+  NS_TEST_ASSERT_MSG_EQ (lookahead, MilliSeconds (1), "A short link was cut");
+  NS_TEST_ASSERT_MSG_EQ (partition.size (), 8, "Wrong partition size");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().nParts, 4, "Wrong number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().cutChannels, 3, "Wrong number of cut channels");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().imbalance, 1, "The partitions should be balanced");
+  for (uint32_t i = 0; i < 8; i += 2)
+    {
+      NS_TEST_ASSERT_MSG_EQ (partition[i], partition[i + 1], "Nodes " << i << " and " << i + 1 << " split");
+    }
+
+  // A broadcast channel cannot be split.
+  SimpleNetDeviceHelper broadcast;
+  broadcast.SetNetDevicePointToPointMode (false);
+  NodeContainer lan;
+  lan.Add (nodes.Get (1));
+  lan.Add (nodes.Get (2));
+  lan.Add (nodes.Get (5));
+  broadcast.Install (lan);
+  helper.Partition (4, partition);
+  NS_TEST_ASSERT_MSG_EQ (partition[1], partition[2], "Nodes of a broadcast channel split");
+  NS_TEST_ASSERT_MSG_EQ (partition[1], partition[5], "Nodes of a broadcast channel split");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the links with the least traffic are cut.
+ */
+class PartitionHelperTrafficTestCase : public PartitionHelperTestCase
+{
+public:
+  PartitionHelperTrafficTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PartitionHelperTrafficTestCase::PartitionHelperTrafficTestCase ()
+  : PartitionHelperTestCase ("Check the traffic between partitions is minimised")
+{
+}
+
+void
+PartitionHelperTrafficTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  PartitionHelper helper;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Ptr<Channel> channel = Link (nodes.Get (i), nodes.Get ((i + 1) % 4), MilliSeconds (1));
+      helper.SetChannelTraffic (channel, i % 2 == 1 ? 10 : 1);
+    }
+
+  std::vector<uint32_t> partition;
+  helper.Partition (2, partition);
+  NS_TEST_ASSERT_MSG_EQ (partition[1], partition[2], "A busy link was cut");
+  NS_TEST_ASSERT_MSG_EQ (partition[3], partition[0], "A busy link was cut");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().cutTraffic, 2, "Wrong traffic between partitions");
+
+  // A heavy node takes a partition of its own.
+  helper.SetNodeWeight (nodes.Get (0), 3);
+  helper.Partition (2, partition);
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().loads[partition[0]], 3, "Wrong load of the heavy node");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetReport ().imbalance, 1, "The partitions should be balanced");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PartitionHelper TestSuite
+ */
+class PartitionHelperTestSuite : public TestSuite
+{
+public:
+  PartitionHelperTestSuite ()
+    : TestSuite ("partition-helper", UNIT)
+  {
+    AddTestCase (new PartitionHelperMinCutTestCase (), TestCase::QUICK);
+    AddTestCase (new PartitionHelperLookaheadTestCase (), TestCase::QUICK);
+    AddTestCase (new PartitionHelperTrafficTestCase (), TestCase::QUICK);
+  }
+};
+
+static PartitionHelperTestSuite g_partitionHelperTestSuite; //!< Static variable for test initialization
@@ -21,10 +21,24 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <fstream>
+#include <vector>
+#include <algorithm>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/async-file-writer.h"
+#include "ns3/network-config.h"
+#include "ns3/packet.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -1144,6 +1158,211 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a pcap file written through an
+ * AsyncFileWriter, synchronous or asynchronous, compressed or not, has
+ * the same records as a file written through an iostream.
+ */
+class AsyncWriterTestCase : public TestCase
+{
+public:
+  AsyncWriterTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write packets of various sizes, some longer than the snapshot length.
+   * \param f The file, opened.
+   */
+  void WritePackets (PcapFile &f);
+};
+
+AsyncWriterTestCase::AsyncWriterTestCase ()
+  : TestCase ("Check that PcapFile writes the same records through an AsyncFileWriter")
+{
+}
+
+void
+AsyncWriterTestCase::WritePackets (PcapFile &f)
+{
+  f.Init (1, 200);
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      uint8_t data[300];
+      uint32_t size = 1 + (i * 37) % 300;
+      for (uint32_t j = 0; j < size; ++j)
+        {
+          data[j] = i + j;
+        }
+      f.Write (i / 1000, i % 1000, Create<Packet> (data, size));
+    }
+}
+
+void
+AsyncWriterTestCase::DoRun (void)
+{
+  std::string reference = CreateTempDirFilename ("reference.pcap");
+  PcapFile f;
+  f.Open (reference, std::ios::out);
+  WritePackets (f);
+  f.Close ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  for (uint32_t asynchronous = 0; asynchronous < 2; ++asynchronous)
+    {
+      // Small buffers, for the records to span several of them.
+      std::string filename = CreateTempDirFilename ("async.pcap");
+      Ptr<AsyncFileWriter> writer = Create<AsyncFileWriter> ();
+      writer->Open (filename, asynchronous, AsyncFileWriter::NONE, 4096);
+      PcapFile g;
+      g.Open (writer, false);
+      WritePackets (g);
+      NS_TEST_EXPECT_MSG_EQ (g.Fail (), false, "Write must not fail");
+      g.Close ();
+      writer->Close ();
+
+      packets = 0;
+      bool diff = PcapFile::Diff (reference, filename, sec, usec, packets);
+      NS_TEST_EXPECT_MSG_EQ (diff, false, "Files written with asynchronous=" << asynchronous << " differ");
+      NS_TEST_EXPECT_MSG_EQ (packets, 5000, "Wrong number of packets");
+      NS_TEST_EXPECT_MSG_EQ (CheckFileLength (filename, writer->GetSize ()), true, "Wrong file length");
+    }
+
+#ifdef HAVE_ZLIB
+  NS_TEST_ASSERT_MSG_EQ (AsyncFileWriter::IsSupported (AsyncFileWriter::GZIP), true, "gzip must be supported");
+  std::string compressed = CreateTempDirFilename ("async.pcap.gz");
+  Ptr<AsyncFileWriter> writer = Create<AsyncFileWriter> ();
+  writer->Open (compressed, true, AsyncFileWriter::GZIP, 4096);
+  PcapFile g;
+  g.Open (writer, false);
+  WritePackets (g);
+  g.Close ();
+  writer->Close ();
+
+  std::string uncompressed = CreateTempDirFilename ("gunzip.pcap");
+  gzFile in = gzopen (compressed.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (in, 0, "Cannot open " << compressed);
+  FILE *out = std::fopen (uncompressed.c_str (), "wb");
+  char buffer[4096];
+  int n;
+  while ((n = gzread (in, buffer, sizeof (buffer))) > 0)
+    {
+      std::fwrite (buffer, 1, n, out);
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 0, "gzip stream must be complete");
+  gzclose (in);
+  std::fclose (out);
+
+  packets = 0;
+  bool diff = PcapFile::Diff (reference, uncompressed, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Compressed file differs");
+  NS_TEST_EXPECT_MSG_EQ (packets, 5000, "Wrong number of packets");
+#endif
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that several PcapFileWrapper can write a
+ * single pcapng file, one interface each.
+ */
+class PcapngSingleFileTestCase : public TestCase
+{
+public:
+  PcapngSingleFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngSingleFileTestCase::PcapngSingleFileTestCase ()
+  : TestCase ("Check that PcapFileWrapper writes a single pcapng file")
+{
+}
+
+void
+PcapngSingleFileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("single.pcapng");
+  Ptr<PcapFileWrapper> wrapper[2];
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      wrapper[i] = CreateObject<PcapFileWrapper> ();
+      wrapper[i]->SetAttribute ("Format", EnumValue (PcapFileWrapper::PCAPNG));
+      wrapper[i]->SetAttribute ("SingleFile", StringValue (filename));
+      wrapper[i]->SetAttribute ("Asynchronous", BooleanValue (true));
+      wrapper[i]->SetAttribute ("NanosecMode", BooleanValue (i == 1));
+      wrapper[i]->Open (i == 0 ? "first" : "second-if", std::ios::out);
+      wrapper[i]->Init (1, 64);
+    }
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      wrapper[i % 2]->Write (MicroSeconds (i + 1), Create<Packet> (10 + 10 * i));
+    }
+  wrapper[0]->Close ();
+  wrapper[1]->Close ();
+
+  //
+  // Read the blocks back: a Section Header Block, the two Interface
+  // Description Blocks, then the Enhanced Packet Blocks.
+  //
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  NS_TEST_ASSERT_MSG_EQ (in.good (), true, "Cannot open " << filename);
+  std::vector<uint32_t> types;
+  uint32_t epb = 0;
+  while (true)
+    {
+      uint32_t header[2];
+      in.read ((char *)header, sizeof (header));
+      if (in.eof ())
+        {
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (header[1] % 4, 0, "Block length must be a multiple of 4");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (header[1], 12, "Block too short");
+      std::vector<uint8_t> body (header[1] - 8);
+      in.read ((char *)&body[0], body.size ());
+      NS_TEST_ASSERT_MSG_EQ (in.fail (), false, "Truncated block");
+      uint32_t trailer;
+      std::memcpy (&trailer, &body[body.size () - 4], 4);
+      NS_TEST_ASSERT_MSG_EQ (trailer, header[1], "Block lengths differ");
+      types.push_back (header[0]);
+
+      uint32_t fields[5];
+      std::memcpy (fields, &body[0], std::min<std::size_t> (sizeof (fields), body.size ()));
+      if (header[0] == 0x0a0d0d0a)
+        {
+          NS_TEST_EXPECT_MSG_EQ (fields[0], 0x1a2b3c4d, "Wrong byte order magic");
+        }
+      else if (header[0] == 1)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((fields[0] & 0xffff), 1, "Wrong link type");
+          NS_TEST_EXPECT_MSG_EQ (fields[1], 64, "Wrong snapshot length");
+          std::string name ((const char *)&body[12], (fields[2] >> 16));
+          NS_TEST_EXPECT_MSG_EQ (name, (types.size () == 2 ? "first" : "second-if"), "Wrong interface name");
+        }
+      else if (header[0] == 6)
+        {
+          uint32_t size = 10 + 10 * epb;
+          uint64_t ts = (uint64_t (fields[1]) << 32) | fields[2];
+          NS_TEST_EXPECT_MSG_EQ (fields[0], (epb % 2), "Wrong interface");
+          NS_TEST_EXPECT_MSG_EQ (ts, ((epb + 1) * (epb % 2 ? 1000 : 1)), "Wrong timestamp");
+          NS_TEST_EXPECT_MSG_EQ (fields[3], std::min<uint32_t> (size, 64), "Wrong captured length");
+          NS_TEST_EXPECT_MSG_EQ (fields[4], size, "Wrong original length");
+          epb++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (types.size (), 13, "Wrong number of blocks");
+  NS_TEST_EXPECT_MSG_EQ (types[0], 0x0a0d0d0a, "The file must start with a Section Header Block");
+  NS_TEST_EXPECT_MSG_EQ (types[1], 1, "Interface Description Block expected");
+  NS_TEST_EXPECT_MSG_EQ (types[2], 1, "Interface Description Block expected");
+  NS_TEST_EXPECT_MSG_EQ (epb, 10, "Wrong number of Enhanced Packet Blocks");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1386,8 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncWriterTestCase, TestCase::QUICK);
+  AddTestCase (new PcapngSingleFileTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,587 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#include "ns3/network-config.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::AsyncFileWriter implementation.
+ */
+
+//
+// This file is used as part of the ns-3 test framework, so please refrain from
+// adding any ns-3 specific constructs such as Packet to this file.
+//
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+#ifdef HAVE_PTHREAD_H
+
+/**
+ * \ingroup network
+ *
+ * The background thread writing the buffers of all the asynchronous
+ * AsyncFileWriter.
+ *
+ * The thread is started by the first asynchronous AsyncFileWriter,
+ * and is never stopped: it waits for work while no file is open.
+ */
+class AsyncFileWriterThread
+{
+public:
+  /** \returns The thread, started on the first call. */
+  static AsyncFileWriterThread *Get (void);
+
+  /**
+   * Queue a buffer to write to a file.
+   *
+   * This waits while too many bytes are queued already.
+   *
+   * \param writer The file.
+   * \param buffer The buffer, which belongs to the thread from now on.
+   * \param capacity The size of the buffer.
+   * \param size The bytes to write.
+   * \param finish Whether these are the last bytes of the file.
+   */
+  void Push (AsyncFileWriter *writer, uint8_t *buffer, uint32_t capacity,
+             uint32_t size, bool finish);
+  /**
+   * Wait until all the buffers of a file are written.
+   *
+   * \param writer The file.
+   */
+  void Wait (AsyncFileWriter *writer);
+  /**
+   * Get a free buffer.
+   *
+   * \param size The minimum size of the buffer.
+   * \param [out] capacity The size of the buffer.
+   * \returns The buffer.
+   */
+  uint8_t *Take (uint32_t size, uint32_t &capacity);
+
+private:
+  /** A buffer queued to the thread. */
+  struct Job
+  {
+    AsyncFileWriter *writer;    //!< The file
+    uint8_t *buffer;            //!< The buffer
+    uint32_t capacity;          //!< The size of the buffer
+    uint32_t size;              //!< The bytes to write
+    bool finish;                //!< Whether the file is finished
+  };
+  /** A free buffer. */
+  struct Free
+  {
+    uint8_t *buffer;            //!< The buffer
+    uint32_t capacity;          //!< The size of the buffer
+  };
+
+  AsyncFileWriterThread ();
+  /** Write the queued buffers, forever. */
+  void Run (void);
+  /**
+   * Write consecutive buffers of a file.
+   *
+   * \param jobs The buffers, all of the same file.
+   */
+  void WriteJobs (const std::vector<Job> &jobs);
+
+  /** The maximum number of bytes queued to the thread. */
+  static const uint64_t MAX_QUEUED = 64 << 20;
+  /** The maximum number of free buffers kept. */
+  static const std::size_t MAX_FREE = 16;
+
+  std::mutex m_mutex;                   //!< Protects the members below
+  std::condition_variable m_work;       //!< Signals the queued buffers
+  std::condition_variable m_done;       //!< Signals the written buffers
+  std::deque<Job> m_queue;              //!< The queued buffers
+  std::vector<Free> m_free;             //!< The free buffers
+  uint64_t m_queued;                    //!< The bytes queued
+  std::thread m_thread;                 //!< The thread
+};
+
+AsyncFileWriterThread *
+AsyncFileWriterThread::Get (void)
+{
+  // Never deleted: the thread may still be waiting for work when the
+  // static objects are destroyed.
+  static AsyncFileWriterThread *thread = new AsyncFileWriterThread ();
+  return thread;
+}
+
+AsyncFileWriterThread::AsyncFileWriterThread ()
+  : m_queued (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_thread = std::thread (&AsyncFileWriterThread::Run, this);
+  m_thread.detach ();
+}
+
+void
+AsyncFileWriterThread::Push (AsyncFileWriter *writer, uint8_t *buffer, uint32_t capacity,
+                             uint32_t size, bool finish)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_queued > 0 && m_queued + size > MAX_QUEUED)
+    {
+      m_done.wait (lock);
+    }
+  m_queue.push_back ({writer, buffer, capacity, size, finish});
+  m_queued += size;
+  writer->m_pending++;
+  m_work.notify_one ();
+}
+
+void
+AsyncFileWriterThread::Wait (AsyncFileWriter *writer)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (writer->m_pending > 0)
+    {
+      m_done.wait (lock);
+    }
+}
+
+uint8_t *
+AsyncFileWriterThread::Take (uint32_t size, uint32_t &capacity)
+{
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    for (std::vector<Free>::iterator i = m_free.begin (); i != m_free.end (); ++i)
+      {
+        if (i->capacity >= size)
+          {
+            uint8_t *buffer = i->buffer;
+            capacity = i->capacity;
+            *i = m_free.back ();
+            m_free.pop_back ();
+            return buffer;
+          }
+      }
+  }
+  capacity = size;
+  return new uint8_t[size];
+}
+
+void
+AsyncFileWriterThread::Run (void)
+{
+  std::vector<Job> jobs;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (m_queue.empty ())
+          {
+            m_work.wait (lock);
+          }
+        // Take the consecutive buffers of the first file, to write
+        // them at once.
+        AsyncFileWriter *writer = m_queue.front ().writer;
+        while (!m_queue.empty () && m_queue.front ().writer == writer
+               && jobs.size () < static_cast<std::size_t> (IOV_MAX))
+          {
+            jobs.push_back (m_queue.front ());
+            m_queue.pop_front ();
+          }
+      }
+      WriteJobs (jobs);
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        for (std::vector<Job>::const_iterator i = jobs.begin (); i != jobs.end (); ++i)
+          {
+            if (m_free.size () < MAX_FREE)
+              {
+                m_free.push_back ({i->buffer, i->capacity});
+              }
+            else
+              {
+                delete [] i->buffer;
+              }
+            m_queued -= i->size;
+          }
+        jobs.front ().writer->m_pending -= jobs.size ();
+        m_done.notify_all ();
+      }
+      jobs.clear ();
+    }
+}
+
+void
+AsyncFileWriterThread::WriteJobs (const std::vector<Job> &jobs)
+{
+  AsyncFileWriter *writer = jobs.front ().writer;
+  if (writer->m_zstream != 0)
+    {
+      for (std::vector<Job>::const_iterator i = jobs.begin (); i != jobs.end (); ++i)
+        {
+          writer->WriteOut (i->buffer, i->size, i->finish);
+        }
+      return;
+    }
+  std::vector<struct iovec> iov;
+  iov.reserve (jobs.size ());
+  for (std::vector<Job>::const_iterator i = jobs.begin (); i != jobs.end (); ++i)
+    {
+      if (i->size > 0)
+        {
+          iov.push_back ({i->buffer, i->size});
+        }
+    }
+  std::size_t first = 0;
+  while (first < iov.size () && !writer->m_failed)
+    {
+      ssize_t written = writev (writer->m_fd, &iov[first], iov.size () - first);
+      if (written < 0)
+        {
+          if (errno != EINTR)
+            {
+              writer->m_failed = true;
+            }
+          continue;
+        }
+      // Skip the buffers written, and resume a partial write.
+      std::size_t left = written;
+      while (first < iov.size () && left >= iov[first].iov_len)
+        {
+          left -= iov[first].iov_len;
+          first++;
+        }
+      if (left > 0)
+        {
+          iov[first].iov_base = static_cast<uint8_t *> (iov[first].iov_base) + left;
+          iov[first].iov_len -= left;
+        }
+    }
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+AsyncFileWriter::AsyncFileWriter ()
+  : m_fd (-1),
+    m_asynchronous (false),
+    m_failed (false),
+    m_zstream (0),
+    m_bufferSize (0),
+    m_buffer (0),
+    m_capacity (0),
+    m_used (0),
+    m_size (0),
+    m_users (0),
+    m_pending (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+AsyncFileWriter::IsSupported (Compression compression)
+{
+  NS_LOG_FUNCTION (compression);
+  switch (compression)
+    {
+    case NONE:
+      return true;
+    case GZIP:
+#ifdef HAVE_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    }
+  return false;
+}
+
+void
+AsyncFileWriter::Open (std::string const &filename, bool asynchronous,
+                       Compression compression, uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << filename << asynchronous << compression << bufferSize);
+  NS_ASSERT_MSG (IsSupported (compression), "AsyncFileWriter::Open(): compression not supported");
+  Close ();
+
+  m_failed = false;
+  m_size = 0;
+  m_users = 0;
+  m_fd = open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (m_fd < 0)
+    {
+      m_failed = true;
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  m_asynchronous = asynchronous;
+#else
+  m_asynchronous = false;
+#endif
+  m_bufferSize = std::max<uint32_t> (bufferSize, 4096);
+#ifdef HAVE_ZLIB
+  if (compression == GZIP)
+    {
+      m_zstream = new z_stream ();
+      // A window of 2^15 bytes, with a gzip header and trailer (+ 16).
+      if (deflateInit2 (m_zstream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8,
+                        Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          delete m_zstream;
+          m_zstream = 0;
+          m_failed = true;
+        }
+    }
+#endif
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      m_buffer = AsyncFileWriterThread::Get ()->Take (m_bufferSize, m_capacity);
+    }
+  else
+#endif
+    {
+      m_buffer = new uint8_t[m_bufferSize];
+      m_capacity = m_bufferSize;
+    }
+  m_used = 0;
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      AsyncFileWriterThread *thread = AsyncFileWriterThread::Get ();
+      thread->Push (this, m_buffer, m_capacity, m_used, true);
+      thread->Wait (this);
+    }
+  else
+#endif
+    {
+      WriteOut (m_buffer, m_used, true);
+      delete [] m_buffer;
+    }
+  m_buffer = 0;
+  m_capacity = 0;
+  m_used = 0;
+#ifdef HAVE_ZLIB
+  if (m_zstream != 0)
+    {
+      deflateEnd (m_zstream);
+      delete m_zstream;
+      m_zstream = 0;
+    }
+#endif
+  if (close (m_fd) != 0)
+    {
+      m_failed = true;
+    }
+  m_fd = -1;
+}
+
+void
+AsyncFileWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      AsyncFileWriterThread::Get ()->Wait (this);
+    }
+#endif
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+  return m_fd < 0 || m_failed;
+}
+
+void
+AsyncFileWriter::Write (const void *data, uint32_t size)
+{
+  NS_ASSERT (m_fd >= 0);
+  const uint8_t *bytes = static_cast<const uint8_t *> (data);
+  m_size += size;
+  while (size > 0)
+    {
+      if (m_used == m_capacity)
+        {
+          Submit ();
+        }
+      uint32_t n = std::min (size, m_capacity - m_used);
+      std::memcpy (m_buffer + m_used, bytes, n);
+      m_used += n;
+      bytes += n;
+      size -= n;
+    }
+}
+
+uint8_t *
+AsyncFileWriter::Reserve (uint32_t size)
+{
+  NS_ASSERT (m_fd >= 0);
+  if (size > m_capacity - m_used)
+    {
+      Submit ();
+      if (size > m_capacity)
+        {
+          // Larger than a buffer: get a larger one.
+#ifdef HAVE_PTHREAD_H
+          if (m_asynchronous)
+            {
+              AsyncFileWriterThread::Get ()->Push (this, m_buffer, m_capacity, 0, false);
+              m_buffer = AsyncFileWriterThread::Get ()->Take (size, m_capacity);
+            }
+          else
+#endif
+            {
+              delete [] m_buffer;
+              m_buffer = new uint8_t[size];
+              m_capacity = size;
+            }
+        }
+    }
+  uint8_t *start = m_buffer + m_used;
+  m_used += size;
+  m_size += size;
+  return start;
+}
+
+uint64_t
+AsyncFileWriter::GetSize (void) const
+{
+  return m_size;
+}
+
+uint32_t
+AsyncFileWriter::AddUser (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_users++;
+}
+
+void
+AsyncFileWriter::Submit (void)
+{
+  if (m_used == 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      AsyncFileWriterThread *thread = AsyncFileWriterThread::Get ();
+      thread->Push (this, m_buffer, m_capacity, m_used, false);
+      m_buffer = thread->Take (m_bufferSize, m_capacity);
+      m_used = 0;
+      return;
+    }
+#endif
+  WriteOut (m_buffer, m_used, false);
+  m_used = 0;
+}
+
+void
+AsyncFileWriter::WriteOut (const uint8_t *data, uint32_t size, bool finish)
+{
+#ifdef HAVE_ZLIB
+  if (m_zstream != 0)
+    {
+      uint8_t out[1 << 16];
+      m_zstream->next_in = const_cast<uint8_t *> (data);
+      m_zstream->avail_in = size;
+      int status;
+      do
+        {
+          m_zstream->next_out = out;
+          m_zstream->avail_out = sizeof (out);
+          status = deflate (m_zstream, finish ? Z_FINISH : Z_NO_FLUSH);
+          if (status == Z_STREAM_ERROR)
+            {
+              m_failed = true;
+              return;
+            }
+          WriteFd (out, sizeof (out) - m_zstream->avail_out);
+        }
+      while (m_zstream->avail_out == 0 || (finish && status != Z_STREAM_END));
+      return;
+    }
+#endif
+  WriteFd (data, size);
+}
+
+void
+AsyncFileWriter::WriteFd (const uint8_t *data, uint32_t size)
+{
+  while (size > 0 && !m_failed)
+    {
+      ssize_t written = write (m_fd, data, size);
+      if (written < 0)
+        {
+          if (errno != EINTR)
+            {
+              m_failed = true;
+            }
+          continue;
+        }
+      data += written;
+      size -= written;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <string>
+#include <stdint.h>
+#include <atomic>
+#include "ns3/simple-ref-count.h"
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::AsyncFileWriter declaration.
+ */
+
+struct z_stream_s;
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief A file written through large buffers, from a background thread.
+ *
+ * The bytes written are stored in buffers of a megabyte by default.
+ * A full buffer is queued to a background thread, shared by all the
+ * asynchronous AsyncFileWriter, which writes the consecutive buffers
+ * of a file with a single vectored write (\c writev), so that the
+ * simulation does not wait for the disk.  The background thread can
+ * also compress the file, in the gzip format.  A synchronous
+ * AsyncFileWriter writes (and compresses) its full buffers itself,
+ * which still saves most of the system calls.
+ *
+ * The bytes queued to the background thread are bounded: when it
+ * falls behind, the writers wait for it.
+ *
+ * Several users can share an AsyncFileWriter, e.g. the interfaces
+ * of a single pcapng file, but they must all be run by the same
+ * thread.
+ *
+ * This class is a plain C++ class, like PcapFile, so that it can be
+ * used by the test framework.
+ */
+class AsyncFileWriter : public SimpleRefCount<AsyncFileWriter>
+{
+public:
+  /** The compression of the file. */
+  enum Compression
+  {
+    NONE,  //!< Not compressed
+    GZIP   //!< Compressed with zlib, in the gzip format
+  };
+
+  AsyncFileWriter ();
+  /** Close the file. */
+  ~AsyncFileWriter ();
+
+  /**
+   * Check whether a compression is available in this build.
+   *
+   * \param compression The compression.
+   * \returns \c true if the files can be written with this compression.
+   */
+  static bool IsSupported (Compression compression);
+
+  /**
+   * Create the file, replacing any existing file with the same name.
+   *
+   * \param filename The name of the file.
+   * \param asynchronous Whether the buffers are written by the
+   *        background thread.
+   * \param compression The compression of the file.
+   * \param bufferSize The size of the buffers, in bytes.
+   */
+  void Open (std::string const &filename, bool asynchronous = true,
+             Compression compression = NONE, uint32_t bufferSize = 1 << 20);
+  /**
+   * Write the buffered bytes, wait until they are written, and
+   * close the file.
+   */
+  void Close (void);
+  /**
+   * Wait until all the bytes written so far are in the file.
+   *
+   * The file is only complete after Close(), if it is compressed.
+   */
+  void Flush (void);
+  /**
+   * \returns \c true if the file could not be created or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Write bytes to the file.
+   *
+   * \param data The bytes.
+   * \param size The number of bytes.
+   */
+  void Write (const void *data, uint32_t size);
+  /**
+   * Get room for bytes to write to the file.
+   *
+   * The bytes are written to the file if the caller fills them in
+   * before the next call to any other method.  This lets the packets
+   * be copied straight into the buffers.
+   *
+   * \param size The number of bytes.
+   * \returns The address of the bytes to fill in.
+   */
+  uint8_t *Reserve (uint32_t size);
+  /**
+   * \returns The number of bytes written so far, before compression.
+   */
+  uint64_t GetSize (void) const;
+  /**
+   * Get a number identifying a user of the file, e.g. the interface
+   * of a pcapng file.
+   *
+   * \returns 0 the first time, then 1, 2...
+   */
+  uint32_t AddUser (void);
+
+private:
+  friend class AsyncFileWriterThread;
+
+  /** Queue the current buffer, and start a new one. */
+  void Submit (void);
+  /**
+   * Write bytes to the file, compressing them if needed.
+   *
+   * This is called by the background thread for an asynchronous
+   * file, and by the writer otherwise.
+   *
+   * \param data The bytes.
+   * \param size The number of bytes.
+   * \param finish Whether these are the last bytes of the file.
+   */
+  void WriteOut (const uint8_t *data, uint32_t size, bool finish);
+  /**
+   * Write bytes to the file descriptor.
+   *
+   * \param data The bytes.
+   * \param size The number of bytes.
+   */
+  void WriteFd (const uint8_t *data, uint32_t size);
+
+  int m_fd;                         //!< The file descriptor, or -1
+  bool m_asynchronous;              //!< Whether the background thread writes the file
+  std::atomic<bool> m_failed;       //!< Whether a write failed
+  struct z_stream_s *m_zstream;     //!< The compression state, or 0
+  uint32_t m_bufferSize;            //!< The size of the buffers
+  uint8_t *m_buffer;                //!< The current buffer
+  uint32_t m_capacity;              //!< The size of the current buffer
+  uint32_t m_used;                  //!< The bytes used in the current buffer
+  uint64_t m_size;                  //!< The bytes written, before compression
+  uint32_t m_users;                 //!< The number of users
+  uint32_t m_pending;               //!< The buffers queued to the thread
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
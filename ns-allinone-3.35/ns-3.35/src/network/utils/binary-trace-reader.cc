@@ -0,0 +1,510 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-reader.h"
+#include "binary-trace-writer.h"
+#include "crc32.h"
+#include "ns3/packet-metadata.h"
+#include "ns3/buffer.h"
+#include "ns3/chunk.h"
+#include "ns3/type-id.h"
+#include "ns3/log.h"
+#include <cstring>
+#include <sstream>
+#include <map>
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::BinaryTraceReader implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceReader");
+
+namespace {
+
+/**
+ * \ingroup network
+ * A column of a numpy \c .npz file.
+ */
+struct NpyColumn
+{
+  std::string name;  //!< The name of the array
+  std::string descr; //!< The numpy type of the elements
+  uint32_t count;    //!< The number of elements
+  std::string data;  //!< The elements
+};
+
+/**
+ * Append an integer to a string, in little endian.
+ *
+ * \param s The string.
+ * \param v The integer.
+ * \param size The size of the integer, in bytes.
+ */
+void
+AppendLittleEndian (std::string &s, uint64_t v, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      s.push_back (static_cast<char> ((v >> (8 * i)) & 0xff));
+    }
+}
+
+/**
+ * Build a column of fixed-width strings.
+ *
+ * \param name The name of the array.
+ * \param strings The strings.
+ * \returns The column.
+ */
+NpyColumn
+MakeStringColumn (std::string const &name, std::vector<std::string> const &strings)
+{
+  std::size_t width = 1;
+  for (std::size_t i = 0; i < strings.size (); i++)
+    {
+      width = std::max (width, strings[i].size ());
+    }
+  NpyColumn column;
+  column.name = name;
+  std::ostringstream descr;
+  descr << "|S" << width;
+  column.descr = descr.str ();
+  column.count = strings.size ();
+  for (std::size_t i = 0; i < strings.size (); i++)
+    {
+      column.data += strings[i];
+      column.data.append (width - strings[i].size (), '\0');
+    }
+  return column;
+}
+
+/**
+ * Write the columns in a \c .npz file: an uncompressed zip archive of
+ * \c .npy files.
+ *
+ * \param filename The name of the file.
+ * \param columns The columns.
+ * \returns \c false on error.
+ */
+bool
+WriteNpz (std::string const &filename, std::vector<NpyColumn> const &columns)
+{
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary);
+  if (!os.is_open ())
+    {
+      return false;
+    }
+  uint64_t offset = 0;
+  std::string directory;
+  for (std::size_t i = 0; i < columns.size (); i++)
+    {
+      NpyColumn const &column = columns[i];
+      std::ostringstream dict;
+      dict << "{'descr': '" << column.descr << "', 'fortran_order': False, 'shape': ("
+           << column.count << ",), }";
+      std::string header = dict.str ();
+      // The data is aligned on 64 bytes, and the header ends with a newline.
+      header.append (63 - (10 + header.size ()) % 64, ' ');
+      header.push_back ('\n');
+      std::string npy ("\x93NUMPY\x01\x00", 8);
+      AppendLittleEndian (npy, header.size (), 2);
+      npy += header;
+      npy += column.data;
+      if (offset + npy.size () > 0xffffffff)
+        {
+          NS_LOG_WARN ("columns too large for a zip file without zip64");
+          return false;
+        }
+
+      std::string name = column.name + ".npy";
+      uint32_t crc = CRC32Calculate (reinterpret_cast<const uint8_t *> (npy.data ()), npy.size ());
+      std::string entry;
+      AppendLittleEndian (entry, 20, 2);           // version needed
+      AppendLittleEndian (entry, 0, 2);            // flags
+      AppendLittleEndian (entry, 0, 2);            // stored
+      AppendLittleEndian (entry, 0, 2);            // time
+      AppendLittleEndian (entry, 0x21, 2);         // date: 1980-01-01
+      AppendLittleEndian (entry, crc, 4);
+      AppendLittleEndian (entry, npy.size (), 4);  // compressed size
+      AppendLittleEndian (entry, npy.size (), 4);  // size
+      AppendLittleEndian (entry, name.size (), 2);
+      AppendLittleEndian (entry, 0, 2);            // extra field
+
+      std::string local;
+      AppendLittleEndian (local, 0x04034b50, 4);
+      local += entry + name;
+      os.write (local.data (), local.size ());
+      os.write (npy.data (), npy.size ());
+
+      AppendLittleEndian (directory, 0x02014b50, 4);
+      AppendLittleEndian (directory, 20, 2);       // version made by
+      directory += entry;
+      AppendLittleEndian (directory, 0, 2);        // comment
+      AppendLittleEndian (directory, 0, 2);        // disk
+      AppendLittleEndian (directory, 0, 2);        // internal attributes
+      AppendLittleEndian (directory, 0, 4);        // external attributes
+      AppendLittleEndian (directory, offset, 4);
+      directory += name;
+      offset += local.size () + npy.size ();
+    }
+  std::string end;
+  AppendLittleEndian (end, 0x06054b50, 4);
+  AppendLittleEndian (end, 0, 2);
+  AppendLittleEndian (end, 0, 2);
+  AppendLittleEndian (end, columns.size (), 2);
+  AppendLittleEndian (end, columns.size (), 2);
+  AppendLittleEndian (end, directory.size (), 4);
+  AppendLittleEndian (end, offset, 4);
+  AppendLittleEndian (end, 0, 2);
+  os.write (directory.data (), directory.size ());
+  os.write (end.data (), end.size ());
+  return os.good ();
+}
+
+} // anonymous namespace
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_fail (true),
+    m_resolution (Time::NS),
+    m_last (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  m_fail = !m_file.is_open ();
+  m_last = 0;
+  m_strings.assign (1, std::string ());
+  char magic[sizeof (BinaryTraceWriter::MAGIC)];
+  uint32_t header[2];
+  if (m_fail || !ReadBytes (magic, sizeof (magic)) || !ReadBytes (header, sizeof (header))
+      || std::memcmp (magic, BinaryTraceWriter::MAGIC, sizeof (magic)) != 0
+      || header[0] != BinaryTraceWriter::VERSION || header[1] >= Time::LAST)
+    {
+      NS_LOG_WARN ("not a binary trace: " << filename);
+      m_fail = true;
+      return false;
+    }
+  m_resolution = static_cast<enum Time::Unit> (header[1]);
+  return true;
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  return m_fail;
+}
+
+enum Time::Unit
+BinaryTraceReader::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+bool
+BinaryTraceReader::ReadBytes (void *data, uint32_t size)
+{
+  m_file.read (static_cast<char *> (data), size);
+  return static_cast<uint32_t> (m_file.gcount ()) == size;
+}
+
+bool
+BinaryTraceReader::Read (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fail)
+    {
+      return false;
+    }
+  uint8_t r[24];
+  while (ReadBytes (r, 4))
+    {
+      switch (r[0])
+        {
+        case 'T':
+          if (!ReadBytes (r + 4, 12))
+            {
+              m_fail = true;
+              return false;
+            }
+          std::memcpy (&m_last, r + 8, 8);
+          break;
+        case 'S':
+          {
+            uint32_t fields[2];
+            if (!ReadBytes (fields, sizeof (fields)) || fields[0] != m_strings.size ())
+              {
+                m_fail = true;
+                return false;
+              }
+            std::string s ((fields[1] + 3) & ~3, '\0');
+            if (!ReadBytes (&s[0], s.size ()))
+              {
+                m_fail = true;
+                return false;
+              }
+            s.resize (fields[1]);
+            m_strings.push_back (s);
+          }
+          break;
+        case 'L':
+          {
+            uint32_t size;
+            if (!ReadBytes (&size, 4))
+              {
+                m_fail = true;
+                return false;
+              }
+            record.kind = LINE;
+            record.line.assign ((size + 3) & ~3, '\0');
+            if (!ReadBytes (&record.line[0], record.line.size ()))
+              {
+                m_fail = true;
+                return false;
+              }
+            record.line.resize (size);
+            return true;
+          }
+        case '+':
+        case '-':
+        case 'd':
+        case 'r':
+          {
+            if (!ReadBytes (r + 4, 20))
+              {
+                m_fail = true;
+                return false;
+              }
+            uint16_t count;
+            uint32_t fields[3];
+            std::memcpy (&count, r + 2, 2);
+            std::memcpy (fields, r + 4, sizeof (fields));
+            std::memcpy (&record.uid, r + 16, 8);
+            m_last += fields[0];
+            record.kind = PACKET;
+            record.event = r[0];
+            record.time = m_last;
+            record.context = r[1] ? fields[1] : 0;
+            record.size = fields[2];
+            record.items.resize (count);
+            for (uint16_t i = 0; i < count; i++)
+              {
+                uint8_t h[16];
+                if (!ReadBytes (h, sizeof (h)))
+                  {
+                    m_fail = true;
+                    return false;
+                  }
+                Item &item = record.items[i];
+                item.type = h[0];
+                item.isFragment = h[1];
+                std::memcpy (&item.name, h + 4, 4);
+                std::memcpy (&item.start, h + 8, 4);
+                std::memcpy (&item.size, h + 12, 4);
+                bool whole = !item.isFragment && item.type != PacketMetadata::Item::PAYLOAD;
+                item.bytes.resize (whole ? (item.size + 3) & ~3 : 0);
+                if (whole && !ReadBytes (&item.bytes[0], item.bytes.size ()))
+                  {
+                    m_fail = true;
+                    return false;
+                  }
+                item.bytes.resize (whole ? item.size : 0);
+              }
+            return true;
+          }
+        default:
+          NS_LOG_WARN ("unknown record " << r[0]);
+          m_fail = true;
+          return false;
+        }
+    }
+  if (m_file.gcount () != 0)
+    {
+      m_fail = true;
+    }
+  return false;
+}
+
+std::string const &
+BinaryTraceReader::GetString (uint32_t id) const
+{
+  return id < m_strings.size () ? m_strings[id] : m_strings[0];
+}
+
+void
+BinaryTraceReader::PrintChunk (std::ostream &os, Item const &item) const
+{
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (GetString (item.name), &tid) || !tid.HasConstructor ())
+    {
+      // The module of this header is not linked: only its size is known.
+      os << "size=" << item.size;
+      return;
+    }
+  Callback<ObjectBase *> constructor = tid.GetConstructor ();
+  Chunk *chunk = dynamic_cast<Chunk *> (constructor ());
+  NS_ASSERT (chunk != 0);
+  Buffer buffer;
+  buffer.AddAtStart (item.size);
+  if (item.size > 0)
+    {
+      buffer.Begin ().Write (&item.bytes[0], item.size);
+    }
+  chunk->Deserialize (buffer.Begin (), buffer.End ());
+  chunk->Print (os);
+  delete chunk;
+}
+
+void
+BinaryTraceReader::PrintPacket (std::ostream &os, Record const &record) const
+{
+  for (std::size_t i = 0; i < record.items.size (); i++)
+    {
+      Item const &item = record.items[i];
+      std::string const &name = item.type == PacketMetadata::Item::PAYLOAD ?
+        std::string ("Payload") : GetString (item.name);
+      if (i > 0)
+        {
+          os << " ";
+        }
+      if (item.isFragment)
+        {
+          os << name << " Fragment [" << item.start << ":" << (item.start + item.size) << "]";
+        }
+      else if (item.type == PacketMetadata::Item::PAYLOAD)
+        {
+          os << "Payload (size=" << item.size << ")";
+        }
+      else
+        {
+          os << name << " (";
+          PrintChunk (os, item);
+          os << ")";
+        }
+    }
+}
+
+bool
+BinaryTraceReader::WriteText (std::ostream &os)
+{
+  NS_LOG_FUNCTION (this);
+  Record record;
+  while (Read (record))
+    {
+      if (record.kind == LINE)
+        {
+          os << record.line;
+          continue;
+        }
+      os << record.event << " " << TimeStep (record.time).GetSeconds () << " ";
+      if (record.context != 0)
+        {
+          os << GetString (record.context) << " ";
+        }
+      PrintPacket (os, record);
+      os << std::endl;
+    }
+  return !m_fail && os.good ();
+}
+
+bool
+BinaryTraceReader::WriteColumns (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NpyColumn time = {"time", "<f8", 0, ""};
+  NpyColumn event = {"event", "|S1", 0, ""};
+  NpyColumn context = {"context", "<i4", 0, ""};
+  NpyColumn uid = {"uid", "<u8", 0, ""};
+  NpyColumn size = {"size", "<u4", 0, ""};
+  NpyColumn headers = {"headers", "<i4", 0, ""};
+  std::map<uint32_t, uint32_t> contextIndex;
+  std::vector<std::string> contexts;
+  std::map<std::string, uint32_t> chainIndex;
+  std::vector<std::string> chains;
+
+  Record record;
+  uint32_t count = 0;
+  while (Read (record))
+    {
+      if (record.kind == LINE)
+        {
+          continue;
+        }
+      double seconds = TimeStep (record.time).GetSeconds ();
+      uint64_t bits;
+      std::memcpy (&bits, &seconds, 8);
+      AppendLittleEndian (time.data, bits, 8);
+      event.data.push_back (record.event);
+      int32_t c = -1;
+      if (record.context != 0)
+        {
+          std::map<uint32_t, uint32_t>::const_iterator i = contextIndex.find (record.context);
+          if (i == contextIndex.end ())
+            {
+              i = contextIndex.insert (std::make_pair (record.context, contexts.size ())).first;
+              contexts.push_back (GetString (record.context));
+            }
+          c = i->second;
+        }
+      AppendLittleEndian (context.data, static_cast<uint32_t> (c), 4);
+      AppendLittleEndian (uid.data, record.uid, 8);
+      AppendLittleEndian (size.data, record.size, 4);
+      std::string chain;
+      for (std::size_t i = 0; i < record.items.size (); i++)
+        {
+          Item const &item = record.items[i];
+          chain += (i > 0 ? " " : "");
+          chain += item.type == PacketMetadata::Item::PAYLOAD ? "Payload" : GetString (item.name);
+        }
+      std::map<std::string, uint32_t>::const_iterator j = chainIndex.find (chain);
+      if (j == chainIndex.end ())
+        {
+          j = chainIndex.insert (std::make_pair (chain, chains.size ())).first;
+          chains.push_back (chain);
+        }
+      AppendLittleEndian (headers.data, j->second, 4);
+      count++;
+    }
+  if (m_fail)
+    {
+      return false;
+    }
+
+  std::vector<NpyColumn> columns;
+  columns.push_back (time);
+  columns.push_back (event);
+  columns.push_back (context);
+  columns.push_back (uid);
+  columns.push_back (size);
+  columns.push_back (headers);
+  for (std::size_t i = 0; i < columns.size (); i++)
+    {
+      columns[i].count = count;
+    }
+  columns.push_back (MakeStringColumn ("contexts", contexts));
+  columns.push_back (MakeStringColumn ("header_chains", chains));
+  return WriteNpz (filename, columns);
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_READER_H
+#define BINARY_TRACE_READER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "ns3/nstime.h"
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::BinaryTraceReader declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Read a file written by a BinaryTraceWriter, and convert it to
+ * the text of the ascii traces, or to columns.
+ *
+ * The headers and trailers are printed by their own Print method, so
+ * the text is the same as the one of the default sinks of
+ * AsciiTraceHelper, provided that the reader is linked with the
+ * modules which define them, and that the Time resolution is the one
+ * of the file.
+ *
+ * The columns are written as a numpy \c .npz file, one array per
+ * column, which can be loaded by \c numpy.load or \c pandas.
+ */
+class BinaryTraceReader
+{
+public:
+  /** An item of the metadata of a packet. */
+  struct Item
+  {
+    uint8_t type;               //!< The PacketMetadata::Item::ItemType
+    bool isFragment;            //!< Whether the item is a fragment
+    uint32_t name;              //!< The string identifier of the TypeId name, 0 for the payload
+    uint32_t start;             //!< The bytes trimmed from the start of the item
+    uint32_t size;              //!< The size of the item
+    std::vector<uint8_t> bytes; //!< The bytes of a whole header or trailer
+  };
+
+  /** The kind of a record. */
+  enum Kind
+  {
+    PACKET, //!< A packet event
+    LINE    //!< A line of text
+  };
+
+  /** A record of the file. */
+  struct Record
+  {
+    enum Kind kind;           //!< The kind of record
+    char event;               //!< The event of a packet: '+', '-', 'd' or 'r'
+    int64_t time;             //!< The time of the event, in time steps
+    uint32_t context;         //!< The string identifier of the context, or 0
+    uint32_t size;            //!< The size of the packet
+    uint64_t uid;             //!< The uid of the packet
+    std::vector<Item> items;  //!< The metadata of the packet
+    std::string line;         //!< The text of a line, with its end of line
+  };
+
+  BinaryTraceReader ();
+
+  /**
+   * Open a file and read its header.
+   *
+   * \param filename The name of the file.
+   * \returns \c false if the file could not be opened or is not a
+   *          binary trace.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * \returns \c true if the file could not be opened or read.
+   */
+  bool Fail (void) const;
+  /**
+   * \returns The Time resolution of the time steps of the file.
+   */
+  enum Time::Unit GetResolution (void) const;
+  /**
+   * Read the next packet event or line.
+   *
+   * \param record The record read.
+   * \returns \c false at the end of the file, or on error.
+   */
+  bool Read (Record &record);
+  /**
+   * Get an interned string.
+   *
+   * \param id The identifier of the string.
+   * \returns The string, empty for unknown identifiers.
+   */
+  std::string const &GetString (uint32_t id) const;
+  /**
+   * Print a packet like Packet::Print.
+   *
+   * \param os The output stream.
+   * \param record The packet event.
+   */
+  void PrintPacket (std::ostream &os, Record const &record) const;
+  /**
+   * Convert the remaining records to the text of the ascii traces.
+   *
+   * \param os The output stream.
+   * \returns \c false on error.
+   */
+  bool WriteText (std::ostream &os);
+  /**
+   * Convert the remaining packet events to a numpy \c .npz file, with
+   * the columns \c time (seconds), \c event, \c context (index in
+   * \c contexts, -1 if none), \c uid, \c size and \c headers (index in
+   * \c header_chains, the names of the items of the packet separated by
+   * spaces).  The lines of text are skipped.
+   *
+   * \param filename The name of the file.
+   * \returns \c false on error.
+   */
+  bool WriteColumns (std::string const &filename);
+
+private:
+  /**
+   * Read bytes from the file.
+   *
+   * \param data The bytes read.
+   * \param size The number of bytes.
+   * \returns \c false at the end of the file.
+   */
+  bool ReadBytes (void *data, uint32_t size);
+  /**
+   * Print a whole header or trailer with its own Print method.
+   *
+   * \param os The output stream.
+   * \param item The item.
+   */
+  void PrintChunk (std::ostream &os, Item const &item) const;
+
+  std::ifstream m_file;               //!< The file
+  bool m_fail;                        //!< Whether an error happened
+  enum Time::Unit m_resolution;       //!< The resolution of the file
+  int64_t m_last;                     //!< The time of the last event, in steps
+  std::vector<std::string> m_strings; //!< The strings, by identifier
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_READER_H */
@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-writer.h"
+#include "async-file-writer.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include <cstring>
+#include <streambuf>
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::BinaryTraceWriter implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceWriter");
+
+const char BinaryTraceWriter::MAGIC[8] = {'n', 's', '3', 't', 'r', 'a', 'c', 'e'};
+
+/**
+ * \ingroup network
+ * A stream buffer which records each line written to it in a
+ * BinaryTraceWriter.
+ */
+class BinaryTraceWriter::LineBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor
+   * \param writer the file
+   */
+  LineBuffer (BinaryTraceWriter *writer)
+    : m_writer (writer)
+  {
+  }
+  /** Record the end of the last line, if it is not terminated. */
+  void Finish (void)
+  {
+    if (!m_line.empty ())
+      {
+        m_writer->WriteLine (m_line.data (), m_line.size ());
+        m_line.clear ();
+      }
+  }
+protected:
+  virtual std::streamsize xsputn (const char *s, std::streamsize n)
+  {
+    for (std::streamsize i = 0; i < n; i++)
+      {
+        Put (s[i]);
+      }
+    return n;
+  }
+  virtual int_type overflow (int_type c)
+  {
+    if (!traits_type::eq_int_type (c, traits_type::eof ()))
+      {
+        Put (traits_type::to_char_type (c));
+      }
+    return traits_type::not_eof (c);
+  }
+private:
+  /**
+   * Add a character to the line, and record the line at its end.
+   * \param c the character
+   */
+  void Put (char c)
+  {
+    m_line.push_back (c);
+    if (c == '\n')
+      {
+        m_writer->WriteLine (m_line.data (), m_line.size ());
+        m_line.clear ();
+      }
+  }
+
+  BinaryTraceWriter *m_writer; //!< the file
+  std::string m_line;          //!< the current line
+};
+
+BinaryTraceWriter::BinaryTraceWriter (std::string const &filename)
+  : m_last (0)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file = Create<AsyncFileWriter> ();
+  m_file->Open (filename, false);
+  NS_ABORT_MSG_IF (m_file->Fail (), "BinaryTraceWriter: Unable to open " << filename);
+  m_lineBuffer = new LineBuffer (this);
+  m_stream = new std::ostream (m_lineBuffer);
+
+  uint32_t header[2] = {VERSION, static_cast<uint32_t> (Time::GetResolution ())};
+  m_file->Write (MAGIC, sizeof (MAGIC));
+  m_file->Write (header, sizeof (header));
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  m_lineBuffer->Finish ();
+  delete m_stream;
+  delete m_lineBuffer;
+  m_file->Close ();
+}
+
+void
+BinaryTraceWriter::Write (char event, Time now, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << now << p);
+  DoWrite (event, now, 0, p);
+}
+
+void
+BinaryTraceWriter::Write (char event, Time now, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << now << context << p);
+  DoWrite (event, now, Intern (context), p);
+}
+
+std::ostream *
+BinaryTraceWriter::GetStream (void)
+{
+  return m_stream;
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file->Flush ();
+}
+
+bool
+BinaryTraceWriter::Fail (void) const
+{
+  return m_file->Fail ();
+}
+
+void
+BinaryTraceWriter::DoWrite (char event, Time now, uint32_t context, Ptr<const Packet> p)
+{
+  int64_t ts = now.GetTimeStep ();
+  int64_t delta = ts - m_last;
+  if (delta < 0 || delta > 0xffffffff)
+    {
+      // Too far from the previous event: record the time itself.
+      uint8_t record[16] = {'T'};
+      std::memcpy (record + 8, &ts, 8);
+      m_file->Write (record, sizeof (record));
+      delta = 0;
+    }
+  m_last = ts;
+
+  m_record.resize (24);
+  uint32_t items = 0;
+  PacketMetadata::ItemIterator i = p->BeginItem ();
+  while (i.HasNext ())
+    {
+      PacketMetadata::Item item = i.Next ();
+      bool whole = !item.isFragment && item.type != PacketMetadata::Item::PAYLOAD;
+      uint32_t bytes = whole ? item.currentSize : 0;
+      uint32_t fields[3] = {
+        item.type == PacketMetadata::Item::PAYLOAD ? 0 : Intern (item.tid),
+        item.currentTrimedFromStart,
+        item.currentSize
+      };
+      std::size_t offset = m_record.size ();
+      m_record.resize (offset + 16 + ((bytes + 3) & ~3), 0);
+      uint8_t *r = &m_record[offset];
+      r[0] = item.type;
+      r[1] = item.isFragment;
+      std::memcpy (r + 4, fields, sizeof (fields));
+      if (item.type == PacketMetadata::Item::HEADER && whole)
+        {
+          Buffer::Iterator start = item.current;
+          start.Read (r + 16, bytes);
+        }
+      else if (item.type == PacketMetadata::Item::TRAILER && whole)
+        {
+          Buffer::Iterator start = item.current;
+          start.Prev (bytes);
+          start.Read (r + 16, bytes);
+        }
+      items++;
+    }
+  NS_ASSERT_MSG (items <= 0xffff, "BinaryTraceWriter: too many headers");
+
+  uint8_t *r = &m_record[0];
+  r[0] = event;
+  r[1] = context != 0;
+  uint16_t count = items;
+  uint32_t fields[3] = {static_cast<uint32_t> (delta), context, p->GetSize ()};
+  uint64_t uid = p->GetUid ();
+  std::memcpy (r + 2, &count, 2);
+  std::memcpy (r + 4, fields, sizeof (fields));
+  std::memcpy (r + 16, &uid, 8);
+  m_file->Write (r, m_record.size ());
+}
+
+uint32_t
+BinaryTraceWriter::Intern (std::string const &s)
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator i = m_strings.find (s);
+  if (i != m_strings.end ())
+    {
+      return i->second;
+    }
+  uint32_t id = m_strings.size () + 1;
+  m_strings[s] = id;
+  uint32_t size = s.size ();
+  uint8_t header[12] = {'S'};
+  uint32_t padding = 0;
+  std::memcpy (header + 4, &id, 4);
+  std::memcpy (header + 8, &size, 4);
+  m_file->Write (header, sizeof (header));
+  m_file->Write (s.data (), s.size ());
+  m_file->Write (&padding, ((size + 3) & ~3) - size);
+  return id;
+}
+
+uint32_t
+BinaryTraceWriter::Intern (TypeId tid)
+{
+  uint16_t uid = tid.GetUid ();
+  if (uid >= m_typeIds.size ())
+    {
+      m_typeIds.resize (uid + 1, 0);
+    }
+  if (m_typeIds[uid] == 0)
+    {
+      m_typeIds[uid] = Intern (tid.GetName ());
+    }
+  return m_typeIds[uid];
+}
+
+void
+BinaryTraceWriter::WriteLine (const char *line, uint32_t size)
+{
+  uint8_t header[8] = {'L'};
+  uint32_t padding = 0;
+  std::memcpy (header + 4, &size, 4);
+  m_file->Write (header, sizeof (header));
+  m_file->Write (line, size);
+  m_file->Write (&padding, ((size + 3) & ~3) - size);
+}
+
+} // namespace ns3
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_WRITER_H
+#define BINARY_TRACE_WRITER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/type-id.h"
+
+/**
+ * \file
+ * \ingroup network
+ * ns3::BinaryTraceWriter declaration.
+ */
+
+namespace ns3 {
+
+class Packet;
+class AsyncFileWriter;
+
+/**
+ * \ingroup network
+ *
+ * \brief Write the events of the ascii traces in a compact binary format.
+ *
+ * The default sinks of AsciiTraceHelper print a line of text for each
+ * packet event, which formats every header of the packet.  A
+ * BinaryTraceWriter records the same information as fixed-width
+ * binary records instead: the time, as a delta from the previous
+ * event, the context and the TypeId names, as identifiers of strings
+ * written once, and the serialized bytes of the headers, which are
+ * only formatted when the file is converted back to text by a
+ * BinaryTraceReader, e.g. with the \c binary-trace-converter program.
+ *
+ * The text written to GetStream() is recorded as lines, and converted
+ * back unchanged, so that the BinaryTraceWriter can replace the file of
+ * an OutputStreamWrapper.
+ *
+ * The file is a header, followed by records aligned on 4 bytes:
+ *
+ * - the header: the magic \c "ns3trace", the version (32 bits), and the
+ *   Time::Unit of the time steps (32 bits);
+ * - a string: \c 'S', 3 bytes of padding, the identifier and the length
+ *   of the string (32 bits each), and the string;
+ * - a time: \c 'T', 7 bytes of padding, and the time (64 bits), in time
+ *   steps, which the next delta is relative to;
+ * - a line: \c 'L', 3 bytes of padding, the length (32 bits), and the
+ *   text;
+ * - a packet event: the event (\c '+', \c '-', \c 'd' or \c 'r'), 1 if
+ *   there is a context, the number of items (16 bits), the delta from
+ *   the time of the previous event, the string identifier of the
+ *   context, the packet size (32 bits each), and the packet uid (64
+ *   bits), then for each item of the packet metadata, its
+ *   PacketMetadata::Item::ItemType and whether it is a fragment (8 bits
+ *   each), 2 bytes of padding, the string identifier of its TypeId name,
+ *   the bytes trimmed from its start, and its size (32 bits each),
+ *   followed by its bytes if it is a whole header or trailer.
+ *
+ * All the fields are in the byte order of the writer, and the strings
+ * and bytes are padded to 4 bytes.
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /**
+   * Create the file.
+   *
+   * \param filename The name of the file.
+   */
+  BinaryTraceWriter (std::string const &filename);
+  ~BinaryTraceWriter ();
+
+  /**
+   * Record a packet event.
+   *
+   * \param event The event: \c '+', \c '-', \c 'd' or \c 'r'.
+   * \param now The time of the event.
+   * \param p The packet.
+   */
+  void Write (char event, Time now, Ptr<const Packet> p);
+  /**
+   * Record a packet event, with a context.
+   *
+   * \param event The event: \c '+', \c '-', \c 'd' or \c 'r'.
+   * \param now The time of the event.
+   * \param context The context of the event.
+   * \param p The packet.
+   */
+  void Write (char event, Time now, std::string const &context, Ptr<const Packet> p);
+  /**
+   * Get a stream whose text is recorded in the file, by line.
+   *
+   * \returns The stream.
+   */
+  std::ostream *GetStream (void);
+  /**
+   * Write the buffered records to the file.
+   */
+  void Flush (void);
+  /**
+   * \returns \c true if the file could not be created or written.
+   */
+  bool Fail (void) const;
+
+  /** The magic number at the start of the file. */
+  static const char MAGIC[8];
+  /** The version of the format. */
+  static const uint32_t VERSION = 1;
+
+private:
+  /** The stream buffer recording lines. */
+  class LineBuffer;
+
+  /**
+   * Record a packet event.
+   *
+   * \param event The event.
+   * \param now The time of the event.
+   * \param context The string identifier of the context, or 0.
+   * \param p The packet.
+   */
+  void DoWrite (char event, Time now, uint32_t context, Ptr<const Packet> p);
+  /**
+   * Get the identifier of a string, writing it the first time.
+   *
+   * \param s The string.
+   * \returns The identifier.
+   */
+  uint32_t Intern (std::string const &s);
+  /**
+   * Get the identifier of the name of a TypeId.
+   *
+   * \param tid The TypeId.
+   * \returns The identifier.
+   */
+  uint32_t Intern (TypeId tid);
+  /**
+   * Record a line of text.
+   *
+   * \param line The text.
+   * \param size The length of the text.
+   */
+  void WriteLine (const char *line, uint32_t size);
+
+  Ptr<AsyncFileWriter> m_file;                         //!< The file
+  std::unordered_map<std::string, uint32_t> m_strings; //!< The identifiers of the strings
+  std::vector<uint32_t> m_typeIds;                     //!< The identifiers of the TypeId names, by uid
+  int64_t m_last;                                      //!< The time of the last event, in steps
+  std::vector<uint8_t> m_record;                       //!< The record being written
+  LineBuffer *m_lineBuffer;                            //!< The buffer of GetStream()
+  std::ostream *m_stream;                              //!< The stream returned by GetStream()
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_WRITER_H */
@@ -25,7 +25,10 @@
  * COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or
  * code or tables extracted from it, as desired without restriction.
  */
-#include <stdint.h>
+#include "crc32.h"
+#include "ns3/packet.h"
+#include <ostream>
+#include <streambuf>
 
 namespace ns3 {
 
@@ -79,5 +82,55 @@ CRC32Calculate (const uint8_t *data, int length)
   return ~crc;
 }
 
+/**
+ * \ingroup network
+ * An output stream buffer which calculates the CRC-32 of the bytes
+ * written to it, and drops them.
+ */
+class Crc32StreamBuffer : public std::streambuf
+{
+public:
+  Crc32StreamBuffer ()
+    : m_crc (0xffffffff)
+  {
+  }
+  /**
+   * \returns the CRC-32 of the bytes written so far
+   */
+  uint32_t GetCrc (void) const
+  {
+    return ~m_crc;
+  }
+protected:
+  virtual std::streamsize xsputn (const char *s, std::streamsize n)
+  {
+    const uint8_t *data = reinterpret_cast<const uint8_t *> (s);
+    for (std::streamsize i = 0; i < n; i++)
+      {
+        m_crc = (m_crc >> 8) ^ crc32table[(m_crc & 0xFF) ^ data[i]];
+      }
+    return n;
+  }
+  virtual int_type overflow (int_type c)
+  {
+    if (!traits_type::eq_int_type (c, traits_type::eof ()))
+      {
+        m_crc = (m_crc >> 8) ^ crc32table[(m_crc & 0xFF) ^ static_cast<uint8_t> (c)];
+      }
+    return traits_type::not_eof (c);
+  }
+private:
+  uint32_t m_crc; //!< the CRC-32, before the final inversion
+};
+
+uint32_t
+CRC32Calculate (Ptr<const Packet> p)
+{
+  Crc32StreamBuffer buffer;
+  std::ostream os (&buffer);
+  p->CopyData (&os, p->GetSize ());
+  return buffer.GetCrc ();
+}
+
 } // namespace ns3
 
@@ -20,9 +20,12 @@
 #ifndef CRC32_H
 #define CRC32_H
 #include <stdint.h>
+#include "ns3/ptr.h"
 
 namespace ns3 {
 
+class Packet;
+
 /**
  * Calculates the CRC-32 for a given input
  *
@@ -33,6 +36,18 @@ namespace ns3 {
  */
 uint32_t CRC32Calculate (const uint8_t *data, int length);
 
+/**
+ * Calculates the CRC-32 of the bytes of a packet
+ *
+ * The bytes are not copied out of the packet: the zero-filled
+ * payload of the packet stays virtual.
+ *
+ * \param p the packet to calculate the checksum for
+ * \returns the computed crc-32.
+ *
+ */
+uint32_t CRC32Calculate (Ptr<const Packet> p);
+
 } // namespace ns3
 
 #endif
@@ -48,38 +48,24 @@ bool
 EthernetTrailer::CheckFcs (Ptr<const Packet> p) const
 {
   NS_LOG_FUNCTION (this << p);
-  int len = p->GetSize ();
-  uint8_t *buffer;
-  uint32_t crc;
-
   if (!m_calcFcs)
     {
       return true;
     }
 
-  buffer = new uint8_t[len];
-  p->CopyData (buffer, len);
-  crc = CRC32Calculate (buffer, len);
-  delete[] buffer;
-  return (m_fcs == crc);
+  return (m_fcs == CRC32Calculate (p));
 }
 
 void
 EthernetTrailer::CalcFcs (Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
-  int len = p->GetSize ();
-  uint8_t *buffer;
-
   if (!m_calcFcs)
     {
       return;
     }
 
-  buffer = new uint8_t[len];
-  p->CopyData (buffer, len);
-  m_fcs = CRC32Calculate (buffer, len);
-  delete[] buffer;
+  m_fcs = CRC32Calculate (p);
 }
 
 void
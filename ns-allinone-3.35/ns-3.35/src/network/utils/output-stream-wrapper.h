@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class BinaryTraceWriter;
+
 /**
  * @brief A class encapsulating an output stream.
  *
@@ -81,6 +83,15 @@ public:
    * \param os output stream
    */
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Constructor
+   *
+   * The stream records its text in the binary trace, and the default
+   * sinks of AsciiTraceHelper record their packet events in it.
+   *
+   * \param writer binary trace file
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceWriter> writer);
   ~OutputStreamWrapper ();
 
   /**
@@ -92,9 +103,16 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \returns the binary trace file of the wrapper, or 0 if it wraps
+   * a text stream
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTraceWriter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceWriter> m_binary; //!< The binary trace file, if any
 };
 
 } // namespace ns3
@@ -19,6 +19,9 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/abort.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -46,6 +49,38 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("Format",
+                   "The format of the files written.",
+                   EnumValue (PCAP),
+                   MakeEnumAccessor (&PcapFileWrapper::m_format),
+                   MakeEnumChecker (PCAP, "PCAP",
+                                    PCAPNG, "PCAPNG"))
+    .AddAttribute ("Compression",
+                   "The compression of the files written.  The name of the "
+                   "compressed files is suffixed with .gz.",
+                   EnumValue (AsyncFileWriter::NONE),
+                   MakeEnumAccessor (&PcapFileWrapper::m_compression),
+                   MakeEnumChecker (AsyncFileWriter::NONE, "NONE",
+                                    AsyncFileWriter::GZIP, "GZIP"))
+    .AddAttribute ("Asynchronous",
+                   "Whether the files are written (and compressed) by a "
+                   "background thread.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asynchronous),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BufferSize",
+                   "The size of the buffers of the files written by an "
+                   "AsyncFileWriter, in bytes.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (4096))
+    .AddAttribute ("SingleFile",
+                   "If not empty, the name of a pcapng file written instead "
+                   "of the files opened, each of which is an interface of "
+                   "this file.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapFileWrapper::m_singleFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -87,13 +122,54 @@ PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
   m_file.Close ();
+  if (m_writer && !m_singleFile.empty () && m_writer->GetReferenceCount () == 2)
+    {
+      // Only the registry and this wrapper use the file: close it.
+      GetSingleFiles ().erase (m_singleFile);
+    }
+  m_writer = 0;
+}
+
+std::map<std::string, Ptr<AsyncFileWriter> > &
+PcapFileWrapper::GetSingleFiles (void)
+{
+  static std::map<std::string, Ptr<AsyncFileWriter> > singleFiles;
+  return singleFiles;
 }
 
 void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
-  m_file.Open (filename, mode);
+  if ((mode & std::ios::out) == 0
+      || (m_format == PCAP && m_compression == AsyncFileWriter::NONE
+          && !m_asynchronous && m_singleFile.empty ()))
+    {
+      m_file.Open (filename, mode);
+      return;
+    }
+
+  NS_ABORT_MSG_UNLESS (AsyncFileWriter::IsSupported (m_compression),
+                       "PcapFileWrapper::Open(): compression not supported by this build");
+  NS_ABORT_MSG_IF (!m_singleFile.empty () && m_format != PCAPNG,
+                   "PcapFileWrapper::Open(): SingleFile requires the PCAPNG Format");
+  std::string suffix = m_compression == AsyncFileWriter::GZIP ? ".gz" : "";
+  if (m_singleFile.empty ())
+    {
+      m_writer = Create<AsyncFileWriter> ();
+      m_writer->Open (filename + suffix, m_asynchronous, m_compression, m_bufferSize);
+    }
+  else
+    {
+      Ptr<AsyncFileWriter> &writer = GetSingleFiles ()[m_singleFile];
+      if (!writer)
+        {
+          writer = Create<AsyncFileWriter> ();
+          writer->Open (m_singleFile + suffix, m_asynchronous, m_compression, m_bufferSize);
+        }
+      m_writer = writer;
+    }
+  m_file.Open (m_writer, m_format == PCAPNG, filename);
 }
 
 void
@@ -22,11 +22,13 @@
 #include <cstring>
 #include <limits>
 #include <fstream>
+#include <map>
 #include "ns3/ptr.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "async-file-writer.h"
 
 namespace ns3 {
 
@@ -35,10 +37,28 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * By default the file is written through an iostream.  The Attributes
+ * \c Format, \c Compression, \c Asynchronous and \c SingleFile select
+ * a faster backend, an AsyncFileWriter, for the files opened for writing:
+ * the records are gathered in buffers of \c BufferSize bytes, which are
+ * written by a background thread if \c Asynchronous is set, compressed
+ * with gzip if \c Compression is \c GZIP (the file name is then suffixed
+ * with \c .gz), and in the pcapng format if \c Format is \c PCAPNG.  With
+ * \c SingleFile, all the PcapFileWrapper write to a single pcapng file,
+ * in which each one is an interface named after the file name it was
+ * opened with.
  */
 class PcapFileWrapper : public Object
 {
 public:
+  /** The file format. */
+  enum Format
+  {
+    PCAP,   //!< The libpcap format
+    PCAPNG  //!< The pcapng format
+  };
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -221,9 +241,20 @@ public:
   uint32_t GetDataLinkType (void);
 
 private:
+  /**
+   * \returns The files shared by the wrappers, by \c SingleFile name.
+   */
+  static std::map<std::string, Ptr<AsyncFileWriter> > &GetSingleFiles (void);
+
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  enum Format m_format; //!< File format
+  enum AsyncFileWriter::Compression m_compression; //!< File compression
+  bool     m_asynchronous; //!< Whether a background thread writes the file
+  uint32_t m_bufferSize; //!< Size of the buffers of the AsyncFileWriter
+  std::string m_singleFile; //!< Name of the file shared by all the wrappers
+  Ptr<AsyncFileWriter> m_writer; //!< The AsyncFileWriter, if any
 };
 
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "async-file-writer.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -47,10 +48,18 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t PCAPNG_SHB = 0x0a0d0d0a;       /**< pcapng Section Header Block type */
+const uint32_t PCAPNG_IDB = 0x00000001;       /**< pcapng Interface Description Block type */
+const uint32_t PCAPNG_EPB = 0x00000006;       /**< pcapng Enhanced Packet Block type */
+const uint32_t PCAPNG_BOM = 0x1a2b3c4d;       /**< pcapng byte order magic */
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_writer (0),
+    m_pcapng (false),
+    m_interface (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,12 +77,20 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.fail ();
 }
 bool 
 PcapFile::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return false;
+    }
   return m_file.eof ();
 }
 void 
@@ -88,6 +105,15 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      //
+      // The writer may be shared by other interfaces of a pcapng file: it
+      // closes the file when the last of them releases it.
+      //
+      m_writer->Flush ();
+      m_writer = 0;
+    }
   m_file.close ();
 }
 
@@ -206,7 +232,10 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (!m_writer)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +263,116 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteBytes (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteBytes (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteBytes (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteBytes (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteBytes (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteBytes (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteBytes (&headerOut->m_type, sizeof(headerOut->m_type));
+}
+
+void
+PcapFile::WritePcapngHeader (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_interface = m_writer->AddUser ();
+
+  //
+  // The fields are written in the byte order of the system, or swapped, and
+  // the byte order magic of the Section Header Block tells which.
+  //
+  if (m_interface == 0)
+    {
+      uint32_t shb[7];
+      shb[0] = PCAPNG_SHB;
+      shb[1] = sizeof (shb);
+      shb[2] = PCAPNG_BOM;
+      shb[3] = 1;                // major version 1, minor version 0
+      shb[4] = 0xffffffff;       // section length: not specified
+      shb[5] = 0xffffffff;
+      shb[6] = sizeof (shb);
+      for (uint32_t i = 0; i < 7; i++)
+        {
+          shb[i] = m_swapMode ? Swap (shb[i]) : shb[i];
+        }
+      if (m_swapMode)
+        {
+          // The version is two 16-bit fields.
+          shb[3] = 0x00000100;
+        }
+      WriteBytes (shb, sizeof (shb));
+    }
+
+  //
+  // The Interface Description Block, with the if_name option (2), the
+  // if_tsresol option (9) in nanosecond mode, and opt_endofopt.
+  //
+  uint32_t nameLength = m_interfaceName.size ();
+  uint32_t namePadded = (nameLength + 3) & ~3;
+  uint32_t optionsLength = 4;
+  if (nameLength > 0)
+    {
+      optionsLength += 4 + namePadded;
+    }
+  if (m_nanosecMode)
+    {
+      optionsLength += 8;
+    }
+  uint32_t length = 16 + optionsLength + 4;
+  uint32_t idb[4];
+  idb[0] = PCAPNG_IDB;
+  idb[1] = length;
+  idb[2] = m_fileHeader.m_type & 0xffff;   // link type, and a reserved field
+  idb[3] = m_fileHeader.m_snapLen;
+  if (m_swapMode)
+    {
+      idb[0] = Swap (idb[0]);
+      idb[1] = Swap (idb[1]);
+      idb[2] = Swap (uint16_t (idb[2]));
+      idb[3] = Swap (idb[3]);
+    }
+  WriteBytes (idb, sizeof (idb));
+  if (nameLength > 0)
+    {
+      uint16_t option[2] = {2, uint16_t (nameLength)};
+      if (m_swapMode)
+        {
+          option[0] = Swap (option[0]);
+          option[1] = Swap (option[1]);
+        }
+      WriteBytes (option, sizeof (option));
+      WriteBytes (m_interfaceName.data (), nameLength);
+      uint32_t zero = 0;
+      WriteBytes (&zero, namePadded - nameLength);
+    }
+  if (m_nanosecMode)
+    {
+      uint16_t option[2] = {9, 1};
+      if (m_swapMode)
+        {
+          option[0] = Swap (option[0]);
+          option[1] = Swap (option[1]);
+        }
+      uint8_t resolution[4] = {9, 0, 0, 0};
+      WriteBytes (option, sizeof (option));
+      WriteBytes (resolution, sizeof (resolution));
+    }
+  uint32_t end[2] = {0, m_swapMode ? Swap (length) : length};
+  WriteBytes (end, sizeof (end));
+}
+
+void
+PcapFile::WriteBytes (const void *data, uint32_t size)
+{
+  if (m_writer)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write ((const char *)data, size);
+    }
 }
 
 void
@@ -341,6 +473,16 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::Open (Ptr<AsyncFileWriter> writer, bool pcapng, std::string const &interfaceName)
+{
+  NS_LOG_FUNCTION (this << writer << pcapng << interfaceName);
+  NS_ASSERT (!m_file.is_open () && !m_writer);
+  m_writer = writer;
+  m_pcapng = pcapng;
+  m_interfaceName = interfaceName;
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -396,17 +538,50 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   //
   m_swapMode = swapMode | bigEndian;
 
-  WriteFileHeader ();
+  if (m_pcapng)
+    {
+      WritePcapngHeader ();
+    }
+  else
+    {
+      WriteFileHeader ();
+    }
 }
 
 uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_writer ? !m_writer->Fail () : m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
+  if (m_pcapng)
+    {
+      //
+      // An Enhanced Packet Block, with a 64-bit timestamp in the resolution
+      // of the interface, and without options.
+      //
+      uint64_t ts = tsSec * (m_nanosecMode ? UINT64_C (1000000000) : UINT64_C (1000000)) + tsUsec;
+      uint32_t epb[7];
+      epb[0] = PCAPNG_EPB;
+      epb[1] = 32 + ((inclLen + 3) & ~3);
+      epb[2] = m_interface;
+      epb[3] = ts >> 32;
+      epb[4] = ts & 0xffffffff;
+      epb[5] = inclLen;
+      epb[6] = totalLen;
+      if (m_swapMode)
+        {
+          for (uint32_t i = 0; i < 7; i++)
+            {
+              epb[i] = Swap (epb[i]);
+            }
+        }
+      WriteBytes (epb, sizeof (epb));
+      return inclLen;
+    }
+
   PcapRecordHeader header;
   header.m_tsSec = tsSec;
   header.m_tsUsec = tsUsec;
@@ -418,6 +593,13 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
       Swap (&header, &header);
     }
 
+  if (m_writer)
+    {
+      uint32_t record[4] = {header.m_tsSec, header.m_tsUsec, header.m_inclLen, header.m_origLen};
+      m_writer->Write (record, sizeof (record));
+      return inclLen;
+    }
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -430,13 +612,26 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   return inclLen;
 }
 
+void
+PcapFile::WritePacketTrailer (uint32_t inclLen)
+{
+  if (m_pcapng)
+    {
+      uint32_t padding = ((inclLen + 3) & ~3) - inclLen;
+      uint32_t length = 32 + inclLen + padding;
+      uint32_t trailer[2] = {0, m_swapMode ? Swap (length) : length};
+      WriteBytes (reinterpret_cast<uint8_t *> (trailer) + 4 - padding, padding + 4);
+    }
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteBytes (data, inclLen);
+  WritePacketTrailer (inclLen);
+  NS_BUILD_DEBUG(if (!m_writer) m_file.flush());
 }
 
 void 
@@ -444,6 +639,14 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_writer)
+    {
+      // Only the bytes within the snapshot length are copied, straight
+      // into the buffer of the writer.
+      p->CopyData (m_writer->Reserve (inclLen), inclLen);
+      WritePacketTrailer (inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -460,6 +663,14 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_writer)
+    {
+      uint8_t *data = m_writer->Reserve (inclLen);
+      headerBuffer.CopyData (data, toCopy);
+      p->CopyData (data + toCopy, inclLen - toCopy);
+      WritePacketTrailer (inclLen);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
@@ -476,6 +687,7 @@ PcapFile::Read (
   uint32_t &readLen)
 {
   NS_LOG_FUNCTION (this << &data <<maxBytes << tsSec << tsUsec << inclLen << origLen << readLen);
+  NS_ASSERT (!m_writer);
   NS_ASSERT (m_file.good ());
 
   PcapRecordHeader header;
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class AsyncFileWriter;
 
 
 /**
@@ -50,7 +51,8 @@ public:
   ~PcapFile ();
 
   /**
-   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   * \return true if the 'fail' bit is set in the underlying iostream, or if
+   * the AsyncFileWriter failed, false otherwise.
    */
   bool Fail (void) const;
   /**
@@ -80,6 +82,27 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file, written through an AsyncFileWriter
+   * instead of an iostream.
+   *
+   * The AsyncFileWriter buffers the records, which are written to the
+   * disk (and compressed) by a background thread if it is
+   * asynchronous; see AsyncFileWriter.  The file can only be written.
+   *
+   * In the pcapng format, several PcapFile can share an AsyncFileWriter:
+   * each one adds an interface to the file, which is described by an
+   * Interface Description Block when Init() is called, and the packets
+   * are written as Enhanced Packet Blocks of the interface.  The first
+   * PcapFile initialized writes the Section Header Block.
+   *
+   * \param writer The file, which must be open.
+   * \param pcapng Whether the file is written in the pcapng format.
+   * \param interfaceName The name of the interface, in the pcapng format.
+   */
+  void Open (Ptr<AsyncFileWriter> writer, bool pcapng = false,
+             std::string const &interfaceName = "");
+
   /**
    * Close the underlying file.
    */
@@ -112,7 +135,8 @@ public:
    * system. Default to false.
    *
    * \warning Calling this method on an existing file will result in the loss
-   * any existing data.
+   * any existing data.  If the file is written through an AsyncFileWriter,
+   * this method must be called once, before any packet is written.
    */
   void Init (uint32_t dataLinkType, 
              uint32_t snapLen = SNAPLEN_DEFAULT, 
@@ -358,6 +382,25 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Write the end of a packet record
+   *
+   * This completes the Enhanced Packet Block of a pcapng file; there
+   * is nothing to write at the end of a pcap record.
+   *
+   * \param inclLen the length of the packet written
+   */
+  void WritePacketTrailer (uint32_t inclLen);
+  /**
+   * \brief Write the pcapng blocks describing the file and the interface
+   */
+  void WritePcapngHeader (void);
+  /**
+   * \brief Write bytes to the file
+   * \param data the bytes
+   * \param size the number of bytes
+   */
+  void WriteBytes (const void *data, uint32_t size);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -369,6 +412,10 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  Ptr<AsyncFileWriter> m_writer; //!< file writer, replacing the file stream
+  bool m_pcapng;                //!< pcapng format
+  uint32_t m_interface;         //!< pcapng interface identifier
+  std::string m_interfaceName;  //!< pcapng interface name
 };
 
 } // namespace ns3
@@ -1634,7 +1634,7 @@ WifiPhy::GetMaxPsduSize (WifiModulationClass modulation)
 }
 
 void
-WifiPhy::NotifyTxBegin (WifiConstPsduMap psdus, double txPowerW)
+WifiPhy::NotifyTxBegin (const WifiConstPsduMap& psdus, double txPowerW)
 {
   if (!m_phyTxBeginTrace.IsEmpty ())
     {
@@ -1712,8 +1712,8 @@ WifiPhy::NotifyRxDrop (Ptr<const WifiPsdu> psdu, WifiPhyRxfailureReason reason)
 }
 
 void
-WifiPhy::NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, WifiTxVector txVector,
-                               SignalNoiseDbm signalNoise, std::vector<bool> statusPerMpdu, uint16_t staId)
+WifiPhy::NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, const WifiTxVector& txVector,
+                               SignalNoiseDbm signalNoise, const std::vector<bool>& statusPerMpdu, uint16_t staId)
 {
   MpduInfo aMpdu;
   if (psdu->IsAggregate ())
@@ -1749,7 +1749,7 @@ WifiPhy::NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz
 }
 
 void
-WifiPhy::NotifyMonitorSniffTx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, WifiTxVector txVector, uint16_t staId)
+WifiPhy::NotifyMonitorSniffTx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, const WifiTxVector& txVector, uint16_t staId)
 {
   MpduInfo aMpdu;
   if (psdu->IsAggregate ())
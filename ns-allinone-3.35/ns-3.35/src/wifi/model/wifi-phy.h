@@ -548,7 +548,7 @@ public:
    * \param psdus the PSDUs being transmitted (only one unless DL MU transmission)
    * \param txPowerW the transmit power in Watts
    */
-  void NotifyTxBegin (WifiConstPsduMap psdus, double txPowerW);
+  void NotifyTxBegin (const WifiConstPsduMap& psdus, double txPowerW);
   /**
    * Public method used to fire a PhyTxEnd trace.
    * Implemented for encapsulation purposes.
@@ -609,9 +609,9 @@ public:
    */
   void NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu,
                              uint16_t channelFreqMhz,
-                             WifiTxVector txVector,
+                             const WifiTxVector& txVector,
                              SignalNoiseDbm signalNoise,
-                             std::vector<bool> statusPerMpdu,
+                             const std::vector<bool>& statusPerMpdu,
                              uint16_t staId = SU_STA_ID);
 
   /**
@@ -656,7 +656,7 @@ public:
    */
   void NotifyMonitorSniffTx (Ptr<const WifiPsdu> psdu,
                              uint16_t channelFreqMhz,
-                             WifiTxVector txVector,
+                             const WifiTxVector& txVector,
                              uint16_t staId = SU_STA_ID);
 
   /**
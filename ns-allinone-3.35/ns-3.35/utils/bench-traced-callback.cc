@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the cost of firing a
+// TracedCallback, with and without connected sinks, and the cost of
+// building the arguments of a trace with and without an IsEmpty() guard.
+// Sample usage:  ./waf --run 'bench-traced-callback --n=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traced-callback.h"
+#include "ns3/packet.h"
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// The number of times the sinks were called, so they are not optimized out.
+static uint64_t g_calls = 0;
+
+/**
+ * A trace sink.
+ * \param p the packet
+ */
+static void
+Sink (Ptr<const Packet> p)
+{
+  g_calls++;
+}
+
+/// The trace fired by the benchmarks.
+static TracedCallback<Ptr<const Packet> > g_trace;
+
+/**
+ * Fire the trace with a packet built beforehand.
+ * \param n the number of calls
+ */
+static void
+benchFire (uint32_t n)
+{
+  Ptr<const Packet> p = Create<Packet> (100);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_trace (p);
+    }
+}
+
+/**
+ * Fire the trace with a copy of a packet, as a device does.
+ * \param n the number of calls
+ */
+static void
+benchCopy (uint32_t n)
+{
+  Ptr<const Packet> p = Create<Packet> (100);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      g_trace (p->Copy ());
+    }
+}
+
+/**
+ * Fire the trace with a copy of a packet, only if a sink is connected.
+ * \param n the number of calls
+ */
+static void
+benchGuardedCopy (uint32_t n)
+{
+  Ptr<const Packet> p = Create<Packet> (100);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (!g_trace.IsEmpty ())
+        {
+          g_trace (p->Copy ());
+        }
+    }
+}
+
+/**
+ * Run a benchmark.
+ * \param bench the benchmark
+ * \param n the number of calls
+ * \param minIterations the number of runs to take the fastest of
+ * \param name the name of the benchmark
+ */
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      SystemWallClockMs time;
+      time.Start ();
+      (*bench) (n);
+      minDelay = std::min (minDelay, static_cast<uint64_t> (time.End ()));
+    }
+  double ns = minDelay;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << ns << " ns/call"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark TracedCallback class");
+  cmd.AddValue ("n", "number of calls", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of calls must be specified " <<
+        "by command-line argument --n=(number of calls)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-traced-callback with n=" << n << std::endl;
+
+  uint32_t sinks[] = {0, 1, 4};
+  for (uint32_t s = 0; s < 3; s++)
+    {
+      while (g_trace.IsEmpty () == false)
+        {
+          g_trace.DisconnectWithoutContext (MakeCallback (&Sink));
+        }
+      for (uint32_t i = 0; i < sinks[s]; i++)
+        {
+          g_trace.ConnectWithoutContext (MakeCallback (&Sink));
+        }
+      std::cout << sinks[s] << " sink(s):" << std::endl;
+      runBench (&benchFire, n, minIterations, "Fire");
+      runBench (&benchCopy, n, minIterations, "Fire a copy");
+      runBench (&benchGuardedCopy, n, minIterations, "Fire a copy if connected");
+    }
+  std::cout << g_calls << " sink calls" << std::endl;
+
+  return 0;
+}
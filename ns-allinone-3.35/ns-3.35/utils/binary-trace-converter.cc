@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary ascii traces, written when the
+// global value AsciiTraceFormat is "Binary", to the text of the ascii
+// traces, or to the columns of a numpy .npz file.
+// Sample usage:
+//   ./waf --run 'binary-trace-converter --input=trace.tr --output=trace.txt'
+//   ./waf --run 'binary-trace-converter --input=trace.tr --columns=trace.npz'
+
+#include "ns3/command-line.h"
+#include "ns3/nstime.h"
+#include "ns3/binary-trace-reader.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string columns;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Convert a binary ascii trace to text, or to columns");
+  cmd.AddValue ("input", "the binary trace file", input);
+  cmd.AddValue ("output", "the text file (standard output by default)", output);
+  cmd.AddValue ("columns", "the numpy .npz file of columns, instead of text", columns);
+  cmd.Parse (argc, argv);
+
+  BinaryTraceReader reader;
+  if (input.empty () || !reader.Open (input))
+    {
+      std::cerr << "Error-- cannot read the binary trace \"" << input << "\"" << std::endl;
+      return 1;
+    }
+  if (reader.GetResolution () != Time::GetResolution ())
+    {
+      Time::SetResolution (reader.GetResolution ());
+    }
+
+  bool ok;
+  if (!columns.empty ())
+    {
+      ok = reader.WriteColumns (columns);
+    }
+  else if (!output.empty ())
+    {
+      std::ofstream os (output.c_str ());
+      ok = reader.WriteText (os);
+    }
+  else
+    {
+      ok = reader.WriteText (std::cout);
+    }
+  if (!ok)
+    {
+      std::cerr << "Error-- conversion of \"" << input << "\" failed" << std::endl;
+      return 1;
+    }
+  return 0;
+}